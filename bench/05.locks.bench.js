@@ -0,0 +1,32 @@
+const b = require('benny')
+const gdal = require('..')
+
+// Stresses the ObjectStore: the lock of each Dataset and the lookups in the registries
+// (compare the results on two builds to measure a change in the locking mechanism)
+const datasets = 16
+const inFlight = 256
+const liveBands = 2048
+
+const ds = Array.from({ length: datasets }, () => gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte))
+
+// A large number of live objects in the ObjectStore
+const crowded = gdal.open('temp', 'w', 'MEM', 1, 1, liveBands, gdal.GDT_Byte)
+const bands = []
+for (let i = 1; i <= liveBands; i++) bands.push(crowded.bands.get(i))
+
+const pick = () => ds[Math.floor(Math.random() * datasets)]
+
+module.exports = b.suite(
+  'ObjectStore locks',
+
+  b.add(`_acquireLocksAsync, ${inFlight} in flight on ${datasets} Datasets`,
+    () => Promise.all(Array.from({ length: inFlight }, () => gdal._acquireLocksAsync(pick(), pick(), pick())))),
+  b.add(`_acquireLocksAsync, ${inFlight} in flight on a single Dataset`,
+    () => Promise.all(Array.from({ length: inFlight }, () => gdal._acquireLocksAsync(ds[0], ds[0], ds[0])))),
+  b.add(`RasterBand lookup with ${liveBands} live bands`, () => {
+    for (let i = 1; i <= liveBands; i++) crowded.bands.get(i)
+  }),
+
+  b.cycle(),
+  b.complete()
+)
@@ -13,6 +13,14 @@
 				"src/utils/string_list.cpp",
 				"src/utils/number_list.cpp",
 				"src/utils/warp_options.cpp",
+				"src/utils/calc_expr.cpp",
+				"src/utils/raster_summary.cpp",
+				"src/utils/helper_threads.cpp",
+				"src/utils/metrics.cpp",
+				"src/utils/proj_cache.cpp",
+				"src/utils/strtree.cpp",
+				"src/utils/geometry_list.cpp",
+				"src/utils/diagnostics.cpp",
 				"src/utils/ptr_manager.cpp",
 				"src/node_gdal.cpp",
 				"src/async.cpp",
@@ -41,8 +49,10 @@
 				"src/geometry/gdal_multilinestring.cpp",
 				"src/geometry/gdal_multicurve.cpp",
 				"src/geometry/gdal_multipolygon.cpp",
+				"src/geometry/gdal_prepared_geometry.cpp",
 				"src/gdal_layer.cpp",
 				"src/gdal_coordinate_transformation.cpp",
+				"src/gdal_spatial_index.cpp",
 				"src/gdal_spatial_reference.cpp",
 				"src/gdal_warper.cpp",
 				"src/gdal_algorithms.cpp",
@@ -0,0 +1,74 @@
+/**
+ * @typedef {object} AbortOptions
+ * @property {AbortSignal} [signal]
+ */
+
+// AbortSignal support for the *Async methods
+//
+// The signal is translated to an Int32Array flag that is given to the native
+// code after the callback, the native scheduler drops the job if it is still
+// waiting for its Datasets and the progress callback makes GDAL stop if it is running
+module.exports = (gdal) => {
+  const isSignal = (s) => typeof AbortSignal !== 'undefined' && s instanceof AbortSignal
+
+  const abortError = () => {
+    const err = new Error('Operation aborted')
+    err.code = gdal.CPLE_UserInterrupt
+    return err
+  }
+
+  // Removes the signal from the arguments, it can be given either
+  // directly or as the signal property of a plain options object
+  const extractSignal = (args) => {
+    for (let i = 0; i < args.length; i++) {
+      const arg = args[i]
+      if (isSignal(arg)) {
+        args[i] = undefined
+        return arg
+      }
+      if (arg && typeof arg === 'object' && Object.getPrototypeOf(arg) === Object.prototype &&
+          isSignal(arg.signal)) {
+        const { signal, ...rest } = arg
+        args[i] = rest
+        return signal
+      }
+    }
+    return undefined
+  }
+
+  // Calls a native *Async method with its callback at cbArg, returns
+  // a Promise when there is no callback
+  const callAbortable = (fn, self, args, cbArg, signal, callback) => {
+    const run = (cb) => {
+      if (!signal) {
+        args[cbArg] = cb
+        return fn.apply(self, args)
+      }
+      if (signal.aborted) {
+        process.nextTick(cb, abortError())
+        return
+      }
+      const flag = new Int32Array(1)
+      const onAbort = () => {
+        flag[0] = 1
+        gdal._wakeScheduler()
+      }
+      signal.addEventListener('abort', onAbort)
+      args[cbArg] = (err, result) => {
+        signal.removeEventListener('abort', onAbort)
+        cb(err, result)
+      }
+      args[cbArg + 1] = flag
+      try {
+        return fn.apply(self, args)
+      } catch (e) {
+        signal.removeEventListener('abort', onAbort)
+        throw e
+      }
+    }
+    if (callback) return run(callback)
+    return new Promise((resolve, reject) => run((err, result) => err ? reject(err) : resolve(result)))
+  }
+
+  return { isSignal, abortError, extractSignal, callAbortable }
+}
@@ -0,0 +1,109 @@
+const debug = process.env.NODE_DEBUG && process.env.NODE_DEBUG.match(/gdal_pool|gdal([^_]|$)/) ?
+  console.debug.bind(console, 'RasterBufferPool:') :
+  () => undefined
+
+/**
+ * @interface RasterBufferPoolOptions
+ * @property {number} [maxFree]
+ */
+
+/**
+ * A pool of reusable `ArrayBuffer`s for the raster streams
+ *
+ * When the same pool is given to all the streams of a pipeline, the buffers
+ * are returned to the pool by the last stream that uses them and they are
+ * reused for the following chunks - once the pipeline has reached its
+ * steady state, it does not allocate memory anymore
+ *
+ * Only the buffers allocated by the pool are returned to it, a buffer
+ * must not be used anymore once it has been released
+ *
+ * {@link calcAsync} always uses a pool
+ *
+ * @example
+ *
+ *  const pool = new gdal.RasterBufferPool()
+ *  const mux = new gdal.RasterMuxStream({
+ *    T2m: dsT2m.bands.get(1).pixels.createReadStream({ pool }),
+ *    D2m: dsD2m.bands.get(1).pixels.createReadStream({ pool })
+ *  }, { pool })
+ *  const xform = new gdal.RasterTransform({ type: Float64Array, fn, pool })
+ *  const ws = dsCloudBase.bands.get(1).pixels.createWriteStream({ pool })
+ *  mux.pipe(xform).pipe(ws)
+ *
+ * @class RasterBufferPool
+ * @constructor
+ * @param {RasterBufferPoolOptions} [options]
+ * @param {number} [options.maxFree=64] Maximum number of free buffers of each size kept in the pool
+ */
+class RasterBufferPool {
+  constructor(options) {
+    this.maxFree = (options || {}).maxFree === undefined ? 64 : +options.maxFree
+    if (!(this.maxFree >= 0)) {
+      throw new RangeError('"maxFree" must be a positive number')
+    }
+    // free buffers by size in bytes
+    this.free = new Map()
+    this.owned = new WeakSet()
+    this.freed = new WeakSet()
+    /**
+     * Number of buffers allocated by the pool
+     * @type {number}
+     */
+    this.allocated = 0
+    /**
+     * Number of buffers reused from the pool
+     * @type {number}
+     */
+    this.reused = 0
+  }
+
+  /**
+   * Get a `TypedArray` of the given type and length, backed by a pooled buffer
+   *
+   * @method acquire
+   * @param {new (len: number) => TypedArray} type Typed array constructor
+   * @param {number} length Number of elements
+   * @returns {TypedArray}
+   */
+  acquire(type, length) {
+    const size = length * type.BYTES_PER_ELEMENT
+    const list = this.free.get(size)
+    if (list && list.length > 0) {
+      const buffer = list.pop()
+      this.freed.delete(buffer)
+      this.reused++
+      return new type(buffer, 0, length)
+    }
+    debug('allocating', size)
+    const buffer = new ArrayBuffer(size)
+    this.owned.add(buffer)
+    this.allocated++
+    return new type(buffer, 0, length)
+  }
+
+  /**
+   * Return the buffer of a `TypedArray` (or of a view of it) to the pool,
+   * arrays that were not allocated by the pool are ignored
+   *
+   * @method release
+   * @param {TypedArray} array
+   * @returns {void}
+   */
+  release(array) {
+    const buffer = array && array.buffer
+    if (!buffer || !this.owned.has(buffer) || this.freed.has(buffer)) return
+    let list = this.free.get(buffer.byteLength)
+    if (!list) {
+      list = []
+      this.free.set(buffer.byteLength, list)
+    }
+    if (list.length >= this.maxFree) return
+    list.push(buffer)
+    this.freed.add(buffer)
+  }
+}
+
+module.exports = {
+  RasterBufferPool
+}
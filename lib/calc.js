@@ -4,6 +4,7 @@
  * @property {boolean} [convertNoData]
  * @property {boolean} [convertInput]
  * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
  */
 
 /**
@@ -14,14 +15,19 @@
  * It is fully async and reading and decoding of input and output bands happen
  * in separate background threads for each band as long as they are in separate datasets.
  *
- * The main bottleneck is the passed function `fn` which must always run on the main Node.js/V8 thread.
+ * When `fn` is a JS function, the main bottleneck is `fn` itself which must always run on the main Node.js/V8 thread.
  * This is a fundamental Node.js/V8 limitation that is impossible to overcome.
- *
- * This function is not to be used in server code that must remain responsive at all times.
+ * In this case this function is not to be used in server code that must remain responsive at all times.
  * It does not directly block the event loop, but it is very CPU-heavy and cannot
  * run parallel to other instances of itself. If multiple instances run in parallel, they
  * will all compete for the main thread, executing `fn` on the incoming data chunks on turn by turn basis.
  *
+ * When `fn` is a string, it is an arithmetic expression that is compiled and evaluated by a native engine
+ * in a background thread, the main thread performs only O(1) operations. The expression can use the names
+ * of the input bands, numbers, `+ - * / **`, `< <= > >= == != && || !`, `c ? a : b` and the functions
+ * `abs`, `sqrt`, `exp`, `log`, `floor`, `ceil`, `min`, `max` and `pow`. Comparisons evaluate to `1` or `0`.
+ * All computations are done in `Float64`, `convertInput` has no effect.
+ *
  * It internally uses a {@link RasterTransform} which can also be used directly for
  * a finer-grained control over the transformation.
  *
@@ -33,11 +39,12 @@
  * @function calcAsync
  * @param {Record<string, RasterBand>} inputs An object containing all the input bands
  * @param {RasterBand} output Output raster band
- * @param {(...args: number[]) => number} fn Function to apply on all pixels, it must have the same number of arguments as there are input bands
+ * @param {((...args: number[]) => number)|string} fn Function to apply on all pixels, it must have the same number of arguments as there are input bands, or an expression using the names of the input bands
  * @param {CalcOptions} [options] Options
  * @param {boolean} [options.convertNoData=false] Input bands will have their NoData pixels converted to NaN and a NaN output value of the given function will be converted to a NoData pixel, provided that the output raster band has its `RasterBand.noDataValue` set
  * @param {boolean} [options.convertInput=false] Input bands will have their pixels converted to the output data type before calling the user-supplied function, can be used to allow integer data types to get their NoData converted to `NaN`
  * @param {ProgressCb} [options.progress_cb=undefined] Progress callback
+ * @param {AbortSignal} [options.signal=undefined] Abort the computation, the returned Promise is rejected with a `CPLE_UserInterrupt` error
  * @return {Promise<void>}
  * @static
  *
@@ -57,75 +64,125 @@
  *  t: await T2m.bands.getAsync(1),
  *  td: await D2m.bands.getAsync(1)
  * }, cloudBase.bands.getAsync(1), espyFn, { convertNoData: true });
+ *
+ * @example
+ *
+ * // The same computation with a native expression
+ * await calcAsync({
+ *  t: await T2m.bands.getAsync(1),
+ *  td: await D2m.bands.getAsync(1)
+ * }, cloudBase.bands.getAsync(1), '125 * (t - td)', { convertNoData: true });
  */
 
-const calc = (gdal) => function calcAsync(inputs, output, fn, options) {
-  const convertNoData = (options || {}).convertNoData
-  const convertInput = (options || {}).convertInput
-  const progress = (options || {}).progress_cb
+const calc = (gdal) => {
+  const abortable = require('./abort.js')(gdal)
 
-  for (const inp of Object.keys(inputs)) {
-    if (!(inputs[inp] instanceof gdal.RasterBand)) {
-      return Promise.reject(new TypeError('All inputs must be instances of gdal.RasterBand'))
-    }
-  }
-  if (!(output instanceof gdal.RasterBand)) {
-    return Promise.reject(new TypeError('output must be an instance of gdal.RasterBand'))
-  }
-  if (typeof fn !== 'function') return Promise.reject(new TypeError('fn must be a function'))
+  return function calcAsync(inputs, output, fn, options) {
+    const convertNoData = (options || {}).convertNoData
+    const convertInput = (options || {}).convertInput
+    const progress = (options || {}).progress_cb
+    const signal = (options || {}).signal
 
-  if (progress !== undefined && typeof progress !== 'function') {
-    return Promise.reject(new TypeError('progress_cb must be a function'))
-  }
+    for (const inp of Object.keys(inputs)) {
+      if (!(inputs[inp] instanceof gdal.RasterBand)) {
+        return Promise.reject(new TypeError('All inputs must be instances of gdal.RasterBand'))
+      }
+    }
+    if (!(output instanceof gdal.RasterBand)) {
+      return Promise.reject(new TypeError('output must be an instance of gdal.RasterBand'))
+    }
+    if (typeof fn !== 'function' && typeof fn !== 'string') {
+      return Promise.reject(new TypeError('fn must be a function or an expression'))
+    }
 
-  const inSizesQ = Object.keys(inputs).map((inp) => inputs[inp].sizeAsync)
-  const outSizeQ = output.sizeAsync
-  const outTypeQ = output.dataTypeAsync
+    if (progress !== undefined && typeof progress !== 'function') {
+      return Promise.reject(new TypeError('progress_cb must be a function'))
+    }
+    if (signal !== undefined && !abortable.isSignal(signal)) {
+      return Promise.reject(new TypeError('signal must be an AbortSignal'))
+    }
+    if (signal && signal.aborted) {
+      return Promise.reject(abortable.abortError())
+    }
 
-  return Promise.all([ outTypeQ, outSizeQ,...inSizesQ ]).then((values) => {
-    const outType = values[0]
-    for (let i = 2; i < values.length; i++) {
-      if (values[1].x != values[i].x || values[1].y != values[i].y) {
-        throw new RangeError('All raster bands dimensions must match')
+    if (typeof fn === 'string') {
+      const calcOptions = { convertNoData: !!convertNoData }
+      if (progress) calcOptions.progress_cb = progress
+      if (signal) calcOptions.signal = signal
+      try {
+        return gdal._calcAsync(inputs, output, fn, calcOptions)
+      } catch (e) {
+        return Promise.reject(e)
       }
     }
-    const length = values[1].x * values[1].y
-
-    const type = convertInput ? gdal.fromDataType(outType) : undefined
-    const streams = Object.keys(inputs)
-      .map((inp) => ({ id: inp, stream: inputs[inp].pixels.createReadStream({ convertNoData, type }) }))
-      .reduce((obj, stream) => {
-        obj[stream.id] = stream.stream
-        return obj
-      }, {})
-    const mux = new gdal.RasterMuxStream(streams)
-
-    const ws = output.pixels.createWriteStream({ convertNoData })
-
-    const xform = new gdal.RasterTransform({ type: gdal.fromDataType(outType), fn })
-
-    return new Promise((resolve, reject) => {
-      mux.on('error', reject)
-      ws.on('error', reject)
-      xform.on('error', reject)
-      if (progress) {
-        let processed = 0
-        mux.on('data', (chunk) => {
-          processed += chunk[Object.keys(chunk)[0]].length
-          const done = processed / length
-          try {
-            progress(done)
-          } catch (e) {
-            reject(e)
-          }
-        })
+
+    const inSizesQ = Object.keys(inputs).map((inp) => inputs[inp].sizeAsync)
+    const outSizeQ = output.sizeAsync
+    const outTypeQ = output.dataTypeAsync
+
+    return Promise.all([ outTypeQ, outSizeQ,...inSizesQ ]).then((values) => {
+      if (signal && signal.aborted) throw abortable.abortError()
+      const outType = values[0]
+      for (let i = 2; i < values.length; i++) {
+        if (values[1].x != values[i].x || values[1].y != values[i].y) {
+          throw new RangeError('All raster bands dimensions must match')
+        }
       }
+      const length = values[1].x * values[1].y
+
+      const type = convertInput ? gdal.fromDataType(outType) : undefined
+      // All the buffers are recycled, the pipeline does not allocate once it is running
+      const pool = new gdal.RasterBufferPool()
+      const streams = Object.keys(inputs)
+        .map((inp) => ({ id: inp, stream: inputs[inp].pixels.createReadStream({ convertNoData, type, pool }) }))
+        .reduce((obj, stream) => {
+          obj[stream.id] = stream.stream
+          return obj
+        }, {})
+      const mux = new gdal.RasterMuxStream(streams, { pool })
 
-      mux.pipe(xform).pipe(ws)
+      const ws = output.pixels.createWriteStream({ convertNoData, pool })
 
-      ws.on('finish', resolve)
+      const xform = new gdal.RasterTransform({ type: gdal.fromDataType(outType), fn, pool })
+
+      return new Promise((resolve, reject) => {
+        if (signal) {
+          // The streams stop reading and writing, the reads in flight complete in the background
+          const onAbort = () => {
+            const err = abortable.abortError()
+            reject(err)
+            mux.unpipe(xform)
+            xform.unpipe(ws)
+            for (const id of Object.keys(streams)) streams[id].destroy()
+            mux.destroy()
+            xform.destroy()
+            ws.destroy()
+          }
+          signal.addEventListener('abort', onAbort)
+          ws.on('close', () => signal.removeEventListener('abort', onAbort))
+        }
+        mux.on('error', reject)
+        ws.on('error', reject)
+        xform.on('error', reject)
+        if (progress) {
+          let processed = 0
+          mux.on('data', (chunk) => {
+            processed += chunk[Object.keys(chunk)[0]].length
+            const done = processed / length
+            try {
+              progress(done)
+            } catch (e) {
+              reject(e)
+            }
+          })
+        }
+
+        mux.pipe(xform).pipe(ws)
+
+        ws.on('finish', resolve)
+      })
     })
-  })
+  }
 }
 
 module.exports = calc
@@ -0,0 +1,56 @@
+// diagnostics_channel and perf_hooks integration of the async jobs
+//
+// The native scheduler publishes on three channels:
+// * gdal:job:start when a job is scheduled
+// * gdal:job:lock when it has acquired its Dataset locks and it is sent to the thread pool
+// * gdal:job:end when its callback has been called or its Promise has been settled
+// Nothing is built and nothing is published when a channel has no subscribers
+module.exports = (gdal) => {
+  let dc
+  try {
+    dc = require('diagnostics_channel')
+  } catch (e) {
+    // Node.js < 14.17
+  }
+
+  const channels = dc && {
+    start: dc.channel('gdal:job:start'),
+    lock: dc.channel('gdal:job:lock'),
+    end: dc.channel('gdal:job:end')
+  }
+  if (channels) gdal._setDiagnosticsChannels(channels.start, channels.lock, channels.end)
+
+  let performance
+  const measure = (msg) => {
+    const duration = msg.lockWait + msg.queueWait + msg.execute + msg.rval
+    const name = `gdal:${msg.method}`
+    performance.measure(name, { start: performance.now() - duration, duration, detail: msg })
+    // The entries are delivered to the PerformanceObservers, they are not kept in the timeline
+    performance.clearMeasures(name)
+  }
+
+  /**
+   * Emit a `PerformanceMeasure` named `gdal:<method>`, ie `gdal:RasterBandPixels.read`,
+   * for every completed async operation, its `detail` is the message of the
+   * `gdal:job:end` diagnostics channel.
+   *
+   * The entries can be collected with a `PerformanceObserver`, they are not kept
+   * in the performance timeline. Requires Node.js >= 16.
+   *
+   * @static
+   * @method recordPerformanceEntries
+   * @param {boolean} enable
+   */
+  return function recordPerformanceEntries(enable) {
+    if (!channels) throw new Error('diagnostics_channel is not supported by this version of Node.js')
+    if (enable) {
+      if (performance) return
+      performance = require('perf_hooks').performance
+      channels.end.subscribe(measure)
+    } else {
+      if (!performance) return
+      channels.end.unsubscribe(measure)
+      performance = undefined
+    }
+  }
+}
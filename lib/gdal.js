@@ -137,15 +137,19 @@ gdal.Layer.prototype.getExtent = function () {
 const readStream = require('./readable.js')
 const writeStream = require('./writable.js')
 const muxStream = require('./multiplexer.js')
+const bufferPool = require('./buffer_pool.js')
 gdal.RasterBandPixels.prototype.createReadStream = readStream.createReadStream
 gdal.RasterReadStream = readStream.RasterReadStream
 gdal.RasterBandPixels.prototype.createWriteStream = writeStream.createWriteStream
 gdal.RasterWriteStream = writeStream.RasterWriteStream
 gdal.RasterMuxStream = muxStream.RasterMuxStream
 gdal.RasterTransform = muxStream.RasterTransform
+gdal.RasterBufferPool = bufferPool.RasterBufferPool
 
 gdal.calcAsync = require('./calc')(gdal)
 
+gdal.recordPerformanceEntries = require('./diagnostics.js')(gdal)
+
 gdal.wrapVRT = require('./wrapVRT')
 
 /**
@@ -226,6 +230,7 @@ gdal.createPixelFuncWithArgs = function createPixelFunc(fn) {
 /**
  * @typedef {object} ProgressOptions
  * @property {ProgressCb} progress_cb
+ * @property {AbortSignal} [signal]
  */
 
 /**
@@ -313,6 +318,12 @@ gdal.DatasetBands.prototype.getEnvelope = function () {
 
 require('./iterators.js')(gdal)
 
+/**
+ * @typedef {object} OpenOptions
+ * @property {number} [pool] Open this many GDAL handles on the same file, read-only async operations on the bands of the dataset will run in parallel, each one on its own handle
+ * @property {AbortSignal} [signal] Abort the opening, `gdal.openAsync` only
+ */
+
 /**
  * Creates or opens a dataset. Dataset should be explicitly closed with `dataset.close()` method if opened in `"w"` mode to flush any changes. Otherwise, datasets are closed when (and if) node decides to garbage collect them.
  *
@@ -328,8 +339,8 @@ require('./iterators.js')(gdal)
  * @method open
  * @static
  * @param {string|Buffer} path Path to dataset or in-memory Buffer to open
- * @param {string} [mode="r"] The mode to use to open the file: `"r"`, `"r+"`, or `"w"`
- * @param {string|string[]} [drivers] Driver name, or list of driver names to attempt to use.
+ * @param {string} [mode="r"] The mode to use to open the file: `"r"`, `"r+"`, or `"w"`, add `"t"` to open a raster in thread-safe mode (GDAL >= 3.10) allowing parallel async reads
+ * @param {string|string[]|OpenOptions} [drivers] Driver name, or list of driver names to attempt to use, or the open options of a read-only dataset.
  *
  * @param {number} [x_size] Used when creating a raster dataset with the `"w"` mode.
  * @param {number} [y_size] Used when creating a raster dataset with the `"w"` mode.
@@ -356,6 +367,11 @@ gdal.open = (function () {
       return ds
     }
 
+    if (drivers && typeof drivers === 'object' && !Array.isArray(drivers)) {
+      // open options
+      return open.call(gdal, filename, mode, drivers)
+    }
+
     if (typeof drivers === 'string') {
       drivers = [ drivers ]
     } else if (drivers && !Array.isArray(drivers)) {
@@ -408,6 +424,7 @@ gdal.open = (function () {
 
 const promisify = require('util').promisify
 const callbackify = require('util').callbackify
+const abortable = require('./abort.js')(gdal)
 
 /**
  * Asynchronously creates or opens a dataset. Dataset should be explicitly closed with `dataset.close()` method if opened in `"w"` mode to flush any changes. Otherwise, datasets are closed when (and if) node decides to garbage collect them.
@@ -428,8 +445,8 @@ const callbackify = require('util').callbackify
  * @method openAsync
  * @static
  * @param {string|Buffer} path Path to dataset or in-memory Buffer to open
- * @param {string} [mode="r"] The mode to use to open the file: `"r"`, `"r+"`, or `"w"`
- * @param {string|string[]} [drivers] Driver name, or list of driver names to attempt to use.
+ * @param {string} [mode="r"] The mode to use to open the file: `"r"`, `"r+"`, or `"w"`, add `"t"` to open a raster in thread-safe mode (GDAL >= 3.10) allowing parallel async reads
+ * @param {string|string[]|OpenOptions} [drivers] Driver name, or list of driver names to attempt to use, or the open options of a read-only dataset.
  *
  * @param {number} [x_size] Used when creating a raster dataset with the `"w"` mode.
  * @param {number} [y_size] Used when creating a raster dataset with the `"w"` mode.
@@ -452,7 +469,12 @@ const callbackify = require('util').callbackify
 
 gdal.openAsync = (function () {
   const openPromise = (function () {
-    const openPromise = promisify(gdal.openAsync)
+    const openNative = gdal.openAsync
+    const openPromise = function (filename, mode, options) {
+      const args = [ filename, mode, options ]
+      const signal = abortable.extractSignal(args)
+      return abortable.callAbortable(openNative, this, args, 3, signal)
+    }
 
     // add 'w' mode to gdal.open() method and also GDAL2-style driver selection
     return function (
@@ -478,6 +500,10 @@ gdal.openAsync = (function () {
           return ds
         })
       }
+      if (drivers && typeof drivers === 'object' && !Array.isArray(drivers)) {
+        // open options
+        return openPromise.call(gdal, filename, mode, drivers)
+      }
       if (typeof drivers === 'string') {
         drivers = [ drivers ]
       } else if (drivers && !Array.isArray(drivers)) {
@@ -519,7 +545,7 @@ gdal.openAsync = (function () {
       }
 
       // call gdal.open() method normally
-      return openPromise.call(gdal, filename, mode)
+      return openPromise.call(gdal, filename, mode, undefined)
     }
   })()
 
@@ -694,6 +720,21 @@ const mangleRead = (args) => {
   ]
 }
 
+const mangleReadv = (args) => {
+  if (Array.isArray(args[0])) {
+    for (const win of args[0]) {
+      if (win && win.data) win.data._gdal_type = getTypedArrayType(win.data)
+    }
+  }
+  return args
+}
+
+const mangleDatasetRead = (args) => {
+  const options = args[4]
+  if (options && options.data) options.data._gdal_type = getTypedArrayType(options.data)
+  return args
+}
+
 const mangleBlock = (args) => {
   if (args[2]) args[2]._gdal_type = getTypedArrayType(args[2])
   return args
@@ -706,6 +747,15 @@ const mangleMDArray = (args) => {
   return args
 }
 
+// transformPoints(xy, options) is transformPoints(xy, null, null, options)
+const mangleTransformPoints = (args) => {
+  const options = args[1]
+  if (options && typeof options === 'object' && !ArrayBuffer.isView(options)) {
+    return [ args[0], null, null, options ]
+  }
+  return args
+}
+
 gdal.RasterBandPixels.prototype.read = (function () {
   const read = gdal.RasterBandPixels.prototype.read
   return function () {
@@ -713,6 +763,20 @@ gdal.RasterBandPixels.prototype.read = (function () {
   }
 })()
 
+gdal.RasterBandPixels.prototype.readv = (function () {
+  const readv = gdal.RasterBandPixels.prototype.readv
+  return function () {
+    return readv.apply(this, mangleReadv(arguments))
+  }
+})()
+
+gdal.Dataset.prototype.read = (function () {
+  const read = gdal.Dataset.prototype.read
+  return function () {
+    return read.apply(this, mangleDatasetRead(arguments))
+  }
+})()
+
 gdal.RasterBandPixels.prototype.write = (function () {
   const write = gdal.RasterBandPixels.prototype.write
   return function () {
@@ -745,6 +809,13 @@ if (gdal.MDArray) {
   })()
 }
 
+gdal.CoordinateTransformation.prototype.transformPoints = (function () {
+  const transformPoints = gdal.CoordinateTransformation.prototype.transformPoints
+  return function () {
+    return transformPoints.apply(this, mangleTransformPoints(arguments))
+  }
+})()
+
 const GroupCollection = {
   countAsync: 0,
   getAsync: 1
@@ -760,6 +831,7 @@ const promisifiables = {
   Dataset: {
     flushAsync: 0,
     buildOverviewsAsync: 4,
+    readAsync: 5,
     executeSQLAsync: 3,
     getMetadataAsync: 1,
     setMetadataAsync: 2
@@ -771,11 +843,13 @@ const promisifiables = {
     flushAsync: 0,
     fillAsync: 2,
     computeStatisticsAsync: 1,
+    computeSummaryAsync: 1,
     getMetadataAsync: 1,
     setMetadataAsync: 2
   },
   RasterBandPixels: {
     readAsync: 13,
+    readvAsync: 1,
     writeAsync: 11,
     readBlockAsync: 3,
     writeBlockAsync: 3,
@@ -797,7 +871,11 @@ const promisifiables = {
     nextAsync: 0,
     addAsync: 1,
     countAsync: 1,
-    removeAsync: 1
+    removeAsync: 1,
+    readBatchAsync: 1
+  },
+  CoordinateTransformation: {
+    transformPointsAsync: 4
   },
   DatasetBands: {
     getAsync: 1,
@@ -814,6 +892,9 @@ const promisifiables = {
     $fromWKBAsync: 2,
     $fromGeoJsonAsync: 1,
     $fromGeoJsonBufferAsync: 1,
+    $fromWKBBatchAsync: 3,
+    $fromGeoJsonBufferBatchAsync: 2,
+    $toWKBBatchAsync: 3,
     toKMLAsync: 0,
     toGMLAsync: 0,
     toWKTAsync: 0,
@@ -850,7 +931,19 @@ const promisifiables = {
     overlapsAsync: 1,
     distanceAsync: 1,
     transformAsync: 1,
-    transformToAsync: 1
+    transformToAsync: 1,
+    prepareAsync: 0
+  },
+  PreparedGeometry: {
+    intersectsManyAsync: 1,
+    containsManyAsync: 1
+  },
+  SpatialIndex: {
+    $fromGeometriesAsync: 2,
+    $fromLayerAsync: 2,
+    searchAsync: 1,
+    nearestAsync: 2,
+    joinAsync: 1
   },
   SpatialReference: {
     $fromURLAsync: 1,
@@ -885,25 +978,34 @@ const promisifiables = {
     $buildVRTAsync: 4,
     $rasterizeAsync: 4,
     $demAsync: 6,
-    $_acquireLocksAsync: 3
+    $_acquireLocksAsync: 3,
+    $_calcAsync: 4
   }
 }
 
 const argMangle = {
+  Dataset: {
+    readAsync: mangleDatasetRead
+  },
   RasterBandPixels: {
     readAsync: mangleRead,
+    readvAsync: mangleReadv,
     writeAsync: mangleWrite,
     readBlockAsync: mangleBlock,
     writeBlockAsync: mangleBlock
   },
   MDArray: {
     readAsync: mangleMDArray
+  },
+  CoordinateTransformation: {
+    transformPointsAsync: mangleTransformPoints
   }
 }
 
 // For each *Async function create a function that checks if the last parameter is a callback
 // Then call either the original, either the promisified version with the callback
 // placed at the right argument number since the C++ code does not support floating callbacks
+// An AbortSignal can be given as any argument or as the signal property of an options object
 for (const c of Object.keys(promisifiables)) {
   const klass = c === '$' ? gdal : gdal[c]
   if (klass === undefined) {
@@ -927,7 +1029,12 @@ for (const c of Object.keys(promisifiables)) {
           callback = arguments[arguments.length - 1]
           arguments[arguments.length - 1] = undefined
         }
-        let args = Array.prototype.slice.call(mangle(arguments), 0, cbArg)
+        const all = Array.prototype.slice.call(arguments)
+        const signal = abortable.extractSignal(all)
+        let args = Array.prototype.slice.call(mangle(all), 0, cbArg)
+        if (signal) {
+          return abortable.callAbortable(original, this, args, cbArg, signal, callback)
+        }
         if (callback) {
           args[cbArg] = callback
           return original.apply(this, args)
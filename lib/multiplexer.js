@@ -4,6 +4,12 @@ const debug = process.env.NODE_DEBUG && process.env.NODE_DEBUG.match(/gdal_mux|g
   console.debug.bind(console, 'RasterMuxStream:') :
   () => undefined
 
+// The native consolidation helper, this module is loaded by gdal.js
+let native
+const gather = (sources, targets) => {
+  if (!native) native = require('./gdal.js')
+  native._gather(sources, targets)
+}
 
 /**
  * Multiplexer stream
@@ -13,9 +19,17 @@ const debug = process.env.NODE_DEBUG && process.env.NODE_DEBUG.match(/gdal_mux|g
  *
  * All the input streams must have the same length.
  *
+ * When the inputs are {@link RasterReadStream} streams in `tiles` mode, the
+ * output is a stream of {@link RasterTile} objects whose `data` is an object
+ * with the data of each input. All the inputs must then have the same block size.
+ *
  * Can be used with {@link RasterTransform}
  * which will automatically apply a function over the whole chunk.
  *
+ * When the inputs have different chunk sizes, the chunks of all the inputs
+ * are consolidated by a single native call, into buffers from the
+ * {@link RasterBufferPool} when one is given.
+ *
  * @example
  *
  *  const dsT2m = gdal.open('AROME_T2m_10.tiff'));
@@ -53,6 +67,7 @@ const debug = process.env.NODE_DEBUG && process.env.NODE_DEBUG.match(/gdal_mux|g
  * @param {Record<string,RasterReadStream>} inputs Input streams
  * @param {RasterReadableOptions} [options]
  * @param {boolean} [options.blockOptimize=true] Read by file blocks when possible (when rasterSize.x == blockSize.x)
+ * @param {RasterBufferPool} [options.pool=undefined] Consolidate into buffers from this pool and release the consumed chunks to it
  */
 class RasterMuxStream extends Readable {
   constructor(inputs, options) {
@@ -64,6 +79,7 @@ class RasterMuxStream extends Readable {
     this.dataHandlers = {}
     this.endHandlers = {}
     this.blockOptimize = (options || {}).blockOptimize
+    this.pool = (options || {}).pool
     this.rasterHighWaterMark = Infinity
 
     for (const id of this.ids) {
@@ -86,7 +102,38 @@ class RasterMuxStream extends Readable {
     }
   }
 
+  // tiles mode, the inputs are synchronized tile by tile
+  handleIncomingTile(recv, tile) {
+    debug('received tile on', recv, tile.x, tile.y)
+    this.buffers[recv].push(tile)
+    this.buffersTotalData[recv] += tile.data.length
+
+    while (this.ids.every((id) => this.buffers[id].length > 0 && this.buffers[id][0] !== null)) {
+      const first = this.buffers[this.ids[0]][0]
+      const send = { x: first.x, y: first.y, w: first.w, h: first.h, data: {} }
+      for (const id of this.ids) {
+        const t = this.buffers[id].shift()
+        if (t.x !== first.x || t.y !== first.y || t.w !== first.w || t.h !== first.h) {
+          debug('destroy on tiles mismatch', id)
+          this.destroy(new Error(`tiles mismatch on ${id}, all inputs must have the same block size`))
+          return
+        }
+        send.data[id] = t.data
+        this.buffersTotalData[id] -= t.data.length
+      }
+
+      const flowing = this.push(send)
+      this.rasterHighWaterMark = first.data.length * this.readableHighWaterMark
+      this.throttle(flowing)
+    }
+    this.tryEnd()
+  }
+
   handleIncoming(recv, chunk) {
+    if (chunk && !chunk.BYTES_PER_ELEMENT && chunk.data) {
+      this.handleIncomingTile(recv, chunk)
+      return
+    }
     debug('received on', recv, 'chunk', 'chunk.length')
     this.buffers[recv].push(chunk)
     this.buffersTotalData[recv] += chunk.length
@@ -98,6 +145,9 @@ class RasterMuxStream extends Readable {
 
     debug('sending', maxReady)
     const send = {}
+    const sources = []
+    const targets = []
+    const consumed = []
     for (const id of this.ids) {
       if (this.buffers[id][0] === null) {
         // one of the inputs ended before the others
@@ -110,32 +160,44 @@ class RasterMuxStream extends Readable {
         send[id] = this.buffers[id][0]
         this.buffers[id].shift()
       } else {
-        // block consolidation mode
+        // block consolidation mode, the copying is done below for all inputs at once
         debug('block consolidation from', id, this.buffers[id].map((buf) => buf && buf.length || 'null').join(','))
-        send[id] = new this.buffers[id][0].constructor(maxReady)
+        const chunks = []
         let len = 0
-        while (len + this.buffers[id][0].length < maxReady) {
-          debug('chunking')
-          send[id].set(this.buffers[0], len)
-          len += this.buffers[id][0].length
-          this.buffers[id].shift()
-          if (this.buffers[id][0] === null) {
+        while (len < maxReady) {
+          const chunk = this.buffers[id][0]
+          if (chunk === null) {
             // one of the inputs ended before the others
             debug('destroy on premature end', id)
-            this.destroy('premature end on', id)
+            this.destroy(`premature end on ${id}`)
             return
           }
+          chunks.push(chunk)
+          if (len + chunk.length <= maxReady) {
+            len += chunk.length
+            consumed.push(chunk)
+            this.buffers[id].shift()
+          } else {
+            debug('final chunk', maxReady - len, chunk.length)
+            this.buffers[id][0] = chunk.subarray(maxReady - len)
+            len = maxReady
+          }
         }
-        debug('final chunk', maxReady - len, this.buffers[id][0].length)
-        send[id].set(this.buffers[id][0].subarray(0, maxReady - len), len)
-        if (maxReady - len < this.buffers[id][0].length) {
-          this.buffers[id][0] = this.buffers[id][0].subarray(maxReady - len)
-        } else {
-          this.buffers[id].shift()
-        }
+        send[id] = this.pool ? this.pool.acquire(chunks[0].constructor, maxReady) : new chunks[0].constructor(maxReady)
+        sources.push(chunks)
+        targets.push(send[id])
       }
       this.buffersTotalData[id] -= maxReady
     }
+    if (targets.length > 0) {
+      try {
+        gather(sources, targets)
+      } catch (e) {
+        this.destroy(e)
+        return
+      }
+      if (this.pool) consumed.forEach((chunk) => this.pool.release(chunk))
+    }
 
     // send the consolidated result and eventually start pausing
     const flowing = this.push(send)
@@ -213,6 +275,7 @@ class RasterMuxStream extends Readable {
  * @extends stream.TransformOptions
  * @property {Function} fn Function to be applied on all data
  * @property {new (len: number) => TypedArray} type Typed array constructor
+ * @property {RasterBufferPool} [pool]
  */
 
 /**
@@ -220,7 +283,11 @@ class RasterMuxStream extends Readable {
  *
  * Applies a function on all data elements.
  *
- * Input must be a {@link RasterMuxStream}
+ * Input must be a {@link RasterMuxStream}, in `tiles` mode the output
+ * is a stream of {@link RasterTile} objects
+ *
+ * When a {@link RasterBufferPool} is given, the output is allocated from
+ * the pool and the input chunks are released to it once they are processed
  *
  * {@link calcAsync} provides a higher-level interface for the same feature, while
  * an even lower-level API is available by manually extending `stream.Transform` as illustrated
@@ -253,27 +320,35 @@ class RasterMuxStream extends Readable {
  * @param {RasterTransformOptions} [options]
  * @param {Function} options.fn Function to be applied on all data
  * @param {new (len: number) => TypedArray} options.type Typed array constructor
+ * @param {RasterBufferPool} [options.pool=undefined] Allocate the output from this pool and release the input chunks to it
  */
 class RasterTransform extends Transform {
   constructor(opts) {
     super({ ...opts, objectMode: true })
     this.type = opts.type
     this.fn = opts.fn
+    this.pool = opts.pool
   }
 
   _transform(chunk, _, cb) {
+    // tiles mode
+    const tile = typeof chunk.x === 'number' && chunk.data && !chunk.data.BYTES_PER_ELEMENT ? chunk : null
+    const inp = tile ? tile.data : chunk
     if (!this.xform) {
       const thunk = `
         for (let i = 0; i < len; i++)
-          out[i] = this.fn(${Object.keys(chunk).map((key) => `inp.${key}[i]`).join(',')})`
+          out[i] = this.fn(${Object.keys(inp).map((key) => `inp.${key}[i]`).join(',')})`
       this.xform = new Function('inp', 'out', 'len', thunk)
     }
 
-    const len = chunk[Object.keys(chunk)[0]].length
-    const out = new this.type(len)
+    const len = inp[Object.keys(inp)[0]].length
+    const out = this.pool ? this.pool.acquire(this.type, len) : new this.type(len)
     try {
-      this.xform(chunk, out, len)
-      cb(null, out)
+      this.xform(inp, out, len)
+      if (this.pool) {
+        for (const key of Object.keys(inp)) this.pool.release(inp[key])
+      }
+      cb(null, tile ? { x: tile.x, y: tile.y, w: tile.w, h: tile.h, data: out } : out)
     } catch (err) {
       cb(err)
     }
@@ -10,6 +10,20 @@ const debug = process.env.NODE_DEBUG && process.env.NODE_DEBUG.match(/gdal_read|
  * @property {boolean} [blockOptimize]
  * @property {boolean} [convertNoData]
  * @property {new (len: number) => TypedArray} [type]
+ * @property {number} [prefetch]
+ * @property {string} [mode]
+ * @property {RasterBufferPool} [pool]
+ */
+
+/**
+ * A chunk of a stream in `tiles` mode, a window of the raster aligned on its blocks
+ *
+ * @typedef {object} RasterTile
+ * @property {number} x
+ * @property {number} y
+ * @property {number} w
+ * @property {number} h
+ * @property {TypedArray} data `w * h` pixels in row-major order
  */
 
 /**
@@ -19,9 +33,12 @@ const debug = process.env.NODE_DEBUG && process.env.NODE_DEBUG.match(/gdal_read|
  * @instance
  * @method createReadStream
  * @param {RasterReadableOptions} [options]
- * @param {boolean} [options.blockOptimize=true] Read by file blocks when possible (when `rasterSize.x == blockSize.x`)
+ * @param {boolean} [options.blockOptimize=true] Read by file blocks or by rows of blocks, otherwise read line by line
  * @param {boolean} [options.convertNoData=true] Automatically convert `RasterBand.noDataValue` to `NaN`
  * @param {new (len: number) => TypedArray} [options.readAs=undefined] Data type to convert to, must be a `TypedArray` constructor
+ * @param {number} [options.prefetch=2] Number of reads to keep in flight ahead of the consumer
+ * @param {string} [options.mode="pixels"] `"pixels"` to stream the pixels in row-major order or `"tiles"` to stream {@link RasterTile} objects, one per block of the raster
+ * @param {RasterBufferPool} [options.pool=undefined] Read into buffers from this pool
  * @returns {RasterReadStream}
  */
 function createReadStream(options) {
@@ -29,31 +46,50 @@ function createReadStream(options) {
   return readable
 }
 
+// Upper limit of the size of one row of blocks when the blocks are narrower than the raster
+const maxStripPixels = 4 * 1024 * 1024
+
 /**
  * Class implementing {@link RasterBand} reading as a stream of pixels}
  *
  * Reading is buffered and it is aligned on the underlying
- * compression blocks for maximum efficiency when possible
+ * compression blocks for maximum efficiency when possible:
+ * by blocks when the blocks span the whole width of the raster,
+ * by rows of blocks otherwise
+ *
+ * Up to `prefetch` reads are kept in flight, so that the decompression
+ * in the background threads overlaps with the consumer
  *
- * Pixels are streamed in row-major order
+ * Pixels are streamed in row-major order, unless the stream is in `tiles` mode:
+ * it then streams the blocks of the raster, as {@link RasterTile} objects,
+ * and each block is read exactly once
+ *
+ * When a {@link RasterBufferPool} is given, the data is read into buffers from
+ * the pool, these should be released by the consumer
  *
  * @class RasterReadStream
  * @extends stream.Readable
  * @constructor
  * @param {RasterReadableOptions} [options]
  * @param {RasterBand} options.band RasterBand to use
- * @param {boolean} [options.blockOptimize=true] Read by file blocks when possible (when `rasterSize.x == blockSize.x`)
+ * @param {boolean} [options.blockOptimize=true] Read by file blocks or by rows of blocks, otherwise read line by line
  * @param {boolean} [options.convertNoData=false] Automatically convert `RasterBand.noDataValue` to `NaN`, requires float data types
  * @param {new (len: number) => TypedArray} [options.type=undefined] Data type to convert to, must be a `TypedArray` constructor, default is the raster band data type
+ * @param {number} [options.prefetch=2] Number of reads to keep in flight ahead of the consumer
+ * @param {string} [options.mode="pixels"] `"pixels"` to stream the pixels in row-major order or `"tiles"` to stream {@link RasterTile} objects, one per block of the raster
+ * @param {RasterBufferPool} [options.pool=undefined] Read into buffers from this pool
  */
 class RasterReadStream extends Readable {
   constructor(options) {
     super({ ...options, objectMode: true })
     this.band = options.band
     this.readingPos = 0
-    this.blockPos = 0
+    this.pending = []
     this.readingInProgress = false
     this.rasterEnded = false
+    this.prefetch = options.prefetch === undefined ? 2 : +options.prefetch
+    this.tiles = options.mode === 'tiles'
+    this.pool = options.pool
 
     if (typeof options.type !== 'undefined') {
       try {
@@ -67,6 +103,14 @@ class RasterReadStream extends Readable {
       throw new TypeError('"band" must be a gdal.RasterBand')
     }
 
+    if (!(this.prefetch >= 1)) {
+      throw new RangeError('"prefetch" must be at least 1')
+    }
+
+    if (options.mode !== undefined && options.mode !== 'pixels' && options.mode !== 'tiles') {
+      throw new TypeError('"mode" must be "pixels" or "tiles"')
+    }
+
     // This part is an ideal candidate for Node 16 _construct,
     // but alas our baseline is Node 12 so some rather
     // cumbersome acrobatics are needed
@@ -79,74 +123,134 @@ class RasterReadStream extends Readable {
         } else {
           this._convertNoData = () => undefined
         }
-        if (blockSize.x == rasterSize.x && options.blockOptimize !== false) {
-          debug('init done, optimized block read', blockSize, rasterSize)
-          this._readNextBuffer = RasterReadStream.prototype._readNextBlock
-          if (options.type) {
-            this.arrayConstructor = () => new options.type(blockSize.x * blockSize.y)
-          }
+        if (this.tiles) {
+          this.blocksX = Math.ceil(rasterSize.x / blockSize.x)
+          this.readingEnd = this.blocksX * Math.ceil(rasterSize.y / blockSize.y)
+          debug('init done, tiles read', blockSize, rasterSize, this.readingEnd)
+          this._nextRead = RasterReadStream.prototype._nextTile
+          this._initArrayConstructor(options.type)
           return
         }
-        debug('init done, line by line read', blockSize, rasterSize)
-        this._readNextBuffer = RasterReadStream.prototype._readNextLine
-        if (options.type) {
-          this.arrayConstructor = () => new options.type(rasterSize.x)
+        this.readingEnd = rasterSize.y
+        this._nextRead = RasterReadStream.prototype._nextRows
+        if (blockSize.x == rasterSize.x && options.blockOptimize !== false) {
+          debug('init done, optimized block read', blockSize, rasterSize)
+          this._readBuffer = RasterReadStream.prototype._readBlock
+          this.rows = blockSize.y
+        } else if (options.blockOptimize !== false) {
+          // All the blocks of a row are read by a single GDAL call
+          this.rows = Math.max(1, Math.min(blockSize.y, Math.floor(maxStripPixels / rasterSize.x)))
+          debug('init done, block row read', blockSize, rasterSize, this.rows)
+          this._readBuffer = RasterReadStream.prototype._readLines
+        } else {
+          debug('init done, line by line read', blockSize, rasterSize)
+          this._readBuffer = RasterReadStream.prototype._readLines
+          this.rows = 1
         }
+        this._initArrayConstructor(options.type)
       })
   }
 }
 
+// Without a pool, the arrays are allocated by the read operations unless
+// a type is given, with a pool, the type of the band is known after the first read
+RasterReadStream.prototype._initArrayConstructor = function (type) {
+  if (!type) return
+  if (this.pool) {
+    this.arrayConstructor = (len) => this.pool.acquire(type, len)
+  } else {
+    this.arrayConstructor = (len) => new type(len)
+  }
+}
+
 RasterReadStream.prototype._doConvertNoData = function (noData, buffer) {
   for (let i = 0; i < buffer.length; i++) {
     if (buffer[i] === noData) buffer[i] = NaN
   }
 }
 
+// Keeps up to `prefetch` reads in flight, they are queued in order
+// and they run in the background while the previous ones are being consumed
+RasterReadStream.prototype._prefetch = function () {
+  while (this.pending.length < this.prefetch && this.readingPos < this.readingEnd) {
+    const q = this._nextRead()
+    // The rejection is handled when the read is consumed, until then it must not be reported as unhandled
+    q.catch(() => undefined)
+    this.pending.push(q)
+  }
+}
+
+// The next lines in row-major order
+RasterReadStream.prototype._nextRows = function () {
+  const y = this.readingPos
+  const actualSize = Math.min(this.rows, this.rasterSize.y - y)
+  debug('prefetching', y, actualSize)
+  this.readingPos += actualSize
+  return this._readBuffer(y, actualSize)
+}
+
+// The next block, the edge blocks are read as windows of their actual size
+RasterReadStream.prototype._nextTile = function () {
+  const bx = this.readingPos % this.blocksX
+  const by = Math.floor(this.readingPos / this.blocksX)
+  const x = bx * this.blockSize.x
+  const y = by * this.blockSize.y
+  const w = Math.min(this.blockSize.x, this.rasterSize.x - x)
+  const h = Math.min(this.blockSize.y, this.rasterSize.y - y)
+  debug('prefetching tile', x, y, w, h)
+  this.readingPos++
+  const array = this.arrayConstructor ? this.arrayConstructor(w * h) : undefined
+  const dataq = w == this.blockSize.x && h == this.blockSize.y ?
+    this.band.pixels.readBlockAsync(bx, by, array) :
+    this.band.pixels.readAsync(x, y, w, h, array)
+  return dataq.then((data) => ({ x, y, w, h, data }))
+}
+
 RasterReadStream.prototype._readNext = function () {
-  debug('reading next block', this.readingPos, this.readingInProgress)
+  debug('reading next buffer', this.readingPos, this.readingInProgress)
   if (this.readingInProgress || this.rasterEnded) return
   this.readingInProgress = true
   this.initQ.then(() => {
-    debug('do read')
-    this._readNextBuffer()
-      .then((data) => {
-        this.readingInProgress = false
-        this._convertNoData(data)
-
-        debug('adding a new buffer', data.length)
-        const flowing = this.push(data)
-        if (this.readingPos == this.rasterSize.y) {
-          debug('raster ended at ', this.readingPos)
-          this.rasterEnded = true
-          this.push(null)
-          return
-        }
-        if (flowing) {
-          this._readNext()
-        } else {
-          debug('push buffer is full')
-        }
-      })
-      .catch((e) => {
-        debug('emitting error', e)
-        this.destroy(e)
-      })
+    this._prefetch()
+    const next = this.pending.shift()
+    // Start the next read before waiting for this one
+    this._prefetch()
+    return next
   })
+    .then((data) => {
+      this.readingInProgress = false
+      if (this.pool && !this.arrayConstructor) this._initArrayConstructor((this.tiles ? data.data : data).constructor)
+      this._convertNoData(this.tiles ? data.data : data)
+
+      debug('adding a new buffer', this.tiles ? data.data.length : data.length)
+      const flowing = this.push(data)
+      if (this.readingPos == this.readingEnd && this.pending.length === 0) {
+        debug('raster ended at ', this.readingPos)
+        this.rasterEnded = true
+        this.push(null)
+        return
+      }
+      if (flowing) {
+        this._readNext()
+      } else {
+        debug('push buffer is full')
+      }
+    })
+    .catch((e) => {
+      debug('emitting error', e)
+      this.pending = []
+      this.destroy(e)
+    })
 }
 
 // Optimized reading when horizontally there is only one block (blockSize.x == rasterSize.x)
 // This is more often the case than not
-RasterReadStream.prototype._readNextBlock = function () {
-  const actualSize = this.readingPos + this.blockSize.y > this.rasterSize.y ?
-    this.rasterSize.y - this.readingPos :
-    this.blockSize.y
-  const array = this.arrayConstructor ? this.arrayConstructor() : undefined
-  const dataq = this.band.pixels.readBlockAsync(0, this.blockPos, array)
+RasterReadStream.prototype._readBlock = function (y, actualSize) {
+  const array = this.arrayConstructor ? this.arrayConstructor(this.blockSize.x * this.blockSize.y) : undefined
+  const dataq = this.band.pixels.readBlockAsync(0, y / this.blockSize.y, array)
 
   return dataq
     .then((data) => {
-      this.readingPos += actualSize
-      this.blockPos++
       // Edge blocks, need to be clamped as the data is smaller than the block
       if (actualSize != this.blockSize.y) {
         debug('clamping', this.blockSize, actualSize)
@@ -156,23 +260,11 @@ RasterReadStream.prototype._readNextBlock = function () {
     })
 }
 
-// Line by line reading, in this case we are better off with
-// GDAL's own block cache handling the block reading
-// If GDAL can fit all the blocks from one horizontal line in its cache
-// this case will be almost as fast as the previous one
-RasterReadStream.prototype._readNextLine = function () {
-  let array
-  try {
-    array = this.arrayConstructor ? this.arrayConstructor() : undefined
-  } catch (e) {
-    console.error(e)
-  }
-  return this.band.pixels.readAsync(0, this.blockPos, this.rasterSize.x, 1, array)
-    .then((data) => {
-      this.readingPos++
-      this.blockPos++
-      return data
-    })
+// Reading by rows of blocks (or line by line), in this case GDAL
+// reads all the blocks of the row through its own block cache
+RasterReadStream.prototype._readLines = function (y, actualSize) {
+  const array = this.arrayConstructor ? this.arrayConstructor(actualSize * this.rasterSize.x) : undefined
+  return this.band.pixels.readAsync(0, y, this.rasterSize.x, actualSize, array)
 }
 
 RasterReadStream.prototype._read = function () {
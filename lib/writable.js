@@ -4,11 +4,20 @@ const debug = process.env.NODE_DEBUG && process.env.NODE_DEBUG.match(/gdal_write
   console.debug.bind(console, 'RasterWriteStream:') :
   () => undefined
 
+// The native consolidation helper, this module is loaded by gdal.js
+let native
+const gather = (sources, targets) => {
+  if (!native) native = require('./gdal.js')
+  native._gather(sources, targets)
+}
+
 /**
  * @interface RasterWritableOptions
  * @extends stream.WritableOptions
  * @property {boolean} [blockOptimize]
  * @property {boolean} [convertNoData]
+ * @property {string} [mode]
+ * @property {RasterBufferPool} [pool]
  */
 
 /**
@@ -20,6 +29,8 @@ const debug = process.env.NODE_DEBUG && process.env.NODE_DEBUG.match(/gdal_write
  * @param {RasterWritableOptions} [options]
  * @param {boolean} [options.blockOptimize=true] Write by file blocks when possible (when rasterSize.x == blockSize.x)
  * @param {boolean} [options.convertNoData=true] Automatically convert `NaN` to `RasterBand.noDataValue` if it is set
+ * @param {string} [options.mode="pixels"] `"pixels"` to receive the pixels in row-major order or `"tiles"` to receive {@link RasterTile} objects
+ * @param {RasterBufferPool} [options.pool=undefined] Release the written chunks to this pool and consolidate into buffers from it
  * @returns {RasterWriteStream}
  */
 function createWriteStream(options) {
@@ -50,6 +61,15 @@ function createWriteStream(options) {
  * Block are written only when full, so the stream must
  * receive exactly `width * height` pixels to write the last block
  *
+ * In `tiles` mode, the stream receives {@link RasterTile} objects, in any order,
+ * each one is written directly - blocks are written exactly once when the tiles
+ * are aligned on the blocks of the raster, as the ones produced by a {@link RasterReadStream}
+ * in `tiles` mode on a raster with the same block size, the stream must
+ * receive exactly `width * height` pixels
+ *
+ * When a {@link RasterBufferPool} is given, the chunks are released
+ * to the pool once they have been written
+ *
  * @class RasterWriteStream
  * @extends stream.Writable
  * @constructor
@@ -57,6 +77,8 @@ function createWriteStream(options) {
  * @param {RasterBand} options.band RasterBand to use
  * @param {boolean} [options.blockOptimize=true] Write by file blocks when possible (when rasterSize.x == blockSize.x)
  * @param {boolean} [options.convertNoData=false] Automatically convert `NaN` to `RasterBand.noDataValue` if it is set when the stream is constructed
+ * @param {string} [options.mode="pixels"] `"pixels"` to receive the pixels in row-major order or `"tiles"` to receive {@link RasterTile} objects
+ * @param {RasterBufferPool} [options.pool=undefined] Release the written chunks to this pool and consolidate into buffers from it
  */
 class RasterWriteStream extends Writable {
   constructor(options) {
@@ -66,11 +88,17 @@ class RasterWriteStream extends Writable {
     this.buffered = 0
     this.writingPos = 0
     this.blockPos = 0
+    this.tiles = options.mode === 'tiles'
+    this.pool = options.pool
 
     if (!options.band.pixels) {
       throw new TypeError('"band" must be a gdal.RasterBand')
     }
 
+    if (options.mode !== undefined && options.mode !== 'pixels' && options.mode !== 'tiles') {
+      throw new TypeError('"mode" must be "pixels" or "tiles"')
+    }
+
     this.initQ = Promise.all([ this.band.blockSizeAsync, this.band.sizeAsync, this.band.noDataValueAsync ])
       .then(([ blockSize, rasterSize, noDataValue ]) => {
         this.blockSize = blockSize
@@ -121,6 +149,7 @@ RasterWriteStream.prototype._writeNextLine = function (buffer) {
 
 RasterWriteStream.prototype._writeNext = function (cb) {
   const q = []
+  const written = []
   while (this.buffered >= this.blockLen) {
     // We have enough for one block
     let buffer
@@ -134,24 +163,30 @@ RasterWriteStream.prototype._writeNext = function (cb) {
       debug('writing full block in block consolidation mode', this.buffered, this.blockLen, this.buffers.map((buf) => buf.length))
       // block writing with in-memory copying (no gdal.RasterBand.pixels.writev)
       // source.blockSize != target.blockSize && target.blockSize.x = target.rasterSize.x
-      buffer = new this.buffers[0].constructor(this.blockLen)
+      const chunks = []
       let len = 0
-      while (len + this.buffers[0].length < this.blockLen) {
-        buffer.set(this.buffers[0], len)
-        len += this.buffers[0].length
-        this.buffers.shift()
-      }
-      buffer.set(this.buffers[0].subarray(0, this.blockLen - len), len)
-      if (this.blockLen - len < this.buffers[0].length) {
-        this.buffers[0] = this.buffers[0].subarray(this.blockLen - len)
-      } else {
-        this.buffers.shift()
+      while (len < this.blockLen) {
+        const chunk = this.buffers[0]
+        chunks.push(chunk)
+        if (len + chunk.length <= this.blockLen) {
+          len += chunk.length
+          this.buffers.shift()
+          if (this.pool) written.push(chunk)
+        } else {
+          this.buffers[0] = chunk.subarray(this.blockLen - len)
+          len = this.blockLen
+        }
       }
+      buffer = this.pool ?
+        this.pool.acquire(chunks[0].constructor, this.blockLen) :
+        new chunks[0].constructor(this.blockLen)
+      gather([ chunks ], [ buffer ])
     }
 
     debug('writing', this.blockPos, this.writingPos, buffer.length)
     this._convertNoData(buffer)
     q.push(this._writeNextBuffer(buffer))
+    if (this.pool) written.push(buffer)
     this.buffered -= buffer.length
     if (this.writingPos == this.rasterSize.y) {
       debug('raster finished')
@@ -174,6 +209,7 @@ RasterWriteStream.prototype._writeNext = function (cb) {
     Promise.all(q)
       .then((r) => {
         debug('signal when writing', r.length)
+        if (this.pool) written.forEach((buffer) => this.pool.release(buffer))
         try {
           cb()
         } catch (e) {
@@ -193,7 +229,58 @@ RasterWriteStream.prototype._writeNext = function (cb) {
   cb()
 }
 
+// Tiles are written directly, by blocks when they are aligned on the blocks
+RasterWriteStream.prototype._writeTile = function (tile, cb) {
+  const { x, y, w, h, data } = tile
+  if (x < 0 || y < 0 || x + w > this.rasterSize.x || y + h > this.rasterSize.y) {
+    cb(new RangeError(`Tile [${x}, ${y}, ${w}, ${h}] is outside the raster`))
+    return
+  }
+  this.buffered += w * h
+  if (this.buffered > this.rasterSize.x * this.rasterSize.y) {
+    cb(new RangeError('Writing beyond the end of the raster'))
+    return
+  }
+  if (this.buffered == this.rasterSize.x * this.rasterSize.y) this.rasterFinished = true
+  this._convertNoData(data)
+
+  const q = w == this.blockSize.x && h == this.blockSize.y && x % w == 0 && y % h == 0 ?
+    this.band.pixels.writeBlockAsync(x / w, y / h, data) :
+    this.band.pixels.writeAsync(x, y, w, h, data)
+  q.then(() => {
+    debug('signal when writing tile', x, y)
+    if (this.pool) this.pool.release(data)
+    try {
+      cb()
+    } catch (e) {
+      this.destroy(e)
+    }
+  })
+    .catch((err) => {
+      debug('re-emitting error', err)
+      cb(err)
+    })
+}
+
 RasterWriteStream.prototype._write = function (chunk, _, callback) {
+  if (this.tiles) {
+    debug('got tile', chunk.x, chunk.y, chunk.w, chunk.h)
+    let err
+    if (!chunk || typeof chunk.x !== 'number' || typeof chunk.y !== 'number' ||
+      typeof chunk.w !== 'number' || typeof chunk.h !== 'number' || !chunk.data || !chunk.data.BYTES_PER_ELEMENT) {
+      err = new TypeError('Only RasterTile objects are supported in tiles mode')
+    } else if (chunk.data.length !== chunk.w * chunk.h) {
+      err = new RangeError('The data of a tile must contain w * h pixels')
+    }
+    if (err) {
+      debug('emit error', err)
+      callback(err)
+      return
+    }
+    this.initQ.then(() => this._writeTile(chunk, callback))
+    return
+  }
+
   debug('got', chunk.length)
 
   let err
@@ -213,7 +300,7 @@ RasterWriteStream.prototype._write = function (chunk, _, callback) {
 }
 
 RasterWriteStream.prototype._final = function (cb) {
-  if (this.buffered > 0) return cb('Stream finished with pending data')
+  if (this.buffered > 0 && !this.tiles) return cb('Stream finished with pending data')
   if (!this.rasterFinished) return cb('Stream finished before filling the raster')
   this.band.ds.flushAsync()
     .catch((e) => ({ err: e }))
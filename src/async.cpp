@@ -1,17 +1,459 @@
 #include "async.hpp"
+#include <algorithm>
+#include <cpl_string.h>
 
 namespace node_gdal {
 
-std::thread::id mainV8ThreadId;
+// Each isolate (the main thread and the worker_threads) has its own scheduler
+// while the thread pool is shared, the jobs complete on the event loop that created them
+thread_local std::thread::id mainV8ThreadId;
 
-// *message coming from GDAL points to a statically allocated buffer
-GDALProgressInfo::GDALProgressInfo(double complete, const char *message) : complete(complete), message(message) {
+thread_local AsyncScheduler async_scheduler;
+thread_local AsyncCompletion async_completion;
+AsyncThreadPool async_thread_pool;
+thread_local ProgressThrottle progressThrottle = {100000, 0.01};
+
+static std::vector<long> normalizeUids(std::vector<long> uids) {
+  // Avoid deadlocks
+  std::sort(uids.begin(), uids.end());
+  // Eliminate dupes and 0s
+  uids.erase(std::unique(uids.begin(), uids.end()), uids.end());
+  uids.erase(std::remove(uids.begin(), uids.end(), 0), uids.end());
+  return uids;
+}
+
+// The pooled handles used by the current thread: primary handle -> pooled handle
+static thread_local std::vector<std::pair<GDALDataset *, GDALDataset *>> threadHandles;
+
+void AsyncGuard::checkoutHandles() {
+  std::vector<AsyncLockState *> states;
+  if (lock != nullptr) states.push_back(lock.get());
+  if (locks != nullptr)
+    for (const AsyncLock &l : *locks) states.push_back(l.get());
+  for (AsyncLockState *state : states) {
+    if (state->primary == nullptr) continue;
+    GDALDataset *handle = state->checkout();
+    handles.push_back({state, handle});
+    threadHandles.push_back({state->primary, handle});
+  }
+}
+
+void AsyncGuard::returnHandles() {
+  for (auto const &h : handles) {
+    auto mapping = std::find(threadHandles.begin(), threadHandles.end(), std::make_pair(h.first->primary, h.second));
+    if (mapping != threadHandles.end()) threadHandles.erase(mapping);
+    h.first->checkin(h.second);
+  }
+  handles.clear();
+}
+
+GDALDataset *pooledDataset(GDALDataset *ds) {
+  for (auto const &h : threadHandles)
+    if (h.first == ds) return h.second;
+  return ds;
+}
+
+GDALRasterBand *pooledBand(GDALRasterBand *band) {
+  if (threadHandles.empty() || band->GetBand() < 1) return band;
+  GDALDataset *ds = band->GetDataset();
+  GDALDataset *handle = pooledDataset(ds);
+  if (handle == ds) return band;
+  return handle->GetRasterBand(band->GetBand());
+}
+
+// Shared by all the isolates, the job ids are unique in the whole process
+static std::atomic<uint64_t> lastJobId(0);
+
+// The async_hooks resource type of a job is the name of its method, ie "node-gdal:RasterBandPixels.read"
+GDALAsyncWorkerBase::GDALAsyncWorkerBase(Nan::Callback *resultCallback, const std::vector<long> &ds_uids)
+  : GDALAsyncProgressWorker(resultCallback, ("node-gdal:" + metrics.method(currentMethodName)->name).c_str()),
+    ds_uids(normalizeUids(ds_uids)),
+    ds_locks(),
+    ds_error(nullptr),
+    store(&object_store),
+    lane(AsyncLane::IO),
+    shared(false),
+    abort_flag(nullptr),
+    method_metrics(metrics.method(currentMethodName)),
+    scheduled_us(0),
+    dispatched_us(0),
+    started_us(0),
+    finished_us(0),
+    rval_us(0),
+    queued(false),
+    job_id(++lastJobId),
+    throttle(progressThrottle) {
+  method_metrics->calls++;
+  // The async_hooks resource is the persistent object of the worker
+  Nan::HandleScope scope;
+  v8::Local<v8::Array> uids = Nan::New<v8::Array>(this->ds_uids.size());
+  for (size_t i = 0; i < this->ds_uids.size(); i++)
+    Nan::Set(uids, i, Nan::New<v8::Number>(static_cast<double>(this->ds_uids[i])));
+  SaveToPersistent("method", Nan::New(method_metrics->name).ToLocalChecked());
+  SaveToPersistent("datasets", uids);
+}
+
+// Called on the main thread after the callback
+GDALAsyncWorkerBase::~GDALAsyncWorkerBase() {
+  if (scheduled_us != 0) metrics.completed(ds_uids);
+}
+
+// The latest progress notification is delivered before the result
+void GDALAsyncWorkerBase::WorkComplete() {
+  WorkProgress();
+  GDALAsyncProgressWorker::WorkComplete();
+  publish(JobEvent::End);
+}
+
+// Called on the main thread with a HandleScope
+v8::Local<v8::Value> GDALAsyncWorkerBase::ErrorValue() {
+  v8::Local<v8::Value> err = Nan::Error(ErrorMessage());
+  if (aborted()) Nan::Set(err.As<v8::Object>(), Nan::New("code").ToLocalChecked(), Nan::New(CPLE_UserInterrupt));
+  return err;
+}
+
+// The message is built only when the channel has subscribers,
+// all the durations are in milliseconds
+void GDALAsyncWorkerBase::publish(JobEvent event) {
+  if (!diagnostics.active(event)) return;
+  Nan::HandleScope scope;
+  v8::Local<v8::Object> msg = Nan::New<v8::Object>();
+  v8::Local<v8::Array> uids = Nan::New<v8::Array>(ds_uids.size());
+  for (size_t i = 0; i < ds_uids.size(); i++) Nan::Set(uids, i, Nan::New<v8::Number>(static_cast<double>(ds_uids[i])));
+  Nan::Set(msg, Nan::New("id").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(job_id)));
+  Nan::Set(msg, Nan::New("method").ToLocalChecked(), Nan::New(method_metrics->name).ToLocalChecked());
+  Nan::Set(msg, Nan::New("datasets").ToLocalChecked(), uids);
+  if (event != JobEvent::Start) {
+    Nan::Set(
+      msg,
+      Nan::New("lockWait").ToLocalChecked(),
+      Nan::New<v8::Number>(static_cast<double>(dispatched_us - scheduled_us) / 1000));
+  }
+  if (event == JobEvent::End) {
+    Nan::Set(
+      msg,
+      Nan::New("queueWait").ToLocalChecked(),
+      Nan::New<v8::Number>(static_cast<double>(started_us - dispatched_us) / 1000));
+    Nan::Set(
+      msg,
+      Nan::New("execute").ToLocalChecked(),
+      Nan::New<v8::Number>(static_cast<double>(finished_us - started_us) / 1000));
+    Nan::Set(msg, Nan::New("rval").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(rval_us) / 1000));
+    if (ErrorMessage() != nullptr) Nan::Set(msg, Nan::New("error").ToLocalChecked(), SafeString::New(ErrorMessage()));
+  }
+  diagnostics.publish(event, msg);
+}
+
+AsyncCompletion::AsyncCompletion() : lock(), idle(), done(), executing(0), in_flight(0), complete(nullptr) {
+}
+
+// Called on the main thread when the module is loaded
+void AsyncCompletion::init(uv_loop_t *loop) {
+  complete = new uv_async_t;
+  uv_async_init(loop, complete, onComplete);
+  // The thread pool keeps the event loop alive only while it has running jobs
+  uv_unref(reinterpret_cast<uv_handle_t *>(complete));
+}
+
+// Called on the main thread after the event loop has exited, the jobs of this
+// isolate that are still in the thread pool must finish before the handle is closed
+// JS cannot run anymore, the completed jobs are destroyed without calling back
+void AsyncCompletion::shutdown() {
+  if (complete == nullptr) return;
+  std::deque<Nan::AsyncWorker *> finished;
+  {
+    std::unique_lock<std::mutex> guard(lock);
+    idle.wait(guard, [this]() { return executing == 0; });
+    finished.swap(done);
+  }
+  for (Nan::AsyncWorker *worker : finished) worker->Destroy();
+  in_flight = 0;
+  uv_close(reinterpret_cast<uv_handle_t *>(complete), [](uv_handle_t *handle) {
+    delete reinterpret_cast<uv_async_t *>(handle);
+  });
+  complete = nullptr;
+}
+
+void AsyncCompletion::started() {
+  if (in_flight++ == 0) uv_ref(reinterpret_cast<uv_handle_t *>(complete));
+  std::lock_guard<std::mutex> guard(lock);
+  executing++;
+}
+
+void AsyncCompletion::finished(Nan::AsyncWorker *worker) {
+  std::lock_guard<std::mutex> guard(lock);
+  done.push_back(worker);
+  uv_async_send(complete);
+  if (--executing == 0) idle.notify_all();
+}
+
+// Back on the main thread with the JS world not running
+void AsyncCompletion::onComplete(uv_async_t *) {
+  std::deque<Nan::AsyncWorker *> finished;
+  {
+    std::lock_guard<std::mutex> guard(async_completion.lock);
+    finished.swap(async_completion.done);
+  }
+  for (Nan::AsyncWorker *worker : finished) {
+    worker->WorkComplete();
+    worker->Destroy();
+    if (--async_completion.in_flight == 0) uv_unref(reinterpret_cast<uv_handle_t *>(async_completion.complete));
+  }
+}
+
+// Serializes the starting and the stopping of the threads
+static std::mutex poolLifecycle;
+
+AsyncThreadPool::AsyncThreadPool()
+  : lock(),
+    io_ready(),
+    cpu_ready(),
+    io_jobs(),
+    cpu_jobs(),
+    threads(),
+    io_threads(4),
+    cpu_threads(std::max(std::thread::hardware_concurrency(), 1u)),
+    stopping(false),
+    users(0) {
+}
+
+void AsyncThreadPool::attach() {
+  std::lock_guard<std::mutex> lifecycle(poolLifecycle);
+  std::lock_guard<std::mutex> guard(lock);
+  users++;
 }
 
-GDALProgressInfo::GDALProgressInfo(const GDALProgressInfo &o) : complete(o.complete), message(o.message) {
+// The last isolate stops the threads, once all of its jobs have completed
+void AsyncThreadPool::detach() {
+  std::lock_guard<std::mutex> lifecycle(poolLifecycle);
+  std::vector<std::thread> stopped;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (--users > 0) return;
+    stopping = true;
+    stopped.swap(threads);
+  }
+  io_ready.notify_all();
+  cpu_ready.notify_all();
+  for (auto &t : stopped) t.join();
+  std::lock_guard<std::mutex> guard(lock);
+  stopping = false;
 }
 
-GDALProgressInfo::GDALProgressInfo() : complete(0), message(nullptr) {
+unsigned AsyncThreadPool::size(AsyncLane lane) {
+  std::lock_guard<std::mutex> guard(lock);
+  return lane == AsyncLane::CPU ? cpu_threads : io_threads;
+}
+
+// The size can be changed only before the first async job of the process, the same way
+// UV_THREADPOOL_SIZE is read only once by libuv
+void AsyncThreadPool::resize(AsyncLane lane, unsigned size) {
+  std::lock_guard<std::mutex> guard(lock);
+  if (threads.size() > 0) throw "The thread pool size cannot be changed after the first asynchronous operation";
+  if (size < 1) throw "The thread pool must have at least one thread";
+  if (lane == AsyncLane::CPU)
+    cpu_threads = size;
+  else
+    io_threads = size;
+}
+
+void AsyncThreadPool::queue(Nan::AsyncWorker *worker, AsyncLane lane, AsyncCompletion *target) {
+  target->started();
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (threads.size() == 0) {
+      for (unsigned i = 0; i < io_threads; i++) threads.emplace_back(&AsyncThreadPool::work, this, AsyncLane::IO);
+      for (unsigned i = 0; i < cpu_threads; i++) threads.emplace_back(&AsyncThreadPool::work, this, AsyncLane::CPU);
+    }
+    if (lane == AsyncLane::CPU)
+      cpu_jobs.push_back({worker, target});
+    else
+      io_jobs.push_back({worker, target});
+  }
+  // An idle CPU thread can pick an I/O job if all the I/O threads are busy
+  if (lane == AsyncLane::IO) io_ready.notify_one();
+  cpu_ready.notify_one();
+}
+
+// The main loop of a worker thread
+void AsyncThreadPool::work(AsyncLane lane) {
+  std::unique_lock<std::mutex> guard(lock);
+  while (true) {
+    Job job;
+    if (lane == AsyncLane::CPU && !cpu_jobs.empty()) {
+      job = cpu_jobs.front();
+      cpu_jobs.pop_front();
+    } else if (!io_jobs.empty()) {
+      job = io_jobs.front();
+      io_jobs.pop_front();
+    } else if (stopping) {
+      return;
+    } else {
+      (lane == AsyncLane::CPU ? cpu_ready : io_ready).wait(guard);
+      continue;
+    }
+
+    guard.unlock();
+    job.worker->Execute();
+    job.target->finished(job.worker);
+    guard.lock();
+  }
+}
+
+AsyncScheduler::AsyncScheduler() : wakeup(nullptr), queues(), queued(0), locked() {
+}
+
+// Called on the main thread when the module is loaded
+void AsyncScheduler::init(uv_loop_t *loop) {
+  wakeup = new uv_async_t;
+  uv_async_init(loop, wakeup, onWakeup);
+  // The scheduler keeps the event loop alive only while it has waiting jobs
+  uv_unref(reinterpret_cast<uv_handle_t *>(wakeup));
+  object_store.onRelease(wakeup);
+}
+
+// Called on the main thread after the event loop has exited, the jobs still
+// waiting for their Datasets hold no locks and are destroyed without calling back
+void AsyncScheduler::shutdown() {
+  if (wakeup == nullptr) return;
+  object_store.onRelease(nullptr);
+  std::vector<GDALAsyncWorkerBase *> waiting;
+  for (auto const &q : queues)
+    for (GDALAsyncWorkerBase *worker : q.second)
+      if (std::find(waiting.begin(), waiting.end(), worker) == waiting.end()) waiting.push_back(worker);
+  queues.clear();
+  queued = 0;
+  // These are already in the thread pool
+  locked.clear();
+  for (GDALAsyncWorkerBase *worker : waiting) worker->Destroy();
+  uv_close(reinterpret_cast<uv_handle_t *>(wakeup), [](uv_handle_t *handle) {
+    delete reinterpret_cast<uv_async_t *>(handle);
+  });
+  wakeup = nullptr;
+}
+
+// Acquire the locks and send the job to the thread pool,
+// returns false if the job cannot be started at the moment
+bool AsyncScheduler::dispatch(GDALAsyncWorkerBase *worker) {
+  if (worker->aborted()) {
+    // The job fails in the worker thread without touching its Datasets
+    worker->ds_error = abortedError;
+  } else if (worker->ds_uids.size() > 0) {
+    try {
+      worker->ds_locks = object_store.tryLockDatasets(worker->ds_uids, worker->shared);
+      if (worker->ds_locks.size() == 0) return false;
+    } catch (const char *err) {
+      // The Dataset is already gone, the job will fail in the worker thread
+      worker->ds_error = err;
+    }
+  }
+  worker->dispatched_us = metricsNow();
+  int64_t lock_wait = worker->dispatched_us - worker->scheduled_us;
+  worker->method_metrics->lockWait.record(lock_wait);
+  metrics.dispatched(worker->ds_uids, worker->queued, lock_wait);
+  if (diagnostics.active(JobEvent::Lock)) locked.push_back(worker);
+  async_thread_pool.queue(worker, worker->lane, &async_completion);
+  return true;
+}
+
+// Enqueue a new job (main thread only)
+void AsyncScheduler::schedule(GDALAsyncWorkerBase *worker, AsyncLane lane, bool shared) {
+  worker->lane = lane;
+  worker->shared = shared;
+  worker->scheduled_us = metricsNow();
+  metrics.scheduled(worker->ds_uids);
+  // Never overtake a job that is already waiting on one of the Datasets
+  bool waiting = false;
+  for (long uid : worker->ds_uids)
+    if (queues.count(uid) > 0) waiting = true;
+  bool started = (!waiting || worker->aborted()) && dispatch(worker);
+  if (!started) {
+    for (long uid : worker->ds_uids) queues[uid].push_back(worker);
+    worker->queued = true;
+    metrics.queued(worker->ds_uids);
+    if (queued++ == 0) uv_ref(reinterpret_cast<uv_handle_t *>(wakeup));
+  }
+  worker->publish(JobEvent::Start);
+  publishLocked();
+}
+
+// The subscribers run JS code that can schedule other jobs, the events
+// are published once the queues are in a consistent state (main thread only)
+void AsyncScheduler::publishLocked() {
+  if (locked.empty()) return;
+  std::vector<GDALAsyncWorkerBase *> workers;
+  workers.swap(locked);
+  // The workers are destroyed only on the main thread, after this function returns
+  for (GDALAsyncWorkerBase *worker : workers) worker->publish(JobEvent::Lock);
+}
+
+// Wake up the scheduler from the main thread, drain() runs once the JS world is not running
+void AsyncScheduler::wake() {
+  if (wakeup != nullptr) uv_async_send(wakeup);
+}
+
+// Remove the aborted jobs from all the queues, they are sent to the
+// thread pool where they fail without acquiring their locks (main thread only)
+void AsyncScheduler::cancel() {
+  std::vector<GDALAsyncWorkerBase *> aborted;
+  for (auto q = queues.begin(); q != queues.end(); q++) {
+    for (auto w = q->second.begin(); w != q->second.end();) {
+      if ((*w)->aborted()) {
+        if (std::find(aborted.begin(), aborted.end(), *w) == aborted.end()) aborted.push_back(*w);
+        w = q->second.erase(w);
+      } else
+        w++;
+    }
+  }
+  for (GDALAsyncWorkerBase *worker : aborted) {
+    dispatch(worker);
+    if (--queued == 0) uv_unref(reinterpret_cast<uv_handle_t *>(wakeup));
+  }
+}
+
+// Start all the jobs that can be started (main thread only)
+void AsyncScheduler::drain() {
+  cancel();
+  bool progress = true;
+  while (progress && queued > 0) {
+    progress = false;
+    for (auto q = queues.begin(); q != queues.end(); q++) {
+      if (q->second.empty()) continue;
+      GDALAsyncWorkerBase *worker = q->second.front();
+      // A job using several Datasets must wait its turn on all of them
+      bool ready = true;
+      for (long uid : worker->ds_uids)
+        if (queues.at(uid).front() != worker) ready = false;
+      if (!ready || !dispatch(worker)) continue;
+
+      for (long uid : worker->ds_uids) queues.at(uid).pop_front();
+      if (--queued == 0) uv_unref(reinterpret_cast<uv_handle_t *>(wakeup));
+      progress = true;
+    }
+  }
+  for (auto q = queues.begin(); q != queues.end();) {
+    if (q->second.empty())
+      q = queues.erase(q);
+    else
+      q++;
+  }
+  publishLocked();
+}
+
+void AsyncScheduler::onWakeup(uv_async_t *) {
+  async_scheduler.drain();
+}
+
+GDALProgressInfo::GDALProgressInfo(double complete, const char *message)
+  : complete(complete), has_message(message != nullptr) {
+  if (message != nullptr)
+    CPLStrlcpy(this->message, message, sizeof(this->message));
+  else
+    this->message[0] = 0;
+}
+
+GDALProgressInfo::GDALProgressInfo() : complete(0), has_message(false) {
+  message[0] = 0;
 }
 
 // This is the GDAL form of the progress callback trampoline
@@ -19,10 +461,11 @@ GDALProgressInfo::GDALProgressInfo() : complete(0), message(nullptr) {
 // It is essentially a gateway between the GDAL world and Node.js/V8 world
 int ProgressTrampoline(double dfComplete, const char *pszMessage, void *pProgressArg) {
   GDALExecutionProgress *context = (GDALExecutionProgress *)pProgressArg;
-  // The dispatcher in async.hpp will delete it
-  GDALProgressInfo *info = new GDALProgressInfo(dfComplete, pszMessage);
+  if (context->aborted()) return 0;
+  // Installed only to poll the abort flag
+  if (!context->isReporting()) return 1;
   // Go to the dispatcher
-  context->Send(info);
+  context->Send(dfComplete, pszMessage);
   return 1;
 }
 
@@ -31,9 +474,36 @@ int ProgressTrampoline(double dfComplete, const char *pszMessage, void *pProgres
 // typedef GDALAsyncProgressWorker::ExecutionProgress GDALAsyncExecutionProgress;
 // GDALAsyncExecutionProgress is an instance of a NAN templated class, in this case
 // the AsyncWorker is the final owner of the progress_callback
-GDALExecutionProgress::GDALExecutionProgress(const GDALAsyncExecutionProgress *async) : async(async), sync(nullptr) {
+GDALExecutionProgress::GDALExecutionProgress(
+  const GDALAsyncExecutionProgress *async, bool reporting, AbortFlag abort, const ProgressThrottle &limits)
+  : async(async),
+    sync(nullptr),
+    reporting(reporting),
+    abort_flag(abort),
+    start(std::chrono::steady_clock::now()),
+    limits(limits),
+    lock(),
+    last_us(-1),
+    last_complete(0),
+    latest_complete(0),
+    pending(false),
+    has_message(false),
+    latest_message() {
 }
-GDALExecutionProgress::GDALExecutionProgress(const GDALSyncExecutionProgress *sync) : async(nullptr), sync(sync) {
+GDALExecutionProgress::GDALExecutionProgress(const GDALSyncExecutionProgress *sync)
+  : async(nullptr),
+    sync(sync),
+    reporting(sync->hasCallback()),
+    abort_flag(nullptr),
+    start(std::chrono::steady_clock::now()),
+    limits(progressThrottle),
+    lock(),
+    last_us(-1),
+    last_complete(0),
+    latest_complete(0),
+    pending(false),
+    has_message(false),
+    latest_message() {
 }
 
 GDALExecutionProgress::~GDALExecutionProgress() {
@@ -41,17 +511,60 @@ GDALExecutionProgress::~GDALExecutionProgress() {
   if (sync) delete sync;
 }
 
-// sync/async dispatcher
-void GDALExecutionProgress::Send(GDALProgressInfo *info) const {
-  auto infoHolder = std::unique_ptr<GDALProgressInfo>(info);
+// Must this notification be delivered now
+bool GDALExecutionProgress::due(double complete, int64_t now) const {
+  int64_t last = last_us.load();
+  if (last < 0) return true;
+  if (complete >= 1) return last_complete.load() < 1;
+  return now - last >= limits.interval_us && complete - last_complete.load() >= limits.delta;
+}
+
+// Delivers the latest notification (called with the lock held)
+void GDALExecutionProgress::deliver() const {
+  pending = false;
+  GDALProgressInfo info(latest_complete.load(), latest_message.text());
+  last_complete = info.complete;
   // async mode -> we are in an aux thread, we can't go back to JS
   // we must enqueue a job on the event loop and wait for the JS world to stop
-  // the enqueuing is in Nan::AsyncWorker, then once the JS world is not running
+  // the enqueuing is in Nan::AsyncWorker (which copies the data and keeps only the
+  // latest one), then once the JS world is not running
   // AsyncWorker::HandleProgressCallback will get invoked on the main thread
-  if (async) async->Send(info, 1);
+  // The copy is a heap allocation, the throttle limits it to one per interval
+  if (async) async->Send(&info, 1);
   // sync mode -> the JS world is not running, we can go back directly
   // this code is below
-  if (sync) sync->Send(info);
+  if (sync) sync->Send(&info);
+}
+
+// sync/async dispatcher
+void GDALExecutionProgress::Send(double complete, const char *message) const {
+  int64_t now =
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  if (!due(complete, now)) {
+    // Most notifications end here without taking the lock
+    if (message != nullptr || has_message) {
+      std::lock_guard<std::mutex> guard(lock);
+      latest_message = GDALProgressInfo(complete, message);
+      has_message = message != nullptr;
+    }
+    latest_complete = complete;
+    pending = true;
+    return;
+  }
+  std::lock_guard<std::mutex> guard(lock);
+  latest_message = GDALProgressInfo(complete, message);
+  has_message = message != nullptr;
+  latest_complete = complete;
+  pending = true;
+  // Another thread can have delivered a notification in the meantime
+  if (!due(complete, now)) return;
+  last_us = now;
+  deliver();
+}
+
+void GDALExecutionProgress::Flush() const {
+  std::lock_guard<std::mutex> guard(lock);
+  if (pending) deliver();
 }
 
 // This is the sync execution context, it is the final owner of the progress_callback
@@ -61,9 +574,9 @@ GDALSyncExecutionProgress::~GDALSyncExecutionProgress() {
 };
 
 // Going back to JS in sync mode
-void GDALSyncExecutionProgress::Send(GDALProgressInfo *info) const {
+void GDALSyncExecutionProgress::Send(const GDALProgressInfo *info) const {
   Nan::HandleScope scope;
-  v8::Local<v8::Value> argv[] = {Nan::New<Number>(info->complete), SafeString::New(info->message)};
+  v8::Local<v8::Value> argv[] = {Nan::New<Number>(info->complete), SafeString::New(info->text())};
   Nan::TryCatch try_catch;
   Nan::Call(progress_callback->GetFunction(), Nan::GetCurrentContext()->Global(), 2, argv);
   if (try_catch.HasCaught()) throw "sync progress callback exception";
@@ -1,23 +1,33 @@
 #ifndef __NODE_GDAL_ASYNC_WORKER_H__
 #define __NODE_GDAL_ASYNC_WORKER_H__
 
+#include <string>
 #include <thread>
 #include <functional>
 #include <chrono>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
 #include "nan-wrapper.h"
 #include "gdal_common.hpp"
+#include "utils/metrics.hpp"
+#include "utils/diagnostics.hpp"
 
 namespace node_gdal {
 
-// The id of the main V8 thread
-extern std::thread::id mainV8ThreadId;
+// The id of the thread of the current V8 isolate, unset in the worker threads
+extern thread_local std::thread::id mainV8ThreadId;
 
 // This generates method definitions for 2 methods: sync and async version and a hidden common block
+// The name of the method is used to label the jobs in gdal.metrics()
 #define GDAL_ASYNCABLE_DEFINE(method)                                                                                  \
   NAN_METHOD(method) {                                                                                                 \
+    MethodNameScope name_scope(#method);                                                                               \
     method##_do(info, false);                                                                                          \
   }                                                                                                                    \
   NAN_METHOD(method##Async) {                                                                                          \
+    MethodNameScope name_scope(#method);                                                                               \
     method##_do(info, true);                                                                                           \
   }                                                                                                                    \
   void method##_do(const Nan::FunctionCallbackInfo<v8::Value> &info, bool async)
@@ -25,9 +35,11 @@ extern std::thread::id mainV8ThreadId;
 // This generates getter definitions for 2 getters: sync and async version and a hidden common block
 #define GDAL_ASYNCABLE_GETTER_DEFINE(method)                                                                           \
   NAN_GETTER(method) {                                                                                                 \
+    MethodNameScope name_scope(#method);                                                                               \
     method##_do(property, info, false);                                                                                \
   }                                                                                                                    \
   NAN_GETTER(method##Async) {                                                                                          \
+    MethodNameScope name_scope(#method);                                                                               \
     method##_do(property, info, true);                                                                                 \
   }                                                                                                                    \
   Nan::NAN_GETTER_RETURN_TYPE method##_do(v8::Local<v8::String> property, Nan::NAN_GETTER_ARGS_TYPE info, bool async)
@@ -50,11 +62,18 @@ extern std::thread::id mainV8ThreadId;
   NAN_METHOD(method##Async);                                                                                           \
   void method##_do(const Nan::FunctionCallbackInfo<v8::Value> &info, bool async)
 
-#define GDAL_ASYNCABLE_TEMPLATE(method)                                                                                \
+// This generates method definitions inside a class template, klass::_className names the instantiation
+#define GDAL_ASYNCABLE_TEMPLATE(klass, method)                                                                         \
+  static const char *method##_name() {                                                                                 \
+    static const std::string name = std::string(klass::_className) + "::" #method;                                     \
+    return name.c_str();                                                                                               \
+  }                                                                                                                    \
   static NAN_METHOD(method) {                                                                                          \
+    MethodNameScope name_scope(method##_name());                                                                       \
     method##_do(info, false);                                                                                          \
   }                                                                                                                    \
   static NAN_METHOD(method##Async) {                                                                                   \
+    MethodNameScope name_scope(method##_name());                                                                       \
     method##_do(info, true);                                                                                           \
   }                                                                                                                    \
   static void method##_do(const Nan::FunctionCallbackInfo<v8::Value> &info, bool async)
@@ -80,61 +99,105 @@ extern std::thread::id mainV8ThreadId;
     return;                                                                                                            \
   }
 
+// The error of the jobs cancelled by their AbortSignal before reaching GDAL,
+// jobs aborted by the progress callback fail with the GDAL error (CPLE_UserInterrupt)
+static const char abortedError[] = "Operation aborted";
+
 static const char eventLoopWarning[] =
   "Synchronous method called while an asynchronous operation is running in the background, check node_modules/gdal-async/ASYNCIO.md, event loop blocked for ";
 // These constructors throw
 // Only one use case never throws: on the main thread
 // and after checking that the Dataset is alive
+//
+// The guard remembers the ObjectStore of the isolate that created it
+// as the locks can be released from a worker thread
 class AsyncGuard {
     public:
-  inline AsyncGuard() : lock(nullptr), locks(nullptr) {
+  inline AsyncGuard() : store(&object_store), lock(nullptr), locks(nullptr), shared(false) {
   }
-  inline AsyncGuard(long uid) : locks(nullptr) {
+  inline AsyncGuard(long uid) : store(&object_store), locks(nullptr), shared(false) {
     lock = object_store.lockDataset(uid);
   }
-  inline AsyncGuard(vector<long> uids) : lock(nullptr), locks(nullptr) {
+  inline AsyncGuard(vector<long> uids) : store(&object_store), lock(nullptr), locks(nullptr), shared(false) {
     if (uids.size() == 1)
       lock = object_store.lockDataset(uids[0]);
     else
       locks = make_shared<vector<AsyncLock>>(object_store.lockDatasets(uids));
   }
-  inline AsyncGuard(vector<long> uids, bool warning) : lock(nullptr), locks(nullptr) {
+  // A shared lock allows other read-only operations to run in parallel
+  // on Datasets that support it
+  inline AsyncGuard(vector<long> uids, bool warning, bool shared = false)
+    : store(&object_store), lock(nullptr), locks(nullptr), shared(shared) {
     if (uids.size() == 1) {
       if (uids[0] == 0) return;
-      lock = warning ? object_store.tryLockDataset(uids[0]) : object_store.lockDataset(uids[0]);
-      if (lock == nullptr) { MEASURE_EXECUTION_TIME(eventLoopWarning, lock = object_store.lockDataset(uids[0])); }
+      lock = warning ? object_store.tryLockDataset(uids[0], shared) : object_store.lockDataset(uids[0], shared);
+      if (lock == nullptr) {
+        MEASURE_EXECUTION_TIME(eventLoopWarning, lock = object_store.lockDataset(uids[0], shared));
+      }
     } else {
-      locks = warning ? make_shared<vector<AsyncLock>>(object_store.tryLockDatasets(uids))
-                      : make_shared<vector<AsyncLock>>(object_store.lockDatasets(uids));
+      locks = warning ? make_shared<vector<AsyncLock>>(object_store.tryLockDatasets(uids, shared))
+                      : make_shared<vector<AsyncLock>>(object_store.lockDatasets(uids, shared));
       if (locks->size() == 0) {
         MEASURE_EXECUTION_TIME(
-          eventLoopWarning, locks = make_shared<vector<AsyncLock>>(object_store.lockDatasets(uids)));
+          eventLoopWarning, locks = make_shared<vector<AsyncLock>>(object_store.lockDatasets(uids, shared)));
       }
     }
+    if (shared) checkoutHandles();
   }
   inline void acquire(long uid) {
     if (lock != nullptr) throw "Trying to acquire multiple locks";
-    lock = object_store.lockDataset(uid);
+    lock = store->lockDataset(uid);
+  }
+  // Adopts locks that have already been acquired (by the AsyncScheduler of the isolate that owns owner)
+  inline AsyncGuard(ObjectStore *owner) : store(owner), lock(nullptr), locks(nullptr), shared(false) {
+  }
+  inline void adopt(vector<AsyncLock> &&held, bool shared_locks) {
+    if (lock != nullptr || locks != nullptr) throw "Trying to acquire multiple locks";
+    if (held.size() > 0) locks = make_shared<vector<AsyncLock>>(std::move(held));
+    shared = shared_locks;
+    if (shared) checkoutHandles();
   }
   inline ~AsyncGuard() {
-    if (lock != nullptr) object_store.unlockDataset(lock);
-    if (locks != nullptr) object_store.unlockDatasets(*locks);
+    if (shared) returnHandles();
+    if (lock != nullptr) store->unlockDataset(lock, shared);
+    if (locks != nullptr) store->unlockDatasets(*locks, shared);
   }
 
     private:
+  ObjectStore *store;
   AsyncLock lock;
   shared_ptr<vector<AsyncLock>> locks;
+  bool shared;
+  // Pooled handles taken by this guard, each one is used instead of the primary handle of its Dataset
+  vector<std::pair<AsyncLockState *, GDALDataset *>> handles;
+  void checkoutHandles();
+  void returnHandles();
 };
 
-// Node.js NAN null initializes and trivially copies objects of this class without asking permission
+// These return the handle that the current thread must use
+// for a Dataset (or a band of a Dataset) opened with a pool of handles
+// (the object itself when the Dataset does not have a pool)
+GDALDataset *pooledDataset(GDALDataset *ds);
+GDALRasterBand *pooledBand(GDALRasterBand *band);
+
+// Only the bands of the Dataset itself have a pooled equivalent, read-only
+// jobs on any other band (overviews, masks) cannot share the lock
+inline bool isShareable(GDALRasterBand *band, GDALDataset *parent) {
+  return band->GetDataset() == parent && band->GetBand() > 0;
+}
+
+// Node.js NAN default constructs and copies objects of this class without asking permission
+// GDAL only lends the message for the duration of the callback, it is copied (and truncated)
 struct GDALProgressInfo {
   double complete;
-  const char *message;
+  bool has_message;
+  char message[128];
 
-  GDALProgressInfo(const GDALProgressInfo &o);
   GDALProgressInfo(double, const char *);
   GDALProgressInfo();
-  ~GDALProgressInfo() = default;
+  inline const char *text() const {
+    return has_message ? message : nullptr;
+  }
 };
 
 class GDALSyncExecutionProgress {
@@ -145,34 +208,275 @@ class GDALSyncExecutionProgress {
     public:
   GDALSyncExecutionProgress(Nan::Callback *);
   ~GDALSyncExecutionProgress();
-  void Send(GDALProgressInfo *) const;
+  void Send(const GDALProgressInfo *) const;
+  inline bool hasCallback() const {
+    return progress_callback != nullptr;
+  }
 };
 
 typedef std::function<v8::Local<v8::Value>(const char *)> GetFromPersistentFunc;
 typedef Nan::AsyncProgressWorkerBase<GDALProgressInfo> GDALAsyncProgressWorker;
 typedef GDALAsyncProgressWorker::ExecutionProgress GDALAsyncExecutionProgress;
 
+// The progress notifications are delivered to JS at most once every interval
+// and only when the progress has advanced by at least delta, the first and
+// the final (complete >= 1) notifications are always delivered
+//
+// A skipped notification is kept as the latest value, it is delivered by the
+// next notification that passes the throttle or when the job completes
+//
+// Each isolate has its own settings, the async jobs copy them when they are created
+struct ProgressThrottle {
+  int64_t interval_us;
+  double delta;
+};
+
+extern thread_local ProgressThrottle progressThrottle;
+
+// The abort flag of an async job, it lives in an Int32Array set by the AbortSignal
+// listener on the main thread and it is polled by the worker thread
+typedef const volatile int32_t *AbortFlag;
+
 // This an ExecutionContext that works both with Node.js' NAN ExecutionProgress when in async mode
 // and with GDALSyncExecutionContext when in sync mode
 class GDALExecutionProgress {
   // Only one of these is active at any given moment
   const GDALAsyncExecutionProgress *async;
   const GDALSyncExecutionProgress *sync;
+  // Is there a JS progress callback
+  bool reporting;
+  AbortFlag abort_flag;
+  const std::chrono::steady_clock::time_point start;
+  const ProgressThrottle limits;
+  // GDAL can report progress from several threads, the notifications that are
+  // skipped by the throttle only update the atomic slot below, the lock is taken
+  // only to deliver a notification (at most once per interval) or to copy a message
+  mutable std::mutex lock;
+  // The latest delivered notification
+  mutable std::atomic<int64_t> last_us;
+  mutable std::atomic<double> last_complete;
+  // The latest notification, pending if it has not been delivered
+  mutable std::atomic<double> latest_complete;
+  mutable std::atomic<bool> pending;
+  // The message of the latest notification, protected by the lock
+  mutable std::atomic<bool> has_message;
+  mutable GDALProgressInfo latest_message;
 
   GDALExecutionProgress() = delete;
+  bool due(double complete, int64_t now) const;
+  void deliver() const;
 
     public:
-  GDALExecutionProgress(const GDALAsyncExecutionProgress *);
+  GDALExecutionProgress(
+    const GDALAsyncExecutionProgress *, bool reporting, AbortFlag abort, const ProgressThrottle &limits);
   GDALExecutionProgress(const GDALSyncExecutionProgress *);
   ~GDALExecutionProgress();
-  void Send(GDALProgressInfo *info) const;
+  void Send(double complete, const char *message) const;
+  // Delivers the latest skipped notification, called when the job has completed
+  void Flush() const;
+  // The trampoline must be given to GDAL when there is a JS progress callback
+  // or when the job can be aborted
+  inline bool enabled() const {
+    return reporting || abort_flag != nullptr;
+  }
+  inline bool aborted() const {
+    return abort_flag != nullptr && *abort_flag != 0;
+  }
+  inline bool isReporting() const {
+    return reporting;
+  }
 };
 
 // This is the progress callback trampoline
 // It can be invoked both in the main thread (in sync mode) or in auxillary thread (in async mode)
 // It is essentially a gateway between the GDAL world and Node.js/V8 world
+// It returns 0 to make GDAL stop when the job has been aborted
 int ProgressTrampoline(double dfComplete, const char *pszMessage, void *pProgressArg);
 
+class GDALAsyncWorkerBase;
+
+// I/O-bound jobs (reading, writing, metadata) and CPU-bound jobs (warping,
+// polygonizing, computing statistics, geometry operations) run in separate lanes
+enum class AsyncLane { IO, CPU };
+
+//
+// This is the per-isolate end of the thread pool
+//
+// The completed jobs are sent back to the event loop that created
+// them through a uv_async handle
+//
+class AsyncCompletion {
+    public:
+  AsyncCompletion();
+  void init(uv_loop_t *loop);
+  void shutdown();
+  // Called on the main thread when a job is given to the thread pool
+  void started();
+  // Called on the worker thread when a job has been executed
+  void finished(Nan::AsyncWorker *worker);
+
+    private:
+  std::mutex lock;
+  std::condition_variable idle;
+  std::deque<Nan::AsyncWorker *> done;
+  // The jobs that are in the thread pool and have not been executed yet
+  size_t executing;
+  // main thread only
+  size_t in_flight;
+  uv_async_t *complete;
+
+  static void onComplete(uv_async_t *handle);
+};
+
+extern thread_local AsyncCompletion async_completion;
+
+//
+// This is the thread pool that runs the async jobs,
+// it is independent of the libuv thread pool used by Node.js itself
+//
+// It has one set of threads for each lane:
+// * the I/O threads run only I/O-bound jobs
+// * the CPU threads run CPU-bound jobs and steal I/O-bound jobs when idle
+// This way a long-running warp can never delay a latency-sensitive read
+//
+// There is only one thread pool in the process, shared by the main thread and
+// all the worker_threads, so that loading the module in many worker_threads does
+// not multiply the number of threads - each job completes on the event loop of
+// the isolate that created it
+//
+// The threads are started by the first async job and they are stopped when the
+// last isolate using the module exits
+//
+class AsyncThreadPool {
+    public:
+  AsyncThreadPool();
+  // Called by every isolate that loads the module and when it exits
+  void attach();
+  void detach();
+  // Enqueue a job whose locks have already been acquired (main thread of its isolate)
+  void queue(Nan::AsyncWorker *worker, AsyncLane lane, AsyncCompletion *target);
+  unsigned size(AsyncLane lane);
+  void resize(AsyncLane lane, unsigned threads);
+
+    private:
+  struct Job {
+    Nan::AsyncWorker *worker;
+    AsyncCompletion *target;
+  };
+
+  std::mutex lock;
+  std::condition_variable io_ready;
+  std::condition_variable cpu_ready;
+  std::deque<Job> io_jobs;
+  std::deque<Job> cpu_jobs;
+  std::vector<std::thread> threads;
+  unsigned io_threads;
+  unsigned cpu_threads;
+  bool stopping;
+  // The isolates that have loaded the module
+  unsigned users;
+
+  void work(AsyncLane lane);
+};
+
+extern AsyncThreadPool async_thread_pool;
+
+//
+// This is the async job scheduler
+//
+// It lives on the main thread and keeps a FIFO queue per Dataset uid
+// A job is handed to the thread pool only after all of its Dataset locks
+// have been acquired, so a worker thread never sleeps waiting for a Dataset
+// while occupying a slot in the pool
+//
+// Jobs that cannot be started are queued on every Dataset they use and they
+// are dispatched once they reach the head of all their queues and their locks
+// are free - this keeps the ordering on each Dataset and avoids deadlocks
+//
+// Consecutive read-only jobs share the lock of a Dataset that supports parallel
+// reads, a job that needs an exclusive lock waits for all of them to finish
+// and blocks all the jobs behind it
+//
+// The ObjectStore wakes the scheduler every time it releases a Dataset lock
+//
+class AsyncScheduler {
+    public:
+  AsyncScheduler();
+  void init(uv_loop_t *loop);
+  void shutdown();
+  void schedule(GDALAsyncWorkerBase *worker, AsyncLane lane, bool shared);
+  // Called when an AbortSignal fires, the aborted jobs are removed from the queues
+  void wake();
+
+    private:
+  uv_async_t *wakeup;
+  std::map<long, std::deque<GDALAsyncWorkerBase *>> queues;
+  size_t queued;
+  // The dispatched jobs whose diagnostics_channel event has not been published yet
+  std::vector<GDALAsyncWorkerBase *> locked;
+
+  bool dispatch(GDALAsyncWorkerBase *worker);
+  void publishLocked();
+  void cancel();
+  void drain();
+  static void onWakeup(uv_async_t *handle);
+};
+
+extern thread_local AsyncScheduler async_scheduler;
+
+//
+// This is the non-templated part of the async worker
+// It carries the Dataset locks from the scheduler to the worker thread
+//
+class GDALAsyncWorkerBase : public GDALAsyncProgressWorker {
+  friend class AsyncScheduler;
+
+    protected:
+  // The Datasets used by this job: sorted, without duplicates and without 0
+  const std::vector<long> ds_uids;
+  // The locks acquired by the scheduler on behalf of this job
+  std::vector<AsyncLock> ds_locks;
+  // Set by the scheduler if the locks cannot be acquired (ie the Dataset is gone)
+  const char *ds_error;
+  // The ObjectStore of the isolate that created this job
+  ObjectStore *store;
+  AsyncLane lane;
+  // Read-only jobs share the Dataset locks
+  bool shared;
+  // Set when the job was given an AbortSignal
+  AbortFlag abort_flag;
+  // The metrics of the method that created this job
+  MethodMetrics *method_metrics;
+  // When the job was given to the scheduler and to the thread pool,
+  // when it ran and how long it took to produce its result
+  int64_t scheduled_us;
+  int64_t dispatched_us;
+  int64_t started_us;
+  int64_t finished_us;
+  int64_t rval_us;
+  // Did the job have to wait in the queues of its Datasets
+  bool queued;
+  // Identifies the job in the diagnostics_channel messages
+  const uint64_t job_id;
+  // The progress throttling settings of the isolate when the job was created
+  const ProgressThrottle throttle;
+
+  void publish(JobEvent event);
+
+    public:
+  GDALAsyncWorkerBase(Nan::Callback *resultCallback, const std::vector<long> &ds_uids);
+  ~GDALAsyncWorkerBase();
+  virtual void WorkComplete();
+  inline void setAbortFlag(AbortFlag flag) {
+    abort_flag = flag;
+  }
+  inline bool aborted() const {
+    return abort_flag != nullptr && *abort_flag != 0;
+  }
+  // The error of a failed job, it has the code CPLE_UserInterrupt when the job was aborted
+  v8::Local<v8::Value> ErrorValue();
+};
+
 //
 // This is the common class for handling async operations
 // It has two subclasses: GDALCallbackWorker and GDALPromiseWorker
@@ -185,7 +489,7 @@ int ProgressTrampoline(double dfComplete, const char *pszMessage, void *pProgres
 // JS-visible object creation is possible only in the main thread while
 // ths JS world is not running
 //
-template <class GDALType> class GDALAsyncWorker : public GDALAsyncProgressWorker {
+template <class GDALType> class GDALAsyncWorker : public GDALAsyncWorkerBase {
     public:
   typedef std::function<GDALType(const GDALExecutionProgress &)> GDALMainFunc;
   typedef std::function<v8::Local<v8::Value>(const GDALType, const GetFromPersistentFunc &)> GDALRValFunc;
@@ -194,7 +498,6 @@ template <class GDALType> class GDALAsyncWorker : public GDALAsyncProgressWorker
   Nan::Callback *progressCallback;
   const GDALMainFunc doit;
   const GDALRValFunc rval;
-  const std::vector<long> ds_uids;
   GDALType raw;
 
     public:
@@ -221,32 +524,48 @@ GDALAsyncWorker<GDALType>::GDALAsyncWorker(
   const GDALRValFunc &rval,
   const std::map<std::string, v8::Local<v8::Object>> &objects,
   const std::vector<long> &ds_uids)
-  : GDALAsyncProgressWorker(resultCallback, "node-gdal:GDALAsyncWorker"),
+  : GDALAsyncWorkerBase(resultCallback, ds_uids),
     progressCallback(progressCallback),
     // These members are not references! These functions must be copied
     // as they will be executed in async context!
     doit(doit),
-    rval(rval),
-    ds_uids(ds_uids) {
+    rval(rval) {
   // Main thread with the JS world is not running
   // Get persistent handles
   for (auto i = objects.begin(); i != objects.end(); i++) SaveToPersistent(i->first.c_str(), i->second);
-  for (auto i = ds_uids.begin(); i != ds_uids.end(); i++)
-    if (*i != 0) SaveToPersistent(("ds" + std::to_string(*i)).c_str(), object_store.get<GDALDataset *>(*i));
+  for (auto i = this->ds_uids.begin(); i != this->ds_uids.end(); i++)
+    SaveToPersistent(("ds" + std::to_string(*i)).c_str(), object_store.get<GDALDataset *>(*i));
 }
 
 template <class GDALType> Local<Value> GDALAsyncWorker<GDALType>::ProduceRVal() {
-  return rval(raw, [this](const char *key) { return this->GetFromPersistent(key); });
+  int64_t start = metricsNow();
+  Local<Value> r = rval(raw, [this](const char *key) { return this->GetFromPersistent(key); });
+  rval_us = metricsNow() - start;
+  method_metrics->rval.record(rval_us);
+  return r;
 }
 
 template <class GDALType> void GDALAsyncWorker<GDALType>::Execute(const ExecutionProgress &progress) {
   // Aux thread with the JS world running
   // V8 objects are not acessible here
+  started_us = metricsNow();
+  method_metrics->queueWait.record(started_us - dispatched_us);
   try {
-    GDALExecutionProgress executionProgress(&progress);
-    AsyncGuard lock(ds_uids);
+    if (ds_error != nullptr) throw ds_error;
+    // Aborted while waiting for a thread
+    if (aborted()) throw abortedError;
+    GDALExecutionProgress executionProgress(&progress, progressCallback != nullptr, abort_flag, throttle);
+    // The scheduler has already acquired the locks, they are released when leaving this block
+    AsyncGuard lock(store);
+    lock.adopt(std::move(ds_locks), shared);
     raw = doit(executionProgress);
-  } catch (const char *err) { this->SetErrorMessage(err); }
+    executionProgress.Flush();
+  } catch (const char *err) {
+    this->SetErrorMessage(err);
+    method_metrics->errors++;
+  }
+  finished_us = metricsNow();
+  method_metrics->execute.record(finished_us - started_us);
 }
 
 template <class GDALType> GDALAsyncWorker<GDALType>::~GDALAsyncWorker() {
@@ -265,7 +584,7 @@ void GDALAsyncWorker<GDALType>::HandleProgressCallback(const GDALProgressInfo *d
   // Send only the last one to JS
   const GDALProgressInfo *to_send = data + (count - 1);
   if (data != nullptr && count > 0) {
-    v8::Local<v8::Value> argv[] = {Nan::New<Number>(to_send->complete), SafeString::New(to_send->message)};
+    v8::Local<v8::Value> argv[] = {Nan::New<Number>(to_send->complete), SafeString::New(to_send->text())};
     Nan::TryCatch try_catch;
     progressCallback->Call(2, argv, this->async_resource);
     if (try_catch.HasCaught()) this->SetErrorMessage("async progress callback exception");
@@ -294,7 +613,7 @@ template <class GDALType> void GDALCallbackWorker<GDALType>::HandleOKCallback()
 template <class GDALType> void GDALCallbackWorker<GDALType>::HandleErrorCallback() {
   // Back to the main thread with the JS world not running
   Nan::HandleScope scope;
-  v8::Local<v8::Value> argv[] = {Nan::Error(this->ErrorMessage())};
+  v8::Local<v8::Value> argv[] = {this->ErrorValue()};
   this->callback->Call(1, argv, this->async_resource);
 }
 
@@ -350,7 +669,7 @@ template <class GDALType> void GDALPromiseWorker<GDALType>::HandleErrorCallback(
   Nan::HandleScope scope;
   v8::Local<v8::Context> context = Nan::New(*context_handle);
   v8::Local<v8::Promise::Resolver> resolver = Nan::New(*resolver_handle);
-  resolver->Reject(context, Nan::Error(this->ErrorMessage())).FromJust();
+  resolver->Reject(context, this->ErrorValue()).FromJust();
 }
 
 template <class GDALType> GDALPromiseWorker<GDALType>::~GDALPromiseWorker() {
@@ -391,10 +710,30 @@ template <class GDALType> class GDALAsyncableJob {
   // This is the lambda that produces the JS return object from the <GDALType> object
   GDALRValFunc rval;
   Nan::Callback *progress;
-
-  GDALAsyncableJob(long ds_uid) : main(), rval(), progress(nullptr), persistent(), ds_uids({ds_uid}), autoIndex(0){};
+  // The thread pool lane, jobs that do not spend most of their time in I/O should use AsyncLane::CPU
+  AsyncLane lane;
+  // Jobs that only read from their Datasets can set this to run in parallel with other
+  // read-only jobs when the Dataset supports it
+  bool shared;
+
+  GDALAsyncableJob(long ds_uid)
+    : main(),
+      rval(),
+      progress(nullptr),
+      lane(AsyncLane::IO),
+      shared(false),
+      persistent(),
+      ds_uids({ds_uid}),
+      autoIndex(0){};
   GDALAsyncableJob(std::vector<long> ds_uids)
-    : main(), rval(), progress(nullptr), persistent(), ds_uids(ds_uids), autoIndex(0){};
+    : main(),
+      rval(),
+      progress(nullptr),
+      lane(AsyncLane::IO),
+      shared(false),
+      persistent(),
+      ds_uids(ds_uids),
+      autoIndex(0){};
 
   inline void persist(const std::string &key, const v8::Local<v8::Object> &obj) {
     persistent[key] = obj;
@@ -419,17 +758,40 @@ template <class GDALType> class GDALAsyncableJob {
       if (progress) persist("progress_cb", progress->GetFunction());
       Nan::Callback *callback;
       NODE_ARG_CB(cb_arg, "callback", callback);
-      Nan::AsyncQueueWorker(new GDALCallbackWorker<GDALType>(callback, progress, main, rval, persistent, ds_uids));
+      // The JS wrapper places the abort flag of the AbortSignal after the callback
+      AbortFlag abort_flag = nullptr;
+      if (info.Length() > cb_arg + 1 && info[cb_arg + 1]->IsInt32Array()) {
+        Nan::TypedArrayContents<int32_t> flag(info[cb_arg + 1]);
+        if (flag.length() > 0) {
+          persist("abort", info[cb_arg + 1].As<v8::Object>());
+          abort_flag = *flag;
+        }
+      }
+      auto worker = new GDALCallbackWorker<GDALType>(callback, progress, main, rval, persistent, ds_uids);
+      worker->setAbortFlag(abort_flag);
+      async_scheduler.schedule(worker, lane, shared);
       return;
     }
+    MethodMetrics *stats = metrics.method(currentMethodName);
+    stats->calls++;
     try {
       GDALExecutionProgress executionProgress(new GDALSyncExecutionProgress(progress));
-      AsyncGuard lock(ds_uids, eventLoopWarn);
+      int64_t start = metricsNow();
+      AsyncGuard lock(ds_uids, eventLoopWarn, shared);
+      int64_t locked = metricsNow();
+      stats->lockWait.record(locked - start);
       GDALType obj = main(executionProgress);
+      executionProgress.Flush();
+      int64_t done = metricsNow();
+      stats->execute.record(done - locked);
       // rval is the user function that will create the returned value
       // we give it a lambda that can access the persistent storage created for this operation
       info.GetReturnValue().Set(rval(obj, [this](const char *key) { return this->persistent[key]; }));
-    } catch (const char *err) { Nan::ThrowError(err); }
+      stats->rval.record(metricsNow() - done);
+    } catch (const char *err) {
+      stats->errors++;
+      Nan::ThrowError(err);
+    }
   }
 
   void run(Nan::NAN_GETTER_ARGS_TYPE info, bool async) {
@@ -437,17 +799,29 @@ template <class GDALType> class GDALAsyncableJob {
     if (async) {
       auto worker = new GDALPromiseWorker<GDALType>(info, main, rval, persistent, ds_uids);
       info.GetReturnValue().Set(worker->Promise());
-      Nan::AsyncQueueWorker(worker);
+      async_scheduler.schedule(worker, lane, shared);
       return;
     }
+    MethodMetrics *stats = metrics.method(currentMethodName);
+    stats->calls++;
     try {
       GDALExecutionProgress executionProgress(new GDALSyncExecutionProgress(progress));
-      AsyncGuard lock(ds_uids, eventLoopWarn);
+      int64_t start = metricsNow();
+      AsyncGuard lock(ds_uids, eventLoopWarn, shared);
+      int64_t locked = metricsNow();
+      stats->lockWait.record(locked - start);
       GDALType obj = main(executionProgress);
+      executionProgress.Flush();
+      int64_t done = metricsNow();
+      stats->execute.record(done - locked);
       // rval is the user function that will create the returned value
       // we give it a lambda that can access the persistent storage created for this operation
       info.GetReturnValue().Set(rval(obj, [this](const char *key) { return this->persistent[key]; }));
-    } catch (const char *err) { Nan::ThrowError(err); }
+      stats->rval.record(metricsNow() - done);
+    } catch (const char *err) {
+      stats->errors++;
+      Nan::ThrowError(err);
+    }
   }
 
     private:
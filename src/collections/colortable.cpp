@@ -7,7 +7,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> ColorTable::constructor;
+thread_local Nan::Persistent<FunctionTemplate> ColorTable::constructor;
 
 void ColorTable::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -7,7 +7,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> DatasetBands::constructor;
+thread_local Nan::Persistent<FunctionTemplate> DatasetBands::constructor;
 
 void DatasetBands::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
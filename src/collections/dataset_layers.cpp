@@ -8,7 +8,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> DatasetLayers::constructor;
+thread_local Nan::Persistent<FunctionTemplate> DatasetLayers::constructor;
 
 void DatasetLayers::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -4,7 +4,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> FeatureFields::constructor;
+thread_local Nan::Persistent<FunctionTemplate> FeatureFields::constructor;
 
 void FeatureFields::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
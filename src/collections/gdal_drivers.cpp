@@ -4,7 +4,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> GDALDrivers::constructor;
+thread_local Nan::Persistent<FunctionTemplate> GDALDrivers::constructor;
 
 void GDALDrivers::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
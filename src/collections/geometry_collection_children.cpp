@@ -5,7 +5,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> GeometryCollectionChildren::constructor;
+thread_local Nan::Persistent<FunctionTemplate> GeometryCollectionChildren::constructor;
 
 void GeometryCollectionChildren::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
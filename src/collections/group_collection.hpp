@@ -96,7 +96,7 @@ class GroupCollection : public Nan::ObjectWrap {
     return 0;
   };
 
-  GDAL_ASYNCABLE_TEMPLATE(get) {
+  GDAL_ASYNCABLE_TEMPLATE(SELF, get) {
 
     Local<Object> parent_ds =
       Nan::GetPrivate(info.This(), Nan::New("parent_ds_").ToLocalChecked()).ToLocalChecked().As<Object>();
@@ -128,7 +128,7 @@ class GroupCollection : public Nan::ObjectWrap {
     job.run(info, async, 1);
   }
 
-  GDAL_ASYNCABLE_TEMPLATE(count) {
+  GDAL_ASYNCABLE_TEMPLATE(SELF, count) {
 
     Local<Object> parent_ds =
       Nan::GetPrivate(info.This(), Nan::New("parent_ds_").ToLocalChecked()).ToLocalChecked().As<Object>();
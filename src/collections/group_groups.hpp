@@ -24,7 +24,7 @@ namespace node_gdal {
 class GroupGroups : public GroupCollection<GroupGroups, GDALGroup, GDALGroup, Group, Group> {
     public:
   static constexpr const char *_className = "GroupGroups";
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static std::shared_ptr<GDALGroup> __get(std::shared_ptr<GDALGroup> parent, std::string const &name);
   static std::shared_ptr<GDALGroup> __get(std::shared_ptr<GDALGroup> parent, size_t idx);
   static std::vector<std::string> __getNames(std::shared_ptr<GDALGroup> parent);
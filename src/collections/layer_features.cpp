@@ -2,10 +2,11 @@
 #include "../gdal_common.hpp"
 #include "../gdal_feature.hpp"
 #include "../gdal_layer.hpp"
+#include "../utils/typed_array.hpp"
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> LayerFeatures::constructor;
+thread_local Nan::Persistent<FunctionTemplate> LayerFeatures::constructor;
 
 void LayerFeatures::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -22,6 +23,7 @@ void LayerFeatures::Initialize(Local<Object> target) {
   Nan__SetPrototypeAsyncableMethod(lcons, "first", first);
   Nan__SetPrototypeAsyncableMethod(lcons, "next", next);
   Nan__SetPrototypeAsyncableMethod(lcons, "remove", remove);
+  Nan__SetPrototypeAsyncableMethod(lcons, "readBatch", readBatch);
 
   ATTR_DONT_ENUM(lcons, "layer", layerGetter, READ_ONLY_SETTER);
 
@@ -486,6 +488,292 @@ GDAL_ASYNCABLE_DEFINE(LayerFeatures::remove) {
   return;
 }
 
+// A column of a FeatureBatch, the layout follows the Apache Arrow columnar format:
+// fixed-width values or variable-width values with offsets and a validity bitmap
+struct FeatureBatchColumn {
+  std::string name;
+  int field;
+  OGRFieldType field_type;
+  // Int32, Int64, Float64, Utf8 or Binary
+  const char *type;
+  std::vector<int32_t> int_values;
+  std::vector<int64_t> int64_values;
+  std::vector<double> double_values;
+  std::vector<uint8_t> data;
+  std::vector<int32_t> offsets;
+  std::vector<uint8_t> validity;
+};
+
+struct FeatureBatch {
+  size_t count;
+  std::vector<double> fids;
+  std::vector<FeatureBatchColumn> columns;
+  bool geometry;
+  FeatureBatchColumn geometries;
+};
+
+static inline void setValid(std::vector<uint8_t> &validity, size_t i) {
+  validity[i >> 3] |= static_cast<uint8_t>(1 << (i & 7));
+}
+
+// TypedArray::New has no 64-bit integer type as these are not GDAL raster types before GDAL 3.5
+static Local<Value> copyToBigInt64Array(const std::vector<int64_t> &src) {
+  Nan::EscapableHandleScope scope;
+  Local<ArrayBuffer> buffer = ArrayBuffer::New(Isolate::GetCurrent(), src.size() * sizeof(int64_t));
+  Local<BigInt64Array> array = BigInt64Array::New(buffer, 0, src.size());
+  if (src.size() > 0) {
+    Nan::TypedArrayContents<int64_t> contents(array);
+    memcpy(*contents, src.data(), src.size() * sizeof(int64_t));
+  }
+  return scope.Escape(array);
+}
+
+static Local<Object> columnToObject(const FeatureBatchColumn &col) {
+  Nan::EscapableHandleScope scope;
+  Local<Object> obj = Nan::New<Object>();
+  Nan::Set(obj, Nan::New("type").ToLocalChecked(), Nan::New(col.type).ToLocalChecked());
+  if (!strcmp(col.type, "Int32"))
+    Nan::Set(obj, Nan::New("values").ToLocalChecked(), TypedArray::Copy(GDT_Int32, col.int_values));
+  else if (!strcmp(col.type, "Int64"))
+    Nan::Set(obj, Nan::New("values").ToLocalChecked(), copyToBigInt64Array(col.int64_values));
+  else if (!strcmp(col.type, "Float64"))
+    Nan::Set(obj, Nan::New("values").ToLocalChecked(), TypedArray::Copy(GDT_Float64, col.double_values));
+  else {
+    Nan::Set(obj, Nan::New("values").ToLocalChecked(), TypedArray::Copy(GDT_Byte, col.data));
+    Nan::Set(obj, Nan::New("offsets").ToLocalChecked(), TypedArray::Copy(GDT_Int32, col.offsets));
+  }
+  Nan::Set(obj, Nan::New("validity").ToLocalChecked(), TypedArray::Copy(GDT_Byte, col.validity));
+  return scope.Escape(obj);
+}
+
+/**
+ * @typedef {object} FeatureBatchOptions
+ * @property {number} [batchSize=65536] Maximum number of features to read
+ * @property {string[]} [fields] Names of the fields to read, all the fields by default
+ * @property {string} [geometry="wkb"] `"wkb"` to read the geometries as WKB or `"none"` to skip them
+ */
+
+/**
+ * A column of a {@link FeatureBatch}, it uses the layout of the Apache Arrow columnar format.
+ *
+ * `Int32` columns (`Integer` fields), `Int64` columns (`Integer64` fields, in a `BigInt64Array`)
+ * and `Float64` columns (`Real` fields) have one value per feature in `values`.
+ *
+ * `Utf8` columns (all other fields) and `Binary` columns (`Binary` fields and the WKB geometries)
+ * have `count + 1` `offsets`, the value of the feature `i` is `values.subarray(offsets[i], offsets[i + 1])`.
+ * The `Utf8` values are the strings returned by GDAL for the field: dates are formatted
+ * as `YYYY/MM/DD HH:MM:SS` and lists as `(count:value,value,...)`, unlike in `feature.fields.toObject()`.
+ *
+ * `validity` is a bitmap with one bit per feature (LSB first), a cleared bit means a null value.
+ *
+ * @typedef {object} FeatureBatchColumn
+ * @property {string} type `"Int32"`, `"Int64"`, `"Float64"`, `"Utf8"` or `"Binary"`
+ * @property {Int32Array|BigInt64Array|Float64Array|Uint8Array} values
+ * @property {Int32Array} [offsets]
+ * @property {Uint8Array} validity
+ */
+
+/**
+ * @typedef {object} FeatureBatch
+ * @property {number} count Number of features in the batch
+ * @property {Float64Array} fid The FIDs, exact up to 2^53
+ * @property {Record<string, FeatureBatchColumn>} fields
+ * @property {FeatureBatchColumn} [geometry]
+ */
+
+/**
+ * Reads the next features of the layer into columns of `TypedArray`s.
+ *
+ * This is much faster than iterating over the features when scanning a large layer,
+ * as no {@link Feature} objects are created. It continues from the current position
+ * of `next()` and returns `null` when there are no more features.
+ *
+ * @example
+ *
+ * let batch;
+ * while ((batch = layer.features.readBatch({ fields: [ 'pop' ], geometry: 'none' }))) {
+ *   const pop = batch.fields.pop.values;
+ *   for (let i = 0; i < batch.count; i++) total += pop[i];
+ * }
+ *
+ * @method readBatch
+ * @instance
+ * @memberof LayerFeatures
+ * @param {FeatureBatchOptions} [options]
+ * @throws {Error}
+ * @return {FeatureBatch|null}
+ */
+
+/**
+ * Reads the next features of the layer into columns of `TypedArray`s.
+ *
+ * This is much faster than iterating over the features when scanning a large layer,
+ * as no {@link Feature} objects are created. It continues from the current position
+ * of `next()` and resolves with `null` when there are no more features.
+ * @async
+ *
+ * @method readBatchAsync
+ * @instance
+ * @memberof LayerFeatures
+ * @param {FeatureBatchOptions} [options]
+ * @param {callback<FeatureBatch|null>} [callback=undefined]
+ * @throws {Error}
+ * @return {Promise<FeatureBatch|null>}
+ */
+GDAL_ASYNCABLE_DEFINE(LayerFeatures::readBatch) {
+
+  Local<Object> parent =
+    Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+  Layer *layer = Nan::ObjectWrap::Unwrap<Layer>(parent);
+  if (!layer->isAlive()) {
+    Nan::ThrowError("Layer object already destroyed");
+    return;
+  }
+  OGRLayer *gdal_layer = layer->get();
+
+  Local<Object> options = Nan::New<Object>();
+  NODE_ARG_OBJECT_OPT(0, "options", options);
+
+  int batch_size = 65536;
+  NODE_INT_FROM_OBJ_OPT(options, "batchSize", batch_size);
+  if (batch_size < 1) {
+    Nan::ThrowRangeError("batchSize must be positive");
+    return;
+  }
+
+  std::string geometry = "wkb";
+  NODE_STR_FROM_OBJ_OPT(options, "geometry", geometry);
+  if (geometry != "wkb" && geometry != "none") {
+    Nan::ThrowError("geometry must be \"wkb\" or \"none\"");
+    return;
+  }
+
+  OGRFeatureDefn *defn = gdal_layer->GetLayerDefn();
+  std::vector<int> fields;
+  Local<Array> fields_array;
+  NODE_ARRAY_FROM_OBJ_OPT(options, "fields", fields_array);
+  if (!fields_array.IsEmpty()) {
+    for (unsigned i = 0; i < fields_array->Length(); i++) {
+      Local<Value> val = Nan::Get(fields_array, i).ToLocalChecked();
+      if (!val->IsString()) {
+        Nan::ThrowError("fields array must only contain strings");
+        return;
+      }
+      int field = defn->GetFieldIndex(*Nan::Utf8String(val));
+      if (field < 0) {
+        Nan::ThrowError((std::string("Specified field name does not exist: ") + *Nan::Utf8String(val)).c_str());
+        return;
+      }
+      fields.push_back(field);
+    }
+  } else {
+    for (int i = 0; i < defn->GetFieldCount(); i++) fields.push_back(i);
+  }
+
+  std::vector<FeatureBatchColumn> columns;
+  for (int field : fields) {
+    OGRFieldDefn *field_defn = defn->GetFieldDefn(field);
+    FeatureBatchColumn col;
+    col.name = field_defn->GetNameRef();
+    col.field = field;
+    col.field_type = field_defn->GetType();
+    switch (col.field_type) {
+      case OFTInteger: col.type = "Int32"; break;
+      case OFTInteger64: col.type = "Int64"; break;
+      case OFTReal: col.type = "Float64"; break;
+      case OFTBinary: col.type = "Binary"; break;
+      default: col.type = "Utf8"; break;
+    }
+    columns.push_back(std::move(col));
+  }
+
+  GDALAsyncableJob<std::shared_ptr<FeatureBatch>> job(layer->parent_uid);
+  job.persist(layer->handle());
+  job.main = [gdal_layer, batch_size, columns, geometry](const GDALExecutionProgress &) {
+    std::shared_ptr<FeatureBatch> batch = std::make_shared<FeatureBatch>();
+    batch->count = 0;
+    batch->columns = columns;
+    batch->geometry = geometry == "wkb";
+    batch->geometries.type = "Binary";
+    std::vector<FeatureBatchColumn *> all;
+    for (auto &col : batch->columns) all.push_back(&col);
+    if (batch->geometry) all.push_back(&batch->geometries);
+    for (auto col : all) {
+      if (!strcmp(col->type, "Utf8") || !strcmp(col->type, "Binary")) col->offsets.push_back(0);
+    }
+
+    CPLErrorReset();
+    OGRFeature *feature;
+    while (batch->count < static_cast<size_t>(batch_size) && (feature = gdal_layer->GetNextFeature()) != nullptr) {
+      size_t i = batch->count++;
+      if ((i & 7) == 0)
+        for (auto col : all) col->validity.push_back(0);
+
+      batch->fids.push_back(static_cast<double>(feature->GetFID()));
+      for (auto &col : batch->columns) {
+        bool valid = feature->IsFieldSetAndNotNull(col.field);
+        if (valid) setValid(col.validity, i);
+        switch (col.field_type) {
+          case OFTInteger: col.int_values.push_back(valid ? feature->GetFieldAsInteger(col.field) : 0); break;
+          case OFTInteger64:
+            col.int64_values.push_back(valid ? feature->GetFieldAsInteger64(col.field) : 0);
+            break;
+          case OFTReal: col.double_values.push_back(valid ? feature->GetFieldAsDouble(col.field) : 0); break;
+          case OFTBinary:
+            if (valid) {
+              int len;
+              GByte *bin = feature->GetFieldAsBinary(col.field, &len);
+              col.data.insert(col.data.end(), bin, bin + len);
+            }
+            col.offsets.push_back(static_cast<int32_t>(col.data.size()));
+            break;
+          default:
+            if (valid) {
+              const char *str = feature->GetFieldAsString(col.field);
+              col.data.insert(col.data.end(), str, str + strlen(str));
+            }
+            col.offsets.push_back(static_cast<int32_t>(col.data.size()));
+            break;
+        }
+      }
+
+      if (batch->geometry) {
+        FeatureBatchColumn &col = batch->geometries;
+        OGRGeometry *geom = feature->GetGeometryRef();
+        if (geom != nullptr) {
+          setValid(col.validity, i);
+          size_t start = col.data.size();
+          col.data.resize(start + geom->WkbSize());
+          geom->exportToWkb(wkbNDR, col.data.data() + start, wkbVariantIso);
+        }
+        col.offsets.push_back(static_cast<int32_t>(col.data.size()));
+      }
+
+      OGRFeature::DestroyFeature(feature);
+      for (auto col : all) {
+        if (col->data.size() > INT32_MAX) throw "Batch too large for 32-bit offsets, reduce batchSize";
+      }
+    }
+    if (CPLGetLastErrorType() == CE_Failure) throw CPLGetLastErrorMsg();
+    return batch;
+  };
+  job.rval = [](std::shared_ptr<FeatureBatch> batch, const GetFromPersistentFunc &) {
+    Nan::EscapableHandleScope scope;
+    if (batch->count == 0) return scope.Escape(Nan::Null().As<Value>());
+
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("count").ToLocalChecked(), Nan::New<Number>(static_cast<double>(batch->count)));
+    Nan::Set(result, Nan::New("fid").ToLocalChecked(), TypedArray::Copy(GDT_Float64, batch->fids));
+    Local<Object> fields = Nan::New<Object>();
+    for (const auto &col : batch->columns)
+      Nan::Set(fields, SafeString::New(col.name.c_str()), columnToObject(col));
+    Nan::Set(result, Nan::New("fields").ToLocalChecked(), fields);
+    if (batch->geometry) Nan::Set(result, Nan::New("geometry").ToLocalChecked(), columnToObject(batch->geometries));
+    return scope.Escape(result.As<Value>());
+  };
+  job.run(info, async, 1);
+}
+
 /**
  * Returns the parent layer.
  *
@@ -20,7 +20,7 @@ namespace node_gdal {
 
 class LayerFeatures : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
 
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
@@ -34,6 +34,7 @@ class LayerFeatures : public Nan::ObjectWrap {
   GDAL_ASYNCABLE_DECLARE(add);
   GDAL_ASYNCABLE_DECLARE(set);
   GDAL_ASYNCABLE_DECLARE(remove);
+  GDAL_ASYNCABLE_DECLARE(readBatch);
 
   static NAN_GETTER(layerGetter);
 
@@ -5,7 +5,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> LayerFields::constructor;
+thread_local Nan::Persistent<FunctionTemplate> LayerFields::constructor;
 
 void LayerFields::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -3,10 +3,14 @@
 #include "../geometry/gdal_geometry.hpp"
 #include "../geometry/gdal_linestring.hpp"
 #include "../geometry/gdal_point.hpp"
+#include "../utils/typed_array.hpp"
+
+#include <climits>
+#include <vector>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> LineStringPoints::constructor;
+thread_local Nan::Persistent<FunctionTemplate> LineStringPoints::constructor;
 
 void LineStringPoints::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -22,6 +26,8 @@ void LineStringPoints::Initialize(Local<Object> target) {
   Nan::SetPrototypeMethod(lcons, "add", add);
   Nan::SetPrototypeMethod(lcons, "reverse", reverse);
   Nan::SetPrototypeMethod(lcons, "resize", resize);
+  Nan::SetPrototypeMethod(lcons, "toFloat64Array", toFloat64Array);
+  Nan::SetPrototypeMethod(lcons, "setFromFloat64Array", setFromFloat64Array);
 
   Nan::Set(target, Nan::New("LineStringPoints").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
 
@@ -393,4 +399,129 @@ NAN_METHOD(LineStringPoints::add) {
   return;
 }
 
+int LineStringPoints::coordinateDims(OGRGeometry *geom) {
+  if (geom->IsMeasured()) return 4;
+  return geom->Is3D() ? 3 : 2;
+}
+
+void LineStringPoints::exportPoints(OGRSimpleCurve *curve, double *data, int dims) {
+  int stride = dims * sizeof(double);
+  curve->getPoints(
+    data,
+    stride,
+    data + 1,
+    stride,
+    dims > 2 ? data + 2 : nullptr,
+    stride,
+    dims > 3 ? data + 3 : nullptr,
+    stride);
+}
+
+/**
+ * @typedef {object} CoordinateArrayOptions
+ * @property {number} [dims] Number of values per point: 2 for `x, y`, 3 for `x, y, z` and 4 for `x, y, z, m`,
+ * by default the coordinate dimension of the geometry
+ */
+
+/**
+ * Returns the coordinates of all the points in a single `Float64Array`,
+ * interleaved as `[x0, y0, x1, y1, ...]` for 2 dimensions.
+ *
+ * The coordinates are copied in one operation without creating a `Point` for each point.
+ * The missing dimensions are filled with `0`.
+ *
+ * @example
+ *
+ * const xy = lineString.points.toFloat64Array({ dims: 2 });
+ *
+ * @method toFloat64Array
+ * @instance
+ * @memberof LineStringPoints
+ * @param {CoordinateArrayOptions} [options]
+ * @throws {Error}
+ * @return {Float64Array}
+ */
+NAN_METHOD(LineStringPoints::toFloat64Array) {
+
+  Local<Object> parent =
+    Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+  LineString *geom = Nan::ObjectWrap::Unwrap<LineString>(parent);
+
+  Local<Object> options = Nan::New<Object>();
+  NODE_ARG_OBJECT_OPT(0, "options", options);
+  int dims = coordinateDims(geom->get());
+  NODE_INT_FROM_OBJ_OPT(options, "dims", dims);
+  if (dims < 2 || dims > 4) {
+    Nan::ThrowRangeError("dims must be 2, 3 or 4");
+    return;
+  }
+
+  Local<Value> array = TypedArray::New(GDT_Float64, geom->get()->getNumPoints() * dims);
+  if (array.IsEmpty() || !array->IsObject()) return; // TypedArray::New threw an error
+  Nan::TypedArrayContents<double> data(array);
+  exportPoints(geom->get(), *data, dims);
+
+  info.GetReturnValue().Set(array);
+}
+
+/**
+ * Replaces all the points with the interleaved coordinates of a `Float64Array`,
+ * the geometry takes the coordinate dimension of the array.
+ *
+ * @example
+ *
+ * lineString.points.setFromFloat64Array(Float64Array.from([ 0, 0, 10, 0, 10, 10 ]), { dims: 2 });
+ *
+ * @method setFromFloat64Array
+ * @instance
+ * @memberof LineStringPoints
+ * @param {Float64Array} coordinates
+ * @param {CoordinateArrayOptions} [options]
+ * @throws {Error}
+ */
+NAN_METHOD(LineStringPoints::setFromFloat64Array) {
+
+  Local<Object> parent =
+    Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+  LineString *geom = Nan::ObjectWrap::Unwrap<LineString>(parent);
+
+  if (info.Length() < 1 || !info[0]->IsFloat64Array()) {
+    Nan::ThrowTypeError("coordinates must be a Float64Array");
+    return;
+  }
+  Local<Object> options = Nan::New<Object>();
+  NODE_ARG_OBJECT_OPT(1, "options", options);
+  int dims = coordinateDims(geom->get());
+  NODE_INT_FROM_OBJ_OPT(options, "dims", dims);
+  if (dims < 2 || dims > 4) {
+    Nan::ThrowRangeError("dims must be 2, 3 or 4");
+    return;
+  }
+
+  Nan::TypedArrayContents<double> data(info[0]);
+  if (data.length() % dims != 0 || data.length() / dims > INT_MAX) {
+    Nan::ThrowRangeError("The length of coordinates must be a multiple of dims");
+    return;
+  }
+  int n = static_cast<int>(data.length() / dims);
+
+  // setPoints() expects separate arrays
+  std::vector<double> x(n), y(n), z(dims > 2 ? n : 0), m(dims > 3 ? n : 0);
+  for (int i = 0; i < n; i++) {
+    const double *pt = *data + static_cast<size_t>(i) * dims;
+    x[i] = pt[0];
+    y[i] = pt[1];
+    if (dims > 2) z[i] = pt[2];
+    if (dims > 3) m[i] = pt[3];
+  }
+  // setPoints() drops the Z values when they are not given but it keeps the M values
+  if (dims < 4) geom->get()->setMeasured(FALSE);
+  if (dims == 2)
+    geom->get()->setPoints(n, x.data(), y.data());
+  else if (dims == 3)
+    geom->get()->setPoints(n, x.data(), y.data(), z.data());
+  else
+    geom->get()->setPoints(n, x.data(), y.data(), z.data(), m.data());
+}
+
 } // namespace node_gdal
@@ -10,6 +10,7 @@
 
 // gdal
 #include <gdal_priv.h>
+#include <ogr_geometry.h>
 
 using namespace v8;
 using namespace node;
@@ -20,7 +21,7 @@ namespace node_gdal {
 
 class LineStringPoints : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
 
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
@@ -33,6 +34,13 @@ class LineStringPoints : public Nan::ObjectWrap {
   static NAN_METHOD(count);
   static NAN_METHOD(reverse);
   static NAN_METHOD(resize);
+  static NAN_METHOD(toFloat64Array);
+  static NAN_METHOD(setFromFloat64Array);
+
+  // 2 (x, y), 3 (x, y, z) or 4 (x, y, z, m)
+  static int coordinateDims(OGRGeometry *geom);
+  // Copies the points to interleaved coordinates, data must hold getNumPoints() * dims values
+  static void exportPoints(OGRSimpleCurve *curve, double *data, int dims);
 
   LineStringPoints();
 
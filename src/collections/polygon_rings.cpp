@@ -3,10 +3,14 @@
 #include "../geometry/gdal_geometry.hpp"
 #include "../geometry/gdal_linearring.hpp"
 #include "../geometry/gdal_polygon.hpp"
+#include "../utils/typed_array.hpp"
+#include "linestring_points.hpp"
+
+#include <vector>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> PolygonRings::constructor;
+thread_local Nan::Persistent<FunctionTemplate> PolygonRings::constructor;
 
 void PolygonRings::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -19,6 +23,7 @@ void PolygonRings::Initialize(Local<Object> target) {
   Nan::SetPrototypeMethod(lcons, "count", count);
   Nan::SetPrototypeMethod(lcons, "get", get);
   Nan::SetPrototypeMethod(lcons, "add", add);
+  Nan::SetPrototypeMethod(lcons, "toFloat64Array", toFloat64Array);
 
   Nan::Set(target, Nan::New("PolygonRings").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
 
@@ -198,4 +203,69 @@ NAN_METHOD(PolygonRings::add) {
   return;
 }
 
+/**
+ * @typedef {object} RingsCoordinates
+ * @property {Float64Array} coordinates The interleaved coordinates of all the rings
+ * @property {Uint32Array} offsets The index of the first point of each ring,
+ * followed by the total number of points
+ */
+
+/**
+ * Returns the coordinates of all the rings in a single `Float64Array`,
+ * the exterior ring first, without creating a `LinearRing` or a `Point` object.
+ *
+ * @example
+ *
+ * const { coordinates, offsets } = polygon.rings.toFloat64Array({ dims: 2 });
+ * // the points of the exterior ring
+ * const exterior = coordinates.subarray(offsets[0] * 2, offsets[1] * 2);
+ *
+ * @method toFloat64Array
+ * @instance
+ * @memberof PolygonRings
+ * @param {CoordinateArrayOptions} [options]
+ * @throws {Error}
+ * @return {RingsCoordinates}
+ */
+NAN_METHOD(PolygonRings::toFloat64Array) {
+
+  Local<Object> parent =
+    Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+  Polygon *geom = Nan::ObjectWrap::Unwrap<Polygon>(parent);
+
+  Local<Object> options = Nan::New<Object>();
+  NODE_ARG_OBJECT_OPT(0, "options", options);
+  int dims = LineStringPoints::coordinateDims(geom->get());
+  NODE_INT_FROM_OBJ_OPT(options, "dims", dims);
+  if (dims < 2 || dims > 4) {
+    Nan::ThrowRangeError("dims must be 2, 3 or 4");
+    return;
+  }
+
+  std::vector<OGRLinearRing *> rings;
+  if (geom->get()->getExteriorRing() != nullptr) rings.push_back(geom->get()->getExteriorRing());
+  for (int i = 0; i < geom->get()->getNumInteriorRings(); i++) rings.push_back(geom->get()->getInteriorRing(i));
+
+  Local<Value> offsets = TypedArray::New(GDT_UInt32, rings.size() + 1);
+  if (offsets.IsEmpty() || !offsets->IsObject()) return; // TypedArray::New threw an error
+  Nan::TypedArrayContents<uint32_t> offsets_data(offsets);
+  uint32_t total = 0;
+  for (size_t i = 0; i < rings.size(); i++) {
+    (*offsets_data)[i] = total;
+    total += rings[i]->getNumPoints();
+  }
+  (*offsets_data)[rings.size()] = total;
+
+  Local<Value> coordinates = TypedArray::New(GDT_Float64, total * dims);
+  if (coordinates.IsEmpty() || !coordinates->IsObject()) return; // TypedArray::New threw an error
+  Nan::TypedArrayContents<double> data(coordinates);
+  for (size_t i = 0; i < rings.size(); i++)
+    LineStringPoints::exportPoints(rings[i], *data + static_cast<size_t>((*offsets_data)[i]) * dims, dims);
+
+  Local<Object> result = Nan::New<Object>();
+  Nan::Set(result, Nan::New("coordinates").ToLocalChecked(), coordinates);
+  Nan::Set(result, Nan::New("offsets").ToLocalChecked(), offsets);
+  info.GetReturnValue().Set(result);
+}
+
 } // namespace node_gdal
@@ -20,7 +20,7 @@ namespace node_gdal {
 
 class PolygonRings : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
 
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
@@ -31,6 +31,7 @@ class PolygonRings : public Nan::ObjectWrap {
   static NAN_METHOD(count);
   static NAN_METHOD(add);
   static NAN_METHOD(remove);
+  static NAN_METHOD(toFloat64Array);
 
   PolygonRings();
 
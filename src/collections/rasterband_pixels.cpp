@@ -4,11 +4,12 @@
 #include "../async.hpp"
 #include "../utils/typed_array.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> RasterBandPixels::constructor;
+thread_local Nan::Persistent<FunctionTemplate> RasterBandPixels::constructor;
 
 void RasterBandPixels::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -21,6 +22,7 @@ void RasterBandPixels::Initialize(Local<Object> target) {
   Nan__SetPrototypeAsyncableMethod(lcons, "get", get);
   Nan__SetPrototypeAsyncableMethod(lcons, "set", set);
   Nan__SetPrototypeAsyncableMethod(lcons, "read", read);
+  Nan__SetPrototypeAsyncableMethod(lcons, "readv", readv);
   Nan__SetPrototypeAsyncableMethod(lcons, "write", write);
   Nan__SetPrototypeAsyncableMethod(lcons, "readBlock", readBlock);
   Nan__SetPrototypeAsyncableMethod(lcons, "writeBlock", writeBlock);
@@ -138,12 +140,13 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::get) {
   GDALRasterBand *raw = band->get();
 
   GDALAsyncableJob<double> job(band->parent_uid);
+  job.shared = isShareable(raw, band->getParent());
   job.persist(band->handle());
 
   job.main = [raw, x, y](const GDALExecutionProgress &) {
     double val;
     CPLErrorReset();
-    CPLErr err = raw->RasterIO(GF_Read, x, y, 1, 1, &val, 1, 1, GDT_Float64, 0, 0);
+    CPLErr err = pooledBand(raw)->RasterIO(GF_Read, x, y, 1, 1, &val, 1, 1, GDT_Float64, 0, 0);
     if (err) { throw CPLGetLastErrorMsg(); }
     return val;
   };
@@ -203,24 +206,6 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::set) {
   job.run(info, async, 3);
 }
 
-inline GDALRIOResampleAlg parseResamplingAlg(Local<Value> value) {
-  if (value->IsUndefined() || value->IsNull()) { return GRIORA_NearestNeighbour; }
-  if (!value->IsString()) { throw "resampling property must be a string"; }
-  std::string name = *Nan::Utf8String(value);
-
-  if (name == "NearestNeighbor") { return GRIORA_NearestNeighbour; }
-  if (name == "NearestNeighbour") { return GRIORA_NearestNeighbour; }
-  if (name == "Bilinear") { return GRIORA_Bilinear; }
-  if (name == "Cubic") { return GRIORA_Cubic; }
-  if (name == "CubicSpline") { return GRIORA_CubicSpline; }
-  if (name == "Lanczos") { return GRIORA_Lanczos; }
-  if (name == "Average") { return GRIORA_Average; }
-  if (name == "Mode") { return GRIORA_Mode; }
-  if (name == "Gauss") { return GRIORA_Gauss; }
-
-  throw "Invalid resampling algorithm";
-}
-
 /* Find the lowest possible element index for the given width, height, pixel_space, line_space and offset */
 static inline int findLowest(int w, int h, int px, int ln, int offset) {
   int x, y;
@@ -270,6 +255,7 @@ static inline int findHighest(int w, int h, int px, int ln, int offset) {
  * @property {number} [line_space]
  * @property {string} [resampling]
  * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
  * @property {number} [offset]
  */
 
@@ -399,26 +385,28 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::read) {
 
   GDALRasterBand *gdal_band = band->get();
   GDALAsyncableJob<CPLErr> job(band->parent_uid);
+  job.shared = isShareable(gdal_band, band->getParent());
   job.persist("array", obj);
   job.persist(band->handle());
   job.progress = cb;
 
   data = (uint8_t *)data + offset * bytes_per_pixel;
-  job.main = [gdal_band, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, resampling, cb](
+  job.main = [gdal_band, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, resampling](
                const GDALExecutionProgress &progress) {
     std::shared_ptr<GDALRasterIOExtraArg> extra(new GDALRasterIOExtraArg);
     INIT_RASTERIO_EXTRA_ARG(*extra);
     extra->eResampleAlg = resampling;
-    if (cb) {
+    if (progress.enabled()) {
       extra->pfnProgress = ProgressTrampoline;
       extra->pProgressData = (void *)&progress;
     }
 
     CPLErrorReset();
-    CPLErr err =
-      gdal_band->RasterIO(GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, extra.get());
+    CPLErr err = pooledBand(gdal_band)->RasterIO(
+      GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, extra.get());
 
     if (err != CE_None) throw CPLGetLastErrorMsg();
+    bytesRead += static_cast<uint64_t>(buffer_w) * buffer_h * GDALGetDataTypeSizeBytes(type);
     return err;
   };
 
@@ -426,6 +414,146 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::read) {
   job.run(info, async, 13);
 }
 
+/**
+ * @typedef {object} ReadWindow
+ * @property {number} x
+ * @property {number} y
+ * @property {number} width
+ * @property {number} height
+ * @property {TypedArray} [data] The `TypedArray` to put the data in. A new array is created if not given.
+ * @property {string} [type] See {@link GDT|GDT constants}, ignored if `data` is given
+ */
+
+/**
+ * Reads several regions of pixels at once.
+ *
+ * All the windows are read in a single operation that locks the Dataset only once.
+ * The windows are read in the order of the blocks of the raster.
+ *
+ * @method readv
+ * @instance
+ * @memberof RasterBandPixels
+ * @throws {Error}
+ * @param {ReadWindow[]} windows
+ * @return {TypedArray[]} A `TypedArray` of values for each window, in the order of the windows
+ */
+
+/**
+ * Asynchronously reads several regions of pixels at once.
+ *
+ * All the windows are read in a single operation that locks the Dataset only once.
+ * The windows are read in the order of the blocks of the raster.
+ * @async
+ *
+ * @method readvAsync
+ * @instance
+ * @memberof RasterBandPixels
+ * @throws {Error}
+ * @param {ReadWindow[]} windows
+ * @param {callback<TypedArray[]>} [callback=undefined]
+ * @return {Promise<TypedArray[]>} A `TypedArray` of values for each window, in the order of the windows
+ */
+GDAL_ASYNCABLE_DEFINE(RasterBandPixels::readv) {
+
+  RasterBand *band;
+  if ((band = parent(info)) == nullptr) return;
+
+  Local<Array> windows;
+  NODE_ARG_ARRAY(0, "windows", windows);
+
+  struct window {
+    int x, y, w, h;
+    GDALDataType type;
+    void *data;
+  };
+  std::vector<window> reads;
+  Local<Array> arrays = Nan::New<Array>(windows->Length());
+
+  for (unsigned i = 0; i < windows->Length(); i++) {
+    Local<Value> el = Nan::Get(windows, i).ToLocalChecked();
+    if (!el->IsObject()) {
+      Nan::ThrowTypeError("windows must contain only objects");
+      return;
+    }
+    Local<Object> win = el.As<Object>();
+    window r;
+    NODE_INT_FROM_OBJ(win, "x", r.x);
+    NODE_INT_FROM_OBJ(win, "y", r.y);
+    NODE_INT_FROM_OBJ(win, "width", r.w);
+    NODE_INT_FROM_OBJ(win, "height", r.h);
+    if (r.w <= 0 || r.h <= 0) {
+      Nan::ThrowRangeError("width and height must be positive");
+      return;
+    }
+
+    r.type = band->get()->GetRasterDataType();
+    std::string type_name = "";
+    NODE_STR_FROM_OBJ_OPT(win, "type", type_name);
+    if (!type_name.empty()) {
+      r.type = GDALGetDataTypeByName(type_name.c_str());
+      if (r.type == GDT_Unknown) {
+        Nan::ThrowError("Invalid data type");
+        return;
+      }
+    }
+
+    Local<Object> obj;
+    Local<Value> data = Nan::Get(win, Nan::New("data").ToLocalChecked()).ToLocalChecked();
+    if (!data->IsUndefined() && !data->IsNull()) {
+      if (!data->IsObject()) {
+        Nan::ThrowTypeError("data must be a TypedArray");
+        return;
+      }
+      obj = data.As<Object>();
+      r.type = TypedArray::Identify(obj);
+      if (r.type == GDT_Unknown) {
+        Nan::ThrowError("Invalid array");
+        return;
+      }
+    } else {
+      Local<Value> array = TypedArray::New(r.type, r.w * r.h);
+      if (array.IsEmpty() || !array->IsObject()) {
+        return; // TypedArray::New threw an error
+      }
+      obj = array.As<Object>();
+    }
+    r.data = TypedArray::Validate(obj, r.type, r.w * r.h);
+    if (!r.data) {
+      return; // TypedArray::Validate threw an error
+    }
+    Nan::Set(arrays, i, obj);
+    reads.push_back(r);
+  }
+
+  GDALRasterBand *gdal_band = band->get();
+  int block_w, block_h;
+  gdal_band->GetBlockSize(&block_w, &block_h);
+  // Reading in block order allows to reuse the blocks in the GDAL cache
+  std::stable_sort(reads.begin(), reads.end(), [block_w, block_h](const window &a, const window &b) {
+    if (a.y / block_h != b.y / block_h) return a.y / block_h < b.y / block_h;
+    return a.x / block_w < b.x / block_w;
+  });
+
+  GDALAsyncableJob<CPLErr> job(band->parent_uid);
+  job.shared = isShareable(gdal_band, band->getParent());
+  job.persist("arrays", arrays);
+  job.persist(band->handle());
+
+  job.main = [gdal_band, reads](const GDALExecutionProgress &) {
+    GDALRasterBand *raw = pooledBand(gdal_band);
+    CPLErrorReset();
+    for (const window &r : reads) {
+      CPLErr err = raw->RasterIO(GF_Read, r.x, r.y, r.w, r.h, r.data, r.w, r.h, r.type, 0, 0, nullptr);
+      if (err != CE_None) throw CPLGetLastErrorMsg();
+      bytesRead += static_cast<uint64_t>(r.w) * r.h * GDALGetDataTypeSizeBytes(r.type);
+    }
+    return CE_None;
+  };
+
+  job.rval = [](CPLErr err, const GetFromPersistentFunc &getter) { return getter("arrays"); };
+  job.run(info, async, 1);
+}
+
 /**
  * @typedef {object} WriteOptions
  * @memberof RasterBandPixels
@@ -434,6 +562,7 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::read) {
  * @property {number} [pixel_space]
  * @property {number} [line_space]
  * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
  * @property {number} [offset]
  */
 
@@ -542,11 +671,11 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::write) {
   }
 
   data = (uint8_t *)data + offset * bytes_per_pixel;
-  job.main = [gdal_band, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, cb](
+  job.main = [gdal_band, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space](
                const GDALExecutionProgress &progress) {
     std::shared_ptr<GDALRasterIOExtraArg> extra(new GDALRasterIOExtraArg);
     INIT_RASTERIO_EXTRA_ARG(*extra);
-    if (cb) {
+    if (progress.enabled()) {
       extra->pfnProgress = ProgressTrampoline;
       extra->pProgressData = (void *)&progress;
     }
@@ -625,12 +754,15 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::readBlock) {
   GDALRasterBand *gdal_band = band->get();
 
   GDALAsyncableJob<CPLErr> job(band->parent_uid);
+  job.shared = isShareable(gdal_band, band->getParent());
   job.persist("array", obj);
   job.persist(band->handle());
-  job.main = [gdal_band, x, y, data](const GDALExecutionProgress &) {
+  size_t bytes = static_cast<size_t>(w) * h * GDALGetDataTypeSizeBytes(type);
+  job.main = [gdal_band, x, y, data, bytes](const GDALExecutionProgress &) {
     CPLErrorReset();
-    CPLErr err = gdal_band->ReadBlock(x, y, data);
+    CPLErr err = pooledBand(gdal_band)->ReadBlock(x, y, data);
     if (err) { throw CPLGetLastErrorMsg(); }
+    bytesRead += bytes;
     return err;
   };
   job.rval = [](CPLErr r, const GetFromPersistentFunc &getter) { return getter("array"); };
@@ -740,11 +872,12 @@ GDAL_ASYNCABLE_DEFINE(RasterBandPixels::clampBlock) {
   };
   GDALRasterBand *gdal_band = band->get();
   GDALAsyncableJob<xy> job(band->parent_uid);
+  job.shared = isShareable(gdal_band, band->getParent());
   job.persist(band->handle());
   job.main = [gdal_band, x, y](const GDALExecutionProgress &) {
     xy r;
     CPLErrorReset();
-    CPLErr err = gdal_band->GetActualBlockSize(x, y, &r.x, &r.y);
+    CPLErr err = pooledBand(gdal_band)->GetActualBlockSize(x, y, &r.x, &r.y);
     if (err != CE_None) { throw CPLGetLastErrorMsg(); }
     return r;
   };
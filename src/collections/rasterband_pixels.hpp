@@ -21,7 +21,7 @@ namespace node_gdal {
 
 class RasterBandPixels : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
 
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
@@ -31,6 +31,7 @@ class RasterBandPixels : public Nan::ObjectWrap {
   GDAL_ASYNCABLE_DECLARE(get);
   GDAL_ASYNCABLE_DECLARE(set);
   GDAL_ASYNCABLE_DECLARE(read);
+  GDAL_ASYNCABLE_DECLARE(readv);
   GDAL_ASYNCABLE_DECLARE(write);
   GDAL_ASYNCABLE_DECLARE(readBlock);
   GDAL_ASYNCABLE_DECLARE(writeBlock);
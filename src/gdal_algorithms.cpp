@@ -3,11 +3,16 @@
 #include "gdal_dataset.hpp"
 #include "gdal_layer.hpp"
 #include "gdal_rasterband.hpp"
+#include "utils/calc_expr.hpp"
 #include "utils/number_list.hpp"
 #include "utils/typed_array.hpp"
 
 #include "node_gdal.h"
 
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
 namespace node_gdal {
 
 void Algorithms::Initialize(Local<Object> target) {
@@ -19,6 +24,7 @@ void Algorithms::Initialize(Local<Object> target) {
   Nan::SetMethod(target, "addPixelFunc", addPixelFunc);
   Nan::SetMethod(target, "toPixelFunc", toPixelFunc);
   Nan__SetAsyncableMethod(target, "_acquireLocks", _acquireLocks);
+  Nan__SetAsyncableMethod(target, "_calc", _calc);
 }
 
 /**
@@ -79,6 +85,7 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::fillNodata) {
   if (mask) ds_uids.push_back(mask->parent_uid);
 
   GDALAsyncableJob<CPLErr> job(ds_uids);
+  job.lane = AsyncLane::CPU;
   job.persist(src->handle());
   if (mask) job.persist(mask->handle());
   job.main = [gdal_src, gdal_mask, search_dist, smooth_iterations](const GDALExecutionProgress &) {
@@ -102,6 +109,7 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::fillNodata) {
  * @property {number} [idField]
  * @property {number} [elevField]
  * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
  */
 
 /**
@@ -200,6 +208,7 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::contourGenerate) {
   long dst_uid = dst->parent_uid;
 
   GDALAsyncableJob<CPLErr> job({src_uid, dst_uid});
+  job.lane = AsyncLane::CPU;
   job.progress = progress_cb;
   job.main = [gdal_src,
               interval,
@@ -210,8 +219,7 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::contourGenerate) {
               nodata,
               gdal_dst,
               id_field,
-              elev_field,
-              progress_cb](const GDALExecutionProgress &progress) {
+              elev_field](const GDALExecutionProgress &progress) {
     CPLErrorReset();
     CPLErr err = GDALContourGenerate(
       gdal_src,
@@ -224,8 +232,8 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::contourGenerate) {
       gdal_dst,
       id_field,
       elev_field,
-      progress_cb ? ProgressTrampoline : nullptr,
-      progress_cb ? (void *)&progress : nullptr);
+      progress.enabled() ? ProgressTrampoline : nullptr,
+      progress.enabled() ? (void *)&progress : nullptr);
     if (err) { throw CPLGetLastErrorMsg(); }
     return err;
   };
@@ -241,6 +249,7 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::contourGenerate) {
  * @property {number} threshold
  * @property {number} [connectedness]
  * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
  */
 
 /**
@@ -306,9 +315,10 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::sieveFilter) {
   if (mask) ds_uids.push_back(mask->parent_uid);
 
   GDALAsyncableJob<CPLErr> job(ds_uids);
+  job.lane = AsyncLane::CPU;
   job.progress = progress_cb;
   job.main =
-    [gdal_src, gdal_dst, gdal_mask, threshold, connectedness, progress_cb](const GDALExecutionProgress &progress) {
+    [gdal_src, gdal_dst, gdal_mask, threshold, connectedness](const GDALExecutionProgress &progress) {
       CPLErrorReset();
       CPLErr err = GDALSieveFilter(
         gdal_src,
@@ -317,8 +327,8 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::sieveFilter) {
         threshold,
         connectedness,
         NULL,
-        progress_cb ? ProgressTrampoline : nullptr,
-        progress_cb ? (void *)&progress : nullptr);
+        progress.enabled() ? ProgressTrampoline : nullptr,
+        progress.enabled() ? (void *)&progress : nullptr);
       if (err) { throw CPLGetLastErrorMsg(); }
       return err;
     };
@@ -387,6 +397,7 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::checksumImage) {
   long src_uid = src->parent_uid;
 
   GDALAsyncableJob<int> job(src_uid);
+  job.lane = AsyncLane::CPU;
   job.persist(src->handle());
   job.main = [gdal_src, x, y, w, h](const GDALExecutionProgress &) {
     CPLErrorReset();
@@ -407,6 +418,7 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::checksumImage) {
  * @property {number} [connectedness=4] Either 4 indicating that diagonal pixels are not considered directly adjacent for polygon membership purposes or 8 indicating they are.
  * @property {boolean} [useFloats=false] Use floating point buffers instead of int buffers.
  * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
  */
 
 /**
@@ -483,13 +495,14 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::polygonize) {
   if (mask) ds_uids.push_back(mask->parent_uid);
 
   GDALAsyncableJob<CPLErr> job(ds_uids);
+  job.lane = AsyncLane::CPU;
   job.progress = progress_cb;
 
   if (
     Nan::HasOwnProperty(obj, Nan::New("useFloats").ToLocalChecked()).FromMaybe(false) &&
     Nan::To<bool>(Nan::Get(obj, Nan::New("useFloats").ToLocalChecked()).ToLocalChecked()).ToChecked()) {
     job.main =
-      [gdal_src, gdal_mask, gdal_dst, pix_val_field, papszOptions, progress_cb](const GDALExecutionProgress &progress) {
+      [gdal_src, gdal_mask, gdal_dst, pix_val_field, papszOptions](const GDALExecutionProgress &progress) {
         CPLErrorReset();
         CPLErr err = GDALFPolygonize(
           gdal_src,
@@ -497,15 +510,15 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::polygonize) {
           reinterpret_cast<OGRLayerH>(gdal_dst),
           pix_val_field,
           papszOptions,
-          progress_cb ? ProgressTrampoline : nullptr,
-          progress_cb ? (void *)&progress : nullptr);
+          progress.enabled() ? ProgressTrampoline : nullptr,
+          progress.enabled() ? (void *)&progress : nullptr);
         if (papszOptions) CSLDestroy(papszOptions);
         if (err) throw CPLGetLastErrorMsg();
         return err;
       };
   } else {
     job.main =
-      [gdal_src, gdal_mask, gdal_dst, pix_val_field, papszOptions, progress_cb](const GDALExecutionProgress &progress) {
+      [gdal_src, gdal_mask, gdal_dst, pix_val_field, papszOptions](const GDALExecutionProgress &progress) {
         CPLErrorReset();
         CPLErr err = GDALPolygonize(
           gdal_src,
@@ -513,8 +526,8 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::polygonize) {
           reinterpret_cast<OGRLayerH>(gdal_dst),
           pix_val_field,
           papszOptions,
-          progress_cb ? ProgressTrampoline : nullptr,
-          progress_cb ? (void *)&progress : nullptr);
+          progress.enabled() ? ProgressTrampoline : nullptr,
+          progress.enabled() ? (void *)&progress : nullptr);
         if (papszOptions) CSLDestroy(papszOptions);
         if (err) throw CPLGetLastErrorMsg();
         return err;
@@ -544,6 +557,129 @@ GDAL_ASYNCABLE_DEFINE(Algorithms::_acquireLocks) {
   job.run(info, async, 3);
 }
 
+// The number of pixels read from each band at once
+static const int calcChunkPixels = 1 << 18;
+
+// The native back-end of calcAsync for expressions (lib/calc.js)
+// Reads, evaluates and writes the whole raster in a single job
+GDAL_ASYNCABLE_DEFINE(Algorithms::_calc) {
+  Local<Object> inputs;
+  RasterBand *output;
+  std::string text;
+  Local<Object> options = Nan::New<Object>();
+
+  NODE_ARG_OBJECT(0, "inputs", inputs);
+  NODE_ARG_WRAPPED(1, "output", RasterBand, output);
+  NODE_ARG_STR(2, "expression", text);
+  NODE_ARG_OBJECT_OPT(3, "options", options);
+
+  std::vector<std::string> names;
+  std::vector<GDALRasterBand *> gdal_inputs;
+  std::vector<long> ds_uids = {output->parent_uid};
+  Local<Array> keys = Nan::GetOwnPropertyNames(inputs).ToLocalChecked();
+  for (unsigned i = 0; i < keys->Length(); i++) {
+    Local<Value> key = Nan::Get(keys, i).ToLocalChecked();
+    Local<Value> val = Nan::Get(inputs, key).ToLocalChecked();
+    if (!val->IsObject() || val->IsNull() || !Nan::New(RasterBand::constructor)->HasInstance(val)) {
+      Nan::ThrowTypeError("All inputs must be instances of gdal.RasterBand");
+      return;
+    }
+    RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(val.As<Object>());
+    if (!band->isAlive()) {
+      Nan::ThrowError("RasterBand object has already been destroyed");
+      return;
+    }
+    names.push_back(*Nan::Utf8String(key));
+    gdal_inputs.push_back(band->get());
+    ds_uids.push_back(band->parent_uid);
+  }
+
+  GDALRasterBand *gdal_output = output->get();
+  for (GDALRasterBand *band : gdal_inputs) {
+    if (band->GetXSize() != gdal_output->GetXSize() || band->GetYSize() != gdal_output->GetYSize()) {
+      Nan::ThrowRangeError("All raster bands dimensions must match");
+      return;
+    }
+  }
+
+  std::shared_ptr<CalcExpression> expr = std::make_shared<CalcExpression>();
+  if (!expr->compile(text, names)) {
+    Nan::ThrowError(expr->error().c_str());
+    return;
+  }
+
+  bool convert_nodata = false;
+  Local<String> sym = Nan::New("convertNoData").ToLocalChecked();
+  if (Nan::HasOwnProperty(options, sym).FromMaybe(false))
+    convert_nodata = Nan::To<bool>(Nan::Get(options, sym).ToLocalChecked()).FromMaybe(false);
+
+  GDALAsyncableJob<CPLErr> job(ds_uids);
+  job.lane = AsyncLane::CPU;
+  job.persist("inputs", inputs);
+  job.persist(output->handle());
+  Nan::Callback *progress_cb;
+  NODE_CB_FROM_OBJ_OPT(options, "progress_cb", progress_cb);
+  job.progress = progress_cb;
+
+  job.main = [expr, gdal_inputs, gdal_output, convert_nodata](const GDALExecutionProgress &progress) {
+    int w = gdal_output->GetXSize();
+    int h = gdal_output->GetYSize();
+    int block_w, block_h;
+    gdal_output->GetBlockSize(&block_w, &block_h);
+    // Whole lines, aligned on the blocks of the output when possible
+    int rows = std::max(1, calcChunkPixels / w);
+    if (rows > block_h) rows -= rows % block_h;
+    rows = std::min(rows, h);
+    size_t n = static_cast<size_t>(w) * rows;
+
+    std::vector<std::vector<double>> data(gdal_inputs.size(), std::vector<double>(n));
+    std::vector<const double *> args;
+    for (const std::vector<double> &d : data) args.push_back(d.data());
+    std::vector<double> result(n);
+    std::vector<double> scratch;
+
+    std::vector<int> has_nodata(gdal_inputs.size(), 0);
+    std::vector<double> nodata(gdal_inputs.size());
+    int output_has_nodata = 0;
+    double output_nodata = 0;
+    if (convert_nodata) {
+      for (size_t i = 0; i < gdal_inputs.size(); i++) nodata[i] = gdal_inputs[i]->GetNoDataValue(&has_nodata[i]);
+      output_nodata = gdal_output->GetNoDataValue(&output_has_nodata);
+    }
+
+    for (int y = 0; y < h; y += rows) {
+      int r = std::min(rows, h - y);
+      size_t len = static_cast<size_t>(w) * r;
+      CPLErrorReset();
+      for (size_t i = 0; i < gdal_inputs.size(); i++) {
+        CPLErr err =
+          gdal_inputs[i]->RasterIO(GF_Read, 0, y, w, r, data[i].data(), w, r, GDT_Float64, 0, 0, nullptr);
+        if (err != CE_None) throw CPLGetLastErrorMsg();
+        if (has_nodata[i]) {
+          double *p = data[i].data();
+          double v = nodata[i];
+          for (size_t k = 0; k < len; k++) p[k] = p[k] == v ? NAN : p[k];
+        }
+      }
+
+      expr->evaluate(args, result.data(), len, scratch);
+
+      if (output_has_nodata) {
+        double *p = result.data();
+        for (size_t k = 0; k < len; k++) p[k] = std::isnan(p[k]) ? output_nodata : p[k];
+      }
+      CPLErr err = gdal_output->RasterIO(GF_Write, 0, y, w, r, result.data(), w, r, GDT_Float64, 0, 0, nullptr);
+      if (err != CE_None) throw CPLGetLastErrorMsg();
+
+      if (progress.enabled() && !ProgressTrampoline(static_cast<double>(y + r) / h, nullptr, (void *)&progress))
+        throw abortedError;
+    }
+    return CE_None;
+  };
+  job.rval = [](CPLErr, const GetFromPersistentFunc &) { return Nan::Undefined().As<Value>(); };
+  job.run(info, async, 4);
+}
+
 /**
  * @typedef {Uint8Array} PixelFunction
  */
@@ -590,7 +726,9 @@ NAN_METHOD(Algorithms::addPixelFunc) {
 
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 5)
 // This is the arguments of one call of the pixel function
+// It lives on the stack of the worker thread that is waiting for its completion
 struct pixelFnCall {
+  size_t id;
   void **sources;
   size_t num;
   void *destination;
@@ -598,21 +736,38 @@ struct pixelFnCall {
   GDALDataType inType;
   GDALDataType outType;
   std::map<std::string, std::string> args;
-  Nan::Utf8String *err;
+  std::string err;
+  uv_sem_t done;
+};
+
+// The pixel functions of one isolate share a single uv_async_t that is created once
+// Worker threads queue their calls and wake up the thread of the isolate,
+// libuv coalesces the wake-ups, so a single callback on the isolate thread
+// runs all the calls that have been queued in the meantime
+// (ie all the blocks of a block-row read by different workers)
+struct pixelFnQueue {
+  std::thread::id thread;
+  uv_async_t *async;
+  uv_mutex_t lock;
+  std::deque<pixelFnCall *> calls;
+  // Set when the isolate exits, its pixel functions remain registered in GDAL
+  bool closed;
 };
 
 // This is the pixel function descriptor
-// The queue can be modified both by the main thread and the worker threads
 struct pixelFn {
   Nan::Callback *fn;
-  pixelFnCall call;
-  uv_mutex_t callJS;
-  uv_sem_t returnJS;
+  pixelFnQueue *owner;
 };
 
-// Only the main thread can modify this and only by adding new elements
-// No need to lock
-std::vector<pixelFn> pixelFuncs;
+// GDAL registers the pixel functions process-wide, so this registry is shared by all
+// the isolates, the elements are only added and a deque never moves them
+static std::deque<pixelFn> pixelFuncs;
+static uv_mutex_t pixelFuncsLock;
+static uv_once_t pixelFuncsOnce = UV_ONCE_INIT;
+
+// The queue of the current isolate, it is never freed as GDAL can still call its functions
+static thread_local pixelFnQueue *pixelFnOwner = nullptr;
 
 #define PFN_ID_FIELD "node_gdal_pfn_id"
 const char metadataTemplate[] =
@@ -622,25 +777,26 @@ const char metadataTemplate[] =
   "</PixelFunctionArgumentsList>";
 
 // This is the final step before calling the JS function
-// This function is called by libuv on the main thread
-// The async_send in the function below is what triggers this call
-static void callJSpfn(uv_async_t *async) {
+// It is always called on the main thread
+static void callJSpfn(pixelFnCall *call) {
   // Here V8 is accessible
   Nan::HandleScope scope;
 
-  pixelFn *fn = reinterpret_cast<pixelFn *>(async->data);
-  Local<Array> sources = Nan::New<Array>(fn->call.num);
-  size_t len = fn->call.width * fn->call.height;
-  for (size_t i = 0; i < fn->call.num; i++) {
-    Nan::Set(sources, i, TypedArray::New(fn->call.inType, fn->call.sources[i], len));
+  uv_mutex_lock(&pixelFuncsLock);
+  pixelFn *fn = &pixelFuncs[call->id];
+  uv_mutex_unlock(&pixelFuncsLock);
+  Local<Array> sources = Nan::New<Array>(call->num);
+  size_t len = call->width * call->height;
+  for (size_t i = 0; i < call->num; i++) {
+    Nan::Set(sources, i, TypedArray::New(call->inType, call->sources[i], len));
   }
-  Local<Value> destination = TypedArray::New(fn->call.outType, fn->call.destination, len);
-  Local<Number> width = Nan::New<Number>(fn->call.width);
-  Local<Number> height = Nan::New<Number>(fn->call.height);
+  Local<Value> destination = TypedArray::New(call->outType, call->destination, len);
+  Local<Number> width = Nan::New<Number>(call->width);
+  Local<Number> height = Nan::New<Number>(call->height);
 
   Local<Object> pfArgs = Nan::New<Object>();
-  if (fn->call.args.size() > 0) {
-    for (auto const &el : fn->call.args) {
+  if (call->args.size() > 0) {
+    for (auto const &el : call->args) {
       char *end;
       double dval = std::strtod(el.second.c_str(), &end);
       if (*end == 0)
@@ -652,19 +808,31 @@ static void callJSpfn(uv_async_t *async) {
 
   Local<Value> args[] = {sources, destination, pfArgs, width, height};
 
-  fn->call.err = nullptr;
   Nan::TryCatch try_catch;
   // async_hooks do not make any sense for pixel functions
   Nan::Call(*fn->fn, 5, args);
-  if (try_catch.HasCaught()) fn->call.err = new Nan::Utf8String(try_catch.Message()->Get());
+  if (try_catch.HasCaught()) call->err = *Nan::Utf8String(try_catch.Message()->Get());
+}
 
-  // unlock the worker thread (the function below)
-  uv_sem_post(&fn->returnJS);
+// This function is called by libuv on the thread of the isolate
+// The async_send in the function below is what triggers this call
+static void drainPixelFnQueue(uv_async_t *handle) {
+  pixelFnQueue *queue = reinterpret_cast<pixelFnQueue *>(handle->data);
+  std::deque<pixelFnCall *> pending;
+  uv_mutex_lock(&queue->lock);
+  pending.swap(queue->calls);
+  uv_mutex_unlock(&queue->lock);
+
+  for (pixelFnCall *call : pending) {
+    callJSpfn(call);
+    // unlock the worker thread (the function below)
+    uv_sem_post(&call->done);
+  }
 }
 
 // This is the GDAL pixel function trampoline that calls the JS callback
 // It is called on one of the libuv async worker threads
-// It throws when called on the main thread to avoid deadlocking
+// or on the main thread in sync mode
 static CPLErr pixelFunc(
   void **papoSources,
   int nSources,
@@ -688,7 +856,11 @@ static CPLErr pixelFunc(
   }
   char *end;
   size_t id = std::strtoul(uid->second.c_str(), &end, 16);
-  if (end == uid->second.c_str() || id >= pixelFuncs.size()) {
+  pixelFnQueue *owner = nullptr;
+  uv_mutex_lock(&pixelFuncsLock);
+  if (end != uid->second.c_str() && id < pixelFuncs.size()) owner = pixelFuncs[id].owner;
+  uv_mutex_unlock(&pixelFuncsLock);
+  if (owner == nullptr) {
     CPLError(CE_Failure, CPLE_AppDefined, "gdal-async Internal error, pixelFuncs inconsistency");
     return CE_Failure;
   }
@@ -702,11 +874,8 @@ static CPLErr pixelFunc(
     return CE_Failure;
   }
 
-  uv_async_t *async = new uv_async_t;
-  async->data = &pixelFuncs[id];
-
-  uv_mutex_lock(&pixelFuncs[id].callJS);
-  pixelFuncs[id].call = {
+  pixelFnCall call = {
+    id,
     papoSources,
     static_cast<size_t>(nSources),
     pData,
@@ -715,30 +884,31 @@ static CPLErr pixelFunc(
     eSrcType,
     eBufType,
     std::move(pfArgsMap),
-    nullptr};
-  if (std::this_thread::get_id() == mainV8ThreadId) {
-    // Main thread = sync mode
-    // Here we are abusing an uninitialized uv_async_t as a data holder
-    callJSpfn(async);
-    delete async;
+    {},
+    {}};
+  if (std::this_thread::get_id() == owner->thread) {
+    // Thread of the isolate that created the function = sync mode
+    callJSpfn(&call);
   } else {
-    // Worker thread = async mode
-    uv_async_init(uv_default_loop(), async, callJSpfn);
-
-    uv_async_send(async);
-    uv_sem_wait(&pixelFuncs[id].returnJS);
-
-    uv_close(reinterpret_cast<uv_handle_t *>(async), [](uv_handle_t *handle) {
-      uv_async_t *async = reinterpret_cast<uv_async_t *>(handle);
-      delete async;
-    });
+    // Worker thread or another isolate = async mode
+    // There is no lock held while waiting, many workers can have queued calls at the same time
+    uv_sem_init(&call.done, 0);
+    uv_mutex_lock(&owner->lock);
+    if (owner->closed) {
+      uv_mutex_unlock(&owner->lock);
+      uv_sem_destroy(&call.done);
+      CPLError(CE_Failure, CPLE_AppDefined, "Pixel function error: the thread that created it has exited");
+      return CE_Failure;
+    }
+    owner->calls.push_back(&call);
+    uv_async_send(owner->async);
+    uv_mutex_unlock(&owner->lock);
+    uv_sem_wait(&call.done);
+    uv_sem_destroy(&call.done);
   }
-  uv_mutex_unlock(&pixelFuncs[id].callJS);
 
-  if (pixelFuncs[id].call.err != nullptr) {
-    CPLError(CE_Failure, CPLE_AppDefined, "Pixel function error: %s", **pixelFuncs[id].call.err);
-    delete pixelFuncs[id].call.err;
-    pixelFuncs[id].call.err = nullptr;
+  if (!call.err.empty()) {
+    CPLError(CE_Failure, CPLE_AppDefined, "Pixel function error: %s", call.err.c_str());
     return CE_Failure;
   }
 
@@ -752,6 +922,9 @@ static CPLErr pixelFunc(
  * As V8, and JS in general, can only have a single active JS context per isolate,
  * even when using async I/O, the pixel function will be called on the main thread.
  * This can lead to increased latency when serving network requests.
+ * The calls coming from concurrent async operations are queued and executed
+ * back to back in a single wake-up of the main thread, while the I/O of the
+ * source bands continues in parallel in the background threads.
  *
  * You can check the `gdal-exprtk` plugin for an alternative
  * which uses ExprTk expressions and does not suffer from this problem.
@@ -784,10 +957,23 @@ NAN_METHOD(Algorithms::toPixelFunc) {
   Nan::Callback *pfn;
   NODE_ARG_CB(0, "pixelFn", pfn);
 
+  uv_once(&pixelFuncsOnce, []() { uv_mutex_init(&pixelFuncsLock); });
+  if (pixelFnOwner == nullptr) {
+    pixelFnOwner = new pixelFnQueue;
+    pixelFnOwner->thread = std::this_thread::get_id();
+    pixelFnOwner->async = new uv_async_t;
+    pixelFnOwner->closed = false;
+    uv_mutex_init(&pixelFnOwner->lock);
+    uv_async_init(Nan::GetCurrentEventLoop(), pixelFnOwner->async, drainPixelFnQueue);
+    pixelFnOwner->async->data = pixelFnOwner;
+    // It must not keep the process alive, the async operations that use it do
+    uv_unref(reinterpret_cast<uv_handle_t *>(pixelFnOwner->async));
+  }
+
+  uv_mutex_lock(&pixelFuncsLock);
   size_t uid = pixelFuncs.size();
-  pixelFuncs.push_back({pfn, {}, {}, {}});
-  uv_mutex_init(&pixelFuncs[uid].callJS);
-  uv_sem_init(&pixelFuncs[uid].returnJS, 0);
+  pixelFuncs.push_back({pfn, pixelFnOwner});
+  uv_mutex_unlock(&pixelFuncsLock);
 
   std::string metadata;
   metadata.reserve(strlen(metadataTemplate) + 32);
@@ -813,4 +999,23 @@ NAN_METHOD(Algorithms::toPixelFunc) {
 #endif
 }
 
+// Called when the isolate exits, the calls from other isolates fail from now on
+void Algorithms::Shutdown() {
+#if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 5)
+  if (pixelFnOwner == nullptr) return;
+  std::deque<pixelFnCall *> pending;
+  uv_mutex_lock(&pixelFnOwner->lock);
+  pixelFnOwner->closed = true;
+  pending.swap(pixelFnOwner->calls);
+  uv_mutex_unlock(&pixelFnOwner->lock);
+  for (pixelFnCall *call : pending) {
+    call->err = "the thread that created it has exited";
+    uv_sem_post(&call->done);
+  }
+  uv_close(reinterpret_cast<uv_handle_t *>(pixelFnOwner->async), [](uv_handle_t *handle) {
+    delete reinterpret_cast<uv_async_t *>(handle);
+  });
+#endif
+}
+
 } // namespace node_gdal
@@ -27,6 +27,7 @@ namespace node_gdal {
 namespace Algorithms {
 
 void Initialize(Local<Object> target);
+void Shutdown();
 
 GDAL_ASYNCABLE_GLOBAL(fillNodata);
 GDAL_ASYNCABLE_GLOBAL(contourGenerate);
@@ -36,6 +37,7 @@ GDAL_ASYNCABLE_GLOBAL(polygonize);
 NAN_METHOD(addPixelFunc);
 NAN_METHOD(toPixelFunc);
 GDAL_ASYNCABLE_GLOBAL(_acquireLocks);
+GDAL_ASYNCABLE_GLOBAL(_calc);
 } // namespace Algorithms
 } // namespace node_gdal
 
@@ -1,6 +1,7 @@
 #ifndef __GDAL_COMMON_H__
 #define __GDAL_COMMON_H__
 
+#include <atomic>
 #include <cpl_error.h>
 #include <gdal_version.h>
 #include <thread>
@@ -17,8 +18,10 @@
 
 namespace node_gdal {
 extern FILE *log_file;
-extern ObjectStore object_store;
+extern thread_local ObjectStore object_store;
 extern bool eventLoopWarn;
+// The process-wide GDAL error handler, thread-local handlers forward to it
+extern std::atomic<CPLErrorHandler> globalErrorHandler;
 } // namespace node_gdal
 
 #ifdef ENABLE_LOGGING
@@ -63,6 +66,24 @@ inline const char *getOGRErrMsg(int err) {
   }
 };
 
+inline GDALRIOResampleAlg parseResamplingAlg(Local<Value> value) {
+  if (value->IsUndefined() || value->IsNull()) { return GRIORA_NearestNeighbour; }
+  if (!value->IsString()) { throw "resampling property must be a string"; }
+  std::string name = *Nan::Utf8String(value);
+
+  if (name == "NearestNeighbor") { return GRIORA_NearestNeighbour; }
+  if (name == "NearestNeighbour") { return GRIORA_NearestNeighbour; }
+  if (name == "Bilinear") { return GRIORA_Bilinear; }
+  if (name == "Cubic") { return GRIORA_Cubic; }
+  if (name == "CubicSpline") { return GRIORA_CubicSpline; }
+  if (name == "Lanczos") { return GRIORA_Lanczos; }
+  if (name == "Average") { return GRIORA_Average; }
+  if (name == "Mode") { return GRIORA_Mode; }
+  if (name == "Gauss") { return GRIORA_Gauss; }
+
+  throw "Invalid resampling algorithm";
+}
+
 // deleter for C++14 shared_ptr which does not have built-in array support
 template <typename T> struct array_deleter {
   void operator()(T const *p) {
@@ -710,6 +731,7 @@ NAN_SETTER(READ_ONLY_SETTER);
     }                                                                                                                  \
     auto *gdal_obj = obj->this_;                                                                                       \
     GDALAsyncableJob<int> job(0);                                                                                      \
+    job.lane = AsyncLane::CPU;                                                                                         \
     job.main = [gdal_obj](const GDALExecutionProgress &) {                                                             \
       gdal_obj->wrapped_method();                                                                                      \
       return 0;                                                                                                        \
@@ -729,6 +751,7 @@ NAN_SETTER(READ_ONLY_SETTER);
     }                                                                                                                  \
     auto *gdal_obj = obj->this_;                                                                                       \
     GDALAsyncableJob<async_type> job(0);                                                                               \
+    job.lane = AsyncLane::CPU;                                                                                         \
     job.main = [gdal_obj](const GDALExecutionProgress &) { return gdal_obj->wrapped_method(); };                       \
     job.rval = [](async_type r, const GetFromPersistentFunc &) { return Nan::New<result_type>(r); };                   \
     job.run(info, async, 0);                                                                                           \
@@ -745,6 +768,7 @@ NAN_SETTER(READ_ONLY_SETTER);
     auto *gdal_obj = obj->this_;                                                                                       \
     auto *gdal_param = param->get();                                                                                   \
     GDALAsyncableJob<async_type> job(0);                                                                               \
+    job.lane = AsyncLane::CPU;                                                                                         \
     job.persist(info[0].As<Object>());                                                                                 \
     job.main = [gdal_obj, gdal_param](const GDALExecutionProgress &) { return gdal_obj->wrapped_method(gdal_param); }; \
     job.rval = [](async_type r, const GetFromPersistentFunc &) { return Nan::New<result_type>(r); };                   \
@@ -763,6 +787,7 @@ NAN_SETTER(READ_ONLY_SETTER);
     }                                                                                                                  \
     auto *gdal_obj = obj->this_;                                                                                       \
     GDALAsyncableJob<async_type> job(0);                                                                               \
+    job.lane = AsyncLane::CPU;                                                                                         \
     job.main = [gdal_obj, param](const GDALExecutionProgress &) { return gdal_obj->wrapped_method(param); };           \
     job.rval = [](async_type r, const GetFromPersistentFunc &) { return Nan::New<result_type>(r); };                   \
     job.run(info, async, 1);                                                                                           \
@@ -799,6 +824,7 @@ NAN_SETTER(READ_ONLY_SETTER);
     auto gdal_obj = obj->this_;                                                                                        \
     auto gdal_param = param->get();                                                                                    \
     GDALAsyncableJob<async_type> job(0);                                                                               \
+    job.lane = AsyncLane::CPU;                                                                                         \
     job.persist(info[0].As<Object>());                                                                                 \
     job.main = [gdal_obj, gdal_param](const GDALExecutionProgress &) {                                                 \
       int err = gdal_obj->wrapped_method(gdal_param);                                                                  \
@@ -1,15 +1,22 @@
 #include <string>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "gdal_coordinate_transformation.hpp"
 #include "gdal_common.hpp"
 #include "gdal_dataset.hpp"
 #include "gdal_spatial_reference.hpp"
+#include "utils/typed_array.hpp"
+#include "utils/proj_cache.hpp"
+#include "utils/helper_threads.hpp"
 #ifdef BUNDLED_GDAL
 #include "proj.h"
 #endif
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> CoordinateTransformation::constructor;
+thread_local Nan::Persistent<FunctionTemplate> CoordinateTransformation::constructor;
 
 void CoordinateTransformation::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -20,6 +27,7 @@ void CoordinateTransformation::Initialize(Local<Object> target) {
 
   Nan::SetPrototypeMethod(lcons, "toString", toString);
   Nan::SetPrototypeMethod(lcons, "transformPoint", transformPoint);
+  Nan__SetPrototypeAsyncableMethod(lcons, "transformPoints", transformPoints);
 
   Nan::Set(target, Nan::New("CoordinateTransformation").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
 
@@ -82,7 +90,7 @@ NAN_METHOD(CoordinateTransformation::New) {
       // srs -> srs
       NODE_ARG_WRAPPED(1, "target", SpatialReference, target);
 
-      OGRCoordinateTransformation *transform = OGRCreateCoordinateTransformation(source->get(), target->get());
+      OGRCoordinateTransformation *transform = proj_cache.transformation(source->get(), target->get());
       if (!transform) {
         NODE_THROW_LAST_CPLERR;
         return;
@@ -227,4 +235,278 @@ NAN_METHOD(CoordinateTransformation::transformPoint) {
   info.GetReturnValue().Set(result);
 }
 
+// GDAL is called with chunks of at most this many points
+static const size_t transformChunkPoints = 16384;
+
+struct TransformPointsBuffers {
+  double *x, *y, *z;
+  // Distance between two consecutive points in doubles, 1 for separate arrays
+  size_t stride;
+  uint8_t *success;
+};
+
+// Transforms the points [first, last) in place, the interleaved
+// coordinates are copied to separate arrays as GDAL expects them
+static void
+transformRange(OGRCoordinateTransformation *ct, const TransformPointsBuffers &b, size_t first, size_t last) {
+  size_t chunk = std::min(transformChunkPoints, last - first);
+  std::vector<int> success(chunk);
+  std::vector<double> x, y, z;
+  bool interleaved = b.stride > 1;
+  if (interleaved) {
+    x.resize(chunk);
+    y.resize(chunk);
+    if (b.z) z.resize(chunk);
+  }
+
+  for (size_t i = first; i < last; i += chunk) {
+    size_t n = std::min(chunk, last - i);
+    double *px = b.x + i, *py = b.y + i, *pz = b.z ? b.z + i : nullptr;
+    if (interleaved) {
+      for (size_t k = 0; k < n; k++) {
+        x[k] = b.x[(i + k) * b.stride];
+        y[k] = b.y[(i + k) * b.stride];
+        if (b.z) z[k] = b.z[(i + k) * b.stride];
+      }
+      px = x.data();
+      py = y.data();
+      pz = b.z ? z.data() : nullptr;
+    }
+
+    std::fill(success.begin(), success.begin() + n, 0);
+#if GDAL_VERSION_MAJOR >= 3
+    ct->Transform(static_cast<int>(n), px, py, pz, nullptr, success.data());
+#else
+    ct->TransformEx(static_cast<int>(n), px, py, pz, success.data());
+#endif
+
+    for (size_t k = 0; k < n; k++) {
+      if (interleaved) {
+        b.x[(i + k) * b.stride] = x[k];
+        b.y[(i + k) * b.stride] = y[k];
+        if (b.z) b.z[(i + k) * b.stride] = z[k];
+      }
+      b.success[i + k] = success[k] ? 1 : 0;
+    }
+  }
+}
+
+/**
+ * @typedef {object} TransformPointsOptions
+ * @property {boolean} [interleaved=false] The coordinates are interleaved in a single array
+ * @property {number} [stride=2] Number of values per point when interleaved, the third value is `z` if `stride >= 3`
+ * @property {number} [threads] Maximum number of threads, the number of CPU cores by default, shared with the other running computations
+ * @property {AbortSignal} [signal]
+ */
+
+/**
+ * Transforms in place the points of one or several `Float64Array`s.
+ *
+ * The coordinates are given either as separate `xs`, `ys` and optional `zs` arrays of the same
+ * length, or as a single array of interleaved coordinates with `{interleaved: true}`.
+ *
+ * GDAL is called once per chunk of points instead of once per point. Large arrays are split
+ * between several threads, each with its own copy of the transformation (requires GDAL >= 3.1).
+ * The points that cannot be transformed are set to `Infinity` and are marked with a `0` in the
+ * returned array.
+ *
+ * @example
+ *
+ * const xs = Float64Array.from([ 20, 21 ]), ys = Float64Array.from([ 30, 31 ])
+ * const success = transform.transformPoints(xs, ys)
+ *
+ * const xy = Float64Array.from([ 20, 30, 21, 31 ])
+ * transform.transformPoints(xy, { interleaved: true })
+ *
+ * @throws {Error}
+ * @method transformPoints
+ * @instance
+ * @memberof CoordinateTransformation
+ * @param {Float64Array} xs The `x` coordinates or the interleaved coordinates
+ * @param {Float64Array|null} [ys] The `y` coordinates
+ * @param {Float64Array|null} [zs] The `z` coordinates
+ * @param {TransformPointsOptions} [options]
+ * @return {Uint8Array} `1` for every point that has been transformed, `0` otherwise
+ */
+
+/**
+ * Transforms in place the interleaved coordinates of a `Float64Array`.
+ *
+ * @example
+ *
+ * const xyz = Float64Array.from([ 20, 30, 0, 21, 31, 0 ])
+ * transform.transformPoints(xyz, { interleaved: true, stride: 3 })
+ *
+ * @throws {Error}
+ * @method transformPoints
+ * @instance
+ * @memberof CoordinateTransformation
+ * @param {Float64Array} points
+ * @param {TransformPointsOptions} options
+ * @return {Uint8Array} `1` for every point that has been transformed, `0` otherwise
+ */
+
+/**
+ * Transforms in place the points of one or several `Float64Array`s.
+ *
+ * The coordinates are given either as separate `xs`, `ys` and optional `zs` arrays of the same
+ * length, or as a single array of interleaved coordinates with `{interleaved: true}`.
+ *
+ * GDAL is called once per chunk of points instead of once per point. Large arrays are split
+ * between several threads, each with its own copy of the transformation (requires GDAL >= 3.1).
+ * The points that cannot be transformed are set to `Infinity` and are marked with a `0` in the
+ * returned array.
+ * @async
+ *
+ * @throws {Error}
+ * @method transformPointsAsync
+ * @instance
+ * @memberof CoordinateTransformation
+ * @param {Float64Array} xs The `x` coordinates or the interleaved coordinates
+ * @param {Float64Array|null} [ys] The `y` coordinates
+ * @param {Float64Array|null} [zs] The `z` coordinates
+ * @param {TransformPointsOptions} [options]
+ * @param {callback<Uint8Array>} [callback=undefined]
+ * @return {Promise<Uint8Array>}
+ */
+/**
+ * Transforms in place the interleaved coordinates of a `Float64Array`.
+ * @async
+ *
+ * @throws {Error}
+ * @method transformPointsAsync
+ * @instance
+ * @memberof CoordinateTransformation
+ * @param {Float64Array} points
+ * @param {TransformPointsOptions} options
+ * @param {callback<Uint8Array>} [callback=undefined]
+ * @return {Promise<Uint8Array>}
+ */
+GDAL_ASYNCABLE_DEFINE(CoordinateTransformation::transformPoints) {
+  CoordinateTransformation *transform = Nan::ObjectWrap::Unwrap<CoordinateTransformation>(info.This());
+  if (!transform->isAlive()) {
+    Nan::ThrowError("CoordinateTransformation object has already been destroyed");
+    return;
+  }
+  OGRCoordinateTransformation *raw = transform->this_;
+
+  Local<Object> options = Nan::New<Object>();
+  NODE_ARG_OBJECT_OPT(3, "options", options);
+
+  bool interleaved = false;
+  Local<String> sym = Nan::New("interleaved").ToLocalChecked();
+  if (Nan::HasOwnProperty(options, sym).FromMaybe(false))
+    interleaved = Nan::To<bool>(Nan::Get(options, sym).ToLocalChecked()).FromMaybe(false);
+  int stride = 2;
+  NODE_INT_FROM_OBJ_OPT(options, "stride", stride);
+  int threads = std::max(1u, std::thread::hardware_concurrency());
+  NODE_INT_FROM_OBJ_OPT(options, "threads", threads);
+  if (threads < 1) {
+    Nan::ThrowRangeError("threads must be positive");
+    return;
+  }
+
+  if (!info[0]->IsFloat64Array()) {
+    Nan::ThrowTypeError("xs must be a Float64Array");
+    return;
+  }
+  Nan::TypedArrayContents<double> xs(info[0]);
+  TransformPointsBuffers b = {*xs, nullptr, nullptr, 1, nullptr};
+  size_t count = xs.length();
+
+  Local<Object> ys, zs;
+  if (interleaved) {
+    if (info.Length() > 1 && !info[1]->IsNull() && !info[1]->IsUndefined()) {
+      Nan::ThrowTypeError("ys must not be given with interleaved coordinates");
+      return;
+    }
+    if (stride < 2) {
+      Nan::ThrowRangeError("stride must be at least 2");
+      return;
+    }
+    if (count % stride != 0) {
+      Nan::ThrowRangeError("The length of the array must be a multiple of stride");
+      return;
+    }
+    count /= stride;
+    b.stride = stride;
+    b.y = b.x + 1;
+    if (stride > 2) b.z = b.x + 2;
+  } else {
+    if (info.Length() < 2 || !info[1]->IsFloat64Array()) {
+      Nan::ThrowTypeError("ys must be a Float64Array");
+      return;
+    }
+    ys = info[1].As<Object>();
+    Nan::TypedArrayContents<double> ys_contents(ys);
+    if (ys_contents.length() != count) {
+      Nan::ThrowRangeError("xs and ys must have the same length");
+      return;
+    }
+    b.y = *ys_contents;
+    if (info.Length() > 2 && !info[2]->IsNull() && !info[2]->IsUndefined()) {
+      if (!info[2]->IsFloat64Array()) {
+        Nan::ThrowTypeError("zs must be a Float64Array");
+        return;
+      }
+      zs = info[2].As<Object>();
+      Nan::TypedArrayContents<double> zs_contents(zs);
+      if (zs_contents.length() != count) {
+        Nan::ThrowRangeError("xs and zs must have the same length");
+        return;
+      }
+      b.z = *zs_contents;
+    }
+  }
+
+  Local<Value> success = TypedArray::New(GDT_Byte, count);
+  if (success.IsEmpty() || !success->IsObject()) return; // TypedArray::New threw an error
+  b.success = *Nan::TypedArrayContents<uint8_t>(success);
+
+  // A thread never gets less than a full chunk
+  threads = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, count / transformChunkPoints)));
+
+  // The transformations are not thread-safe, the async jobs and the helper threads
+  // work on clones created here, on the calling thread
+  std::vector<std::shared_ptr<OGRCoordinateTransformation>> clones;
+#if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
+  if (async || threads > 1) {
+    for (int i = 0; i < threads; i++) {
+      OGRCoordinateTransformation *clone = raw->Clone();
+      if (clone == nullptr) break;
+      clones.emplace_back(clone, OGRCoordinateTransformation::DestroyCT);
+    }
+  }
+#endif
+  threads = std::max(1, static_cast<int>(clones.size()));
+
+  GDALAsyncableJob<bool> job(0);
+  job.lane = AsyncLane::CPU;
+  job.persist("xs", info[0].As<Object>());
+  if (!ys.IsEmpty()) job.persist("ys", ys);
+  if (!zs.IsEmpty()) job.persist("zs", zs);
+  job.persist("success", success.As<Object>());
+
+  job.main = [raw, clones, b, count, threads](const GDALExecutionProgress &) {
+    if (threads == 1) {
+      transformRange(clones.empty() ? raw : clones[0].get(), b, 0, count);
+      return true;
+    }
+    // Each range has its own clone, the calling thread transforms the first one
+    size_t per_thread = (count + threads - 1) / threads;
+    HelperThreads workers(threads - 1);
+    for (int t = 1; t < threads; t++) {
+      OGRCoordinateTransformation *ct = clones[t].get();
+      size_t first = std::min(count, t * per_thread);
+      size_t last = std::min(count, first + per_thread);
+      workers.submit([ct, &b, first, last]() { transformRange(ct, b, first, last); });
+    }
+    transformRange(clones[0].get(), b, 0, std::min(count, per_thread));
+    workers.wait();
+    return true;
+  };
+  job.rval = [](bool, const GetFromPersistentFunc &getter) { return getter("success"); };
+  job.run(info, async, 4);
+}
+
 } // namespace node_gdal
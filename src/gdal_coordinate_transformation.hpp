@@ -14,6 +14,8 @@
 // gdal
 #include <gdalwarper.h>
 
+#include "async.hpp"
+
 using namespace v8;
 using namespace node;
 
@@ -23,12 +25,13 @@ class GeoTransformTransformer;
 
 class CoordinateTransformation : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
   static Local<Value> New(OGRCoordinateTransformation *transform);
   static NAN_METHOD(toString);
   static NAN_METHOD(transformPoint);
+  GDAL_ASYNCABLE_DECLARE(transformPoints);
 
   CoordinateTransformation();
   CoordinateTransformation(OGRCoordinateTransformation *srs);
@@ -50,6 +53,14 @@ class GeoTransformTransformer : public OGRCoordinateTransformation {
     public:
   void *hSrcImageTransformer = nullptr;
 
+  GeoTransformTransformer() {
+  }
+  // The clones own a copy of the GDAL transformer
+  GeoTransformTransformer(const GeoTransformTransformer &other)
+    : OGRCoordinateTransformation(other),
+      hSrcImageTransformer(other.hSrcImageTransformer ? GDALCloneTransformer(other.hSrcImageTransformer) : nullptr) {
+  }
+
   virtual OGRSpatialReference *GetSourceCS() override {
     return nullptr;
   }
@@ -10,10 +10,11 @@
 #include "gdal_rasterband.hpp"
 #include "gdal_spatial_reference.hpp"
 #include "utils/string_list.hpp"
+#include "utils/typed_array.hpp"
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Dataset::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Dataset::constructor;
 
 void Dataset::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -34,6 +35,7 @@ void Dataset::Initialize(Local<Object> target) {
   Nan::SetPrototypeMethod(lcons, "testCapability", testCapability);
   Nan__SetPrototypeAsyncableMethod(lcons, "executeSQL", executeSQL);
   Nan__SetPrototypeAsyncableMethod(lcons, "buildOverviews", buildOverviews);
+  Nan__SetPrototypeAsyncableMethod(lcons, "read", read);
 
   ATTR_DONT_ENUM(lcons, "_uid", uidGetter, READ_ONLY_SETTER);
   ATTR(lcons, "description", descriptionGetter, READ_ONLY_SETTER);
@@ -125,7 +127,7 @@ NAN_METHOD(Dataset::New) {
   }
 }
 
-Local<Value> Dataset::New(GDALDataset *raw, GDALDataset *parent) {
+Local<Value> Dataset::New(GDALDataset *raw, GDALDataset *parent, const std::vector<GDALDataset *> &pool) {
   Nan::EscapableHandleScope scope;
 
   if (!raw) { return scope.Escape(Nan::Null()); }
@@ -145,7 +147,7 @@ Local<Value> Dataset::New(GDALDataset *raw, GDALDataset *parent) {
   Local<Object> obj =
     Nan::NewInstance(Nan::GetFunction(Nan::New(Dataset::constructor)).ToLocalChecked(), 1, &ext).ToLocalChecked();
 
-  wrapped->uid = object_store.add(raw, wrapped->persistent(), parent_uid);
+  wrapped->uid = object_store.add(raw, wrapped->persistent(), parent_uid, pool);
 
   return scope.Escape(obj);
 }
@@ -183,8 +185,9 @@ GDAL_ASYNCABLE_DEFINE(Dataset::getMetadata) {
   NODE_ARG_OPT_STR(0, "domain", domain);
 
   GDALAsyncableJob<char **> job(ds->uid);
+  job.shared = true;
   job.main = [raw, domain](const GDALExecutionProgress &) {
-    return raw->GetMetadata(domain.empty() ? nullptr : domain.c_str());
+    return pooledDataset(raw)->GetMetadata(domain.empty() ? nullptr : domain.c_str());
   };
   job.rval = [](char **md, const GetFromPersistentFunc &) { return MajorObject::getMetadata(md); };
   job.run(info, async, 1);
@@ -656,6 +659,7 @@ GDAL_ASYNCABLE_DEFINE(Dataset::buildOverviews) {
   }
 
   GDALAsyncableJob<CPLErr> job(ds->uid);
+  job.lane = AsyncLane::CPU;
 
   Nan::Callback *progress_cb;
   NODE_PROGRESS_CB_OPT(3, progress_cb, job);
@@ -664,7 +668,7 @@ GDAL_ASYNCABLE_DEFINE(Dataset::buildOverviews) {
   // because the lambda becomes non-copyable
   // But we can use a shared_ptr because the lifetime of the lambda is limited by the lifetime
   // of the async worker
-  job.main = [raw, resampling, n_overviews, o, n_bands, b, progress_cb](const GDALExecutionProgress &progress) {
+  job.main = [raw, resampling, n_overviews, o, n_bands, b](const GDALExecutionProgress &progress) {
     if (b != nullptr) {
       for (int i = 0; i < n_bands; i++) {
         if (b.get()[i] > raw->GetRasterCount() || b.get()[i] < 1) { throw "invalid band id"; }
@@ -677,8 +681,8 @@ GDAL_ASYNCABLE_DEFINE(Dataset::buildOverviews) {
       o.get(),
       n_bands,
       b.get(),
-      progress_cb ? ProgressTrampoline : nullptr,
-      progress_cb ? (void *)&progress : nullptr);
+      progress.enabled() ? ProgressTrampoline : nullptr,
+      progress.enabled() ? (void *)&progress : nullptr);
     if (err != CE_None) { throw CPLGetLastErrorMsg(); }
     return err;
   };
@@ -687,6 +691,241 @@ GDAL_ASYNCABLE_DEFINE(Dataset::buildOverviews) {
   job.run(info, async, 4);
 }
 
+/**
+ * @typedef {object} DatasetReadOptions
+ * @property {number[]} [bands] The bands to read, all the bands by default
+ * @property {string} [interleave="band"] `"pixel"` to interleave the bands pixel by pixel (ie `RGBARGBA...`) or `"band"` to place them one after another
+ * @property {TypedArray|Buffer} [data] The `TypedArray` (or `Buffer` for `Byte` data) to put the data in. A new array is created if not given.
+ * @property {string} [type] See {@link GDT|GDT constants}, ignored if `data` is given
+ * @property {number} [buffer_width=x_size]
+ * @property {number} [buffer_height=y_size]
+ * @property {number} [pixel_space] In bytes, derived from `interleave` by default
+ * @property {number} [line_space] In bytes, derived from `interleave` by default
+ * @property {number} [band_space] In bytes, derived from `interleave` by default
+ * @property {string} [resampling] Resampling algorithm ({@link GRA|available options})
+ * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
+ */
+
+/**
+ * Reads a region of pixels of several bands at once into a single array.
+ *
+ * The whole region is read with a single GDAL call which allows the driver
+ * to use its fast path for pixel-interleaved data.
+ *
+ * @example
+ *
+ * // RGBA, pixel-interleaved, ready to be encoded
+ * const rgba = ds.read(0, 0, 256, 256, { bands: [ 1, 2, 3, 4 ], interleave: 'pixel' });
+ *
+ * @throws {Error}
+ * @method read
+ * @instance
+ * @memberof Dataset
+ * @param {number} x
+ * @param {number} y
+ * @param {number} width
+ * @param {number} height
+ * @param {DatasetReadOptions} [options]
+ * @return {TypedArray} A `TypedArray` of values.
+ */
+
+/**
+ * Asynchronously reads a region of pixels of several bands at once into a single array.
+ *
+ * The whole region is read with a single GDAL call which allows the driver
+ * to use its fast path for pixel-interleaved data.
+ * @async
+ *
+ * @throws {Error}
+ * @method readAsync
+ * @instance
+ * @memberof Dataset
+ * @param {number} x
+ * @param {number} y
+ * @param {number} width
+ * @param {number} height
+ * @param {DatasetReadOptions} [options]
+ * @param {callback<TypedArray>} [callback=undefined]
+ * @return {Promise<TypedArray>} A `TypedArray` of values.
+ */
+GDAL_ASYNCABLE_DEFINE(Dataset::read) {
+
+  NODE_UNWRAP_CHECK(Dataset, info.This(), ds);
+  GDAL_RAW_CHECK(GDALDataset *, ds, raw);
+
+  int x, y, w, h;
+  NODE_ARG_INT(0, "x_offset", x);
+  NODE_ARG_INT(1, "y_offset", y);
+  NODE_ARG_INT(2, "x_size", w);
+  NODE_ARG_INT(3, "y_size", h);
+
+  Local<Object> options = Nan::New<Object>();
+  NODE_ARG_OBJECT_OPT(4, "options", options);
+
+  std::vector<int> bands;
+  Local<Array> bands_array;
+  NODE_ARRAY_FROM_OBJ_OPT(options, "bands", bands_array);
+  if (!bands_array.IsEmpty()) {
+    for (unsigned i = 0; i < bands_array->Length(); i++) {
+      Local<Value> val = Nan::Get(bands_array, i).ToLocalChecked();
+      if (!val->IsNumber()) {
+        Nan::ThrowError("bands array must only contain numbers");
+        return;
+      }
+      int band = Nan::To<int32_t>(val).ToChecked();
+      if (band < 1 || band > raw->GetRasterCount()) {
+        Nan::ThrowRangeError("invalid band id");
+        return;
+      }
+      bands.push_back(band);
+    }
+  } else {
+    for (int i = 1; i <= raw->GetRasterCount(); i++) bands.push_back(i);
+  }
+  if (bands.size() == 0) {
+    Nan::ThrowError("Dataset does not have any raster bands");
+    return;
+  }
+  int n_bands = bands.size();
+
+  std::string interleave = "band";
+  NODE_STR_FROM_OBJ_OPT(options, "interleave", interleave);
+  if (interleave != "band" && interleave != "pixel") {
+    Nan::ThrowError("interleave must be \"band\" or \"pixel\"");
+    return;
+  }
+
+  int buffer_w = w, buffer_h = h;
+  NODE_INT_FROM_OBJ_OPT(options, "buffer_width", buffer_w);
+  NODE_INT_FROM_OBJ_OPT(options, "buffer_height", buffer_h);
+  if (buffer_w <= 0 || buffer_h <= 0) {
+    Nan::ThrowRangeError("buffer_width and buffer_height must be positive");
+    return;
+  }
+
+  GDALDataType type = raw->GetRasterBand(bands[0])->GetRasterDataType();
+  std::string type_name = "";
+  NODE_STR_FROM_OBJ_OPT(options, "type", type_name);
+  if (!type_name.empty()) {
+    type = GDALGetDataTypeByName(type_name.c_str());
+    if (type == GDT_Unknown) {
+      Nan::ThrowError("Invalid data type");
+      return;
+    }
+  }
+
+  Local<Object> obj;
+  Local<Value> data = Nan::Get(options, Nan::New("data").ToLocalChecked()).ToLocalChecked();
+  if (!data->IsUndefined() && !data->IsNull()) {
+    if (!data->IsObject()) {
+      Nan::ThrowTypeError("data must be a TypedArray");
+      return;
+    }
+    obj = data.As<Object>();
+    type = TypedArray::Identify(obj);
+    if (type == GDT_Unknown) {
+      Nan::ThrowError("Invalid array");
+      return;
+    }
+  }
+
+  int bytes_per_pixel = GDALGetDataTypeSize(type) / 8;
+  GSpacing pixel_space, line_space, band_space;
+  if (interleave == "pixel") {
+    pixel_space = (GSpacing)bytes_per_pixel * n_bands;
+    line_space = pixel_space * buffer_w;
+    band_space = bytes_per_pixel;
+  } else {
+    pixel_space = bytes_per_pixel;
+    line_space = pixel_space * buffer_w;
+    band_space = line_space * buffer_h;
+  }
+  NODE_INT64_FROM_OBJ_OPT(options, "pixel_space", pixel_space);
+  NODE_INT64_FROM_OBJ_OPT(options, "line_space", line_space);
+  NODE_INT64_FROM_OBJ_OPT(options, "band_space", band_space);
+  // GDAL replaces a spacing of 0 with its own default which is not accounted for in the size below
+  if (pixel_space <= 0 || line_space <= 0 || band_space <= 0) {
+    Nan::ThrowRangeError("pixel_space, line_space and band_space must be positive");
+    return;
+  }
+
+  GDALRIOResampleAlg resampling;
+  try {
+    resampling = parseResamplingAlg(Nan::Get(options, Nan::New("resampling").ToLocalChecked()).ToLocalChecked());
+  } catch (const char *e) {
+    Nan::ThrowError(e);
+    return;
+  }
+
+  // The last byte written is the last byte of the last pixel of the last line of the last band,
+  // the size is first checked in floating point as user-supplied spacings can overflow GSpacing
+  double max_size = static_cast<double>(buffer_w - 1) * pixel_space + static_cast<double>(buffer_h - 1) * line_space +
+    static_cast<double>(n_bands - 1) * band_space + bytes_per_pixel;
+  if (max_size / bytes_per_pixel > INT_MAX) {
+    Nan::ThrowRangeError("region is too large");
+    return;
+  }
+  GSpacing size = static_cast<GSpacing>(buffer_w - 1) * pixel_space + static_cast<GSpacing>(buffer_h - 1) * line_space +
+    static_cast<GSpacing>(n_bands - 1) * band_space + bytes_per_pixel;
+  GSpacing length = size / bytes_per_pixel + ((size % bytes_per_pixel) ? 1 : 0);
+
+  if (obj.IsEmpty()) {
+    Local<Value> array = TypedArray::New(type, length);
+    if (array.IsEmpty() || !array->IsObject()) {
+      return; // TypedArray::New threw an error
+    }
+    obj = array.As<Object>();
+  }
+  void *buffer = TypedArray::Validate(obj, type, length);
+  if (!buffer) {
+    return; // TypedArray::Validate threw an error
+  }
+
+  GDALAsyncableJob<CPLErr> job(ds->uid);
+  job.shared = true;
+  job.persist("array", obj);
+  Nan::Callback *progress_cb = nullptr;
+  NODE_CB_FROM_OBJ_OPT(options, "progress_cb", progress_cb);
+  job.progress = progress_cb;
+
+  job.main = [raw, x, y, w, h, buffer, buffer_w, buffer_h, type, bands, pixel_space, line_space, band_space,
+              resampling](const GDALExecutionProgress &progress) {
+    GDALRasterIOExtraArg extra;
+    INIT_RASTERIO_EXTRA_ARG(extra);
+    extra.eResampleAlg = resampling;
+    if (progress.enabled()) {
+      extra.pfnProgress = ProgressTrampoline;
+      extra.pProgressData = (void *)&progress;
+    }
+    std::vector<int> band_map(bands);
+
+    CPLErrorReset();
+    CPLErr err = pooledDataset(raw)->RasterIO(
+      GF_Read,
+      x,
+      y,
+      w,
+      h,
+      buffer,
+      buffer_w,
+      buffer_h,
+      type,
+      band_map.size(),
+      band_map.data(),
+      pixel_space,
+      line_space,
+      band_space,
+      &extra);
+    if (err != CE_None) throw CPLGetLastErrorMsg();
+    bytesRead += static_cast<uint64_t>(buffer_w) * buffer_h * bands.size() * GDALGetDataTypeSizeBytes(type);
+    return err;
+  };
+  job.rval = [](CPLErr, const GetFromPersistentFunc &getter) { return getter("array"); };
+
+  job.run(info, async, 5);
+}
+
 /**
  * @readonly
  * @kind member
@@ -27,10 +27,10 @@ namespace node_gdal {
 
 class Dataset : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
-  static Local<Value> New(GDALDataset *ds, GDALDataset *parent = nullptr);
+  static Local<Value> New(GDALDataset *ds, GDALDataset *parent = nullptr, const std::vector<GDALDataset *> &pool = {});
   static NAN_METHOD(toString);
   GDAL_ASYNCABLE_DECLARE(flush);
   GDAL_ASYNCABLE_DECLARE(getMetadata);
@@ -42,6 +42,7 @@ class Dataset : public Nan::ObjectWrap {
   GDAL_ASYNCABLE_DECLARE(executeSQL);
   static NAN_METHOD(testCapability);
   GDAL_ASYNCABLE_DECLARE(buildOverviews);
+  GDAL_ASYNCABLE_DECLARE(read);
   static NAN_METHOD(close);
 
   static NAN_GETTER(bandsGetter);
@@ -14,7 +14,7 @@ namespace node_gdal {
 
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
 
-Nan::Persistent<FunctionTemplate> Dimension::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Dimension::constructor;
 
 void Dimension::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -8,7 +8,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Driver::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Driver::constructor;
 
 void Driver::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -236,6 +236,7 @@ GDAL_ASYNCABLE_DEFINE(Driver::create) {
 /**
  * @typedef {object} CreateOptions
  * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
  */
 
 /**
@@ -313,15 +314,21 @@ GDAL_ASYNCABLE_DEFINE(Driver::createCopy) {
   GDALDriver *raw = driver->getGDALDriver();
   GDALDataset *raw_ds = src_dataset->get();
   GDALAsyncableJob<GDALDataset *> job(src_dataset->uid);
+  job.lane = AsyncLane::CPU;
   job.rval = DatasetRval;
   job.persist(driver->handle());
   job.progress = progress_cb;
 
-  job.main = [raw, filename, raw_ds, strict, options, progress_cb](const GDALExecutionProgress &progress) {
+  job.main = [raw, filename, raw_ds, strict, options](const GDALExecutionProgress &progress) {
     std::unique_ptr<StringList> options_ptr(options);
     CPLErrorReset();
     GDALDataset *ds = raw->CreateCopy(
-      filename.c_str(), raw_ds, strict, options->get(), progress_cb ? ProgressTrampoline : nullptr, (void *)&progress);
+      filename.c_str(),
+      raw_ds,
+      strict,
+      options->get(),
+      progress.enabled() ? ProgressTrampoline : nullptr,
+      (void *)&progress);
     if (!ds) throw CPLGetLastErrorMsg();
     return ds;
   };
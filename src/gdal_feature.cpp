@@ -9,7 +9,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Feature::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Feature::constructor;
 
 void Feature::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
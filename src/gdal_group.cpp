@@ -15,7 +15,7 @@ namespace node_gdal {
 
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
 
-Nan::Persistent<FunctionTemplate> Group::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Group::constructor;
 
 void Group::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -15,7 +15,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Layer::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Layer::constructor;
 
 void Layer::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -14,7 +14,7 @@ namespace node_gdal {
 
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
 
-Nan::Persistent<FunctionTemplate> MDArray::constructor;
+thread_local Nan::Persistent<FunctionTemplate> MDArray::constructor;
 
 void MDArray::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -8,7 +8,7 @@ namespace node_gdal {
  * @namespace vsimem
  */
 
-std::map<void *, Memfile *> Memfile::memfile_collection;
+thread_local std::map<void *, Memfile *> Memfile::memfile_collection;
 
 Memfile::Memfile(void *data, const std::string &filename) : data(data), filename(filename) {
 }
@@ -31,6 +31,33 @@ void Memfile::weakCallback(const Nan::WeakCallbackInfo<Memfile> &file) {
   delete mem;
 }
 
+// Called when the isolate exits, its Buffers are about to be freed while the /vsimem/ files are
+// shared by all the isolates - the named files are replaced by a copy owned by GDAL, the anonymous
+// ones are deleted
+void Memfile::Shutdown() {
+  for (auto const &m : memfile_collection) {
+    Memfile *mem = m.second;
+    vsi_l_offset len;
+    void *data = VSIGetMemFileBuffer(mem->filename.c_str(), &len, false);
+    // The file can have been released or replaced by another isolate
+    if (data == mem->data) {
+      VSIUnlink(mem->filename.c_str());
+      void *dataCopy = mem->persistent->IsWeak() ? nullptr : VSIMalloc(static_cast<size_t>(len));
+      if (dataCopy != nullptr) {
+        memcpy(dataCopy, data, static_cast<size_t>(len));
+        VSILFILE *vsi = VSIFileFromMemBuffer(mem->filename.c_str(), (GByte *)dataCopy, len, 1);
+        if (vsi == nullptr)
+          VSIFree(dataCopy);
+        else
+          VSIFCloseL(vsi);
+      }
+    }
+    mem->persistent->Reset();
+    delete mem;
+  }
+  memfile_collection.clear();
+}
+
 void Memfile::Initialize(Local<Object> target) {
   Local<Object> vsimem = Nan::New<Object>();
   Nan::Set(target, Nan::New("vsimem").ToLocalChecked(), vsimem);
@@ -116,6 +143,9 @@ bool Memfile::copy(Local<Object> buffer, const std::string &filename) {
  * be able to extend it as the allocated memory will be tied to the `Buffer` object.
  * Use `gdal.vsimem.copy` to create an extendable copy.
  *
+ * When the file is created in a `worker_thread`, it is copied into GDAL's heap
+ * when the thread exits, the other threads can keep using it.
+ *
  * @static
  * @method set
  * @memberof vsimem
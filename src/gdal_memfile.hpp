@@ -34,9 +34,11 @@ class Memfile {
   static Memfile *get(Local<Object>);
   static Memfile *get(Local<Object>, const std::string &filename);
   static bool copy(Local<Object>, const std::string &filename);
-  static std::map<void *, Memfile *> memfile_collection;
+  // The Buffers of the current isolate, the /vsimem/ files themselves are shared by all the isolates
+  static thread_local std::map<void *, Memfile *> memfile_collection;
 
   static void Initialize(Local<Object> target);
+  static void Shutdown();
   static NAN_METHOD(vsimemSet);
   static NAN_METHOD(vsimemAnonymous);
   static NAN_METHOD(vsimemRelease);
@@ -8,15 +8,16 @@
 #include "gdal_mdarray.hpp"
 #include "gdal_majorobject.hpp"
 #include "gdal_rasterband.hpp"
+#include "utils/raster_summary.hpp"
 #include "utils/string_list.hpp"
+#include "utils/typed_array.hpp"
 
 #include <cpl_port.h>
 #include <limits>
-#include <mutex>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> RasterBand::constructor;
+thread_local Nan::Persistent<FunctionTemplate> RasterBand::constructor;
 
 void RasterBand::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -34,6 +35,7 @@ void RasterBand::Initialize(Local<Object> target) {
   Nan::SetPrototypeMethod(lcons, "getStatistics", getStatistics);
   Nan::SetPrototypeMethod(lcons, "setStatistics", setStatistics);
   Nan__SetPrototypeAsyncableMethod(lcons, "computeStatistics", computeStatistics);
+  Nan__SetPrototypeAsyncableMethod(lcons, "computeSummary", computeSummary);
   Nan::SetPrototypeMethod(lcons, "getMaskBand", getMaskBand);
   Nan::SetPrototypeMethod(lcons, "getMaskFlags", getMaskFlags);
   Nan::SetPrototypeMethod(lcons, "createMaskBand", createMaskBand);
@@ -288,21 +290,31 @@ GDAL_ASYNCABLE_DEFINE(RasterBand::fill) {
 
 // --- Custom error handling to handle VRT errors ---
 // see: https://github.com/mapbox/mapnik-omnivore/issues/10
+//
+// The handler is pushed only on the current thread and captures
+// the errors of the current operation, so statistics on different
+// datasets can be computed in parallel
+class StatsErrorCapture {
+    public:
+  std::string file_err;
+
+  StatsErrorCapture() : file_err() {
+    CPLPushErrorHandlerEx(handler, this);
+  }
+  // The captured error becomes the last error of the thread
+  ~StatsErrorCapture() {
+    CPLPopErrorHandler();
+    if (!file_err.empty()) { CPLErrorSetState(CE_Failure, CPLE_OpenFailed, file_err.c_str()); }
+  }
 
-std::mutex stats_lock;
-std::string stats_file_err = "";
-CPLErrorHandler last_err_handler;
-void CPL_STDCALL statisticsErrorHandler(CPLErr eErrClass, int err_no, const char *msg) {
-  if (err_no == CPLE_OpenFailed) { stats_file_err = msg; }
-  if (last_err_handler) { last_err_handler(eErrClass, err_no, msg); }
-}
-void pushStatsErrorHandler() {
-  last_err_handler = CPLSetErrorHandler(statisticsErrorHandler);
-}
-void popStatsErrorHandler() {
-  if (!last_err_handler) return;
-  CPLSetErrorHandler(last_err_handler);
-}
+    private:
+  static void CPL_STDCALL handler(CPLErr eErrClass, CPLErrorNum err_no, const char *msg) {
+    StatsErrorCapture *self = static_cast<StatsErrorCapture *>(CPLGetErrorHandlerUserData());
+    if (err_no == CPLE_OpenFailed) { self->file_err = msg; }
+    CPLErrorHandler global = globalErrorHandler;
+    if (global) { global(eErrClass, err_no, msg); }
+  }
+};
 
 /**
  * Return a view of this raster band as a 2D multidimensional GDALMDArray.
@@ -361,11 +373,11 @@ NAN_METHOD(RasterBand::getStatistics) {
   NODE_ARG_BOOL(1, "force", force);
   NODE_UNWRAP_CHECK(RasterBand, info.This(), band);
   GDAL_LOCK_PARENT(band);
-  pushStatsErrorHandler();
+  StatsErrorCapture errors;
   CPLErr err = band->this_->GetStatistics(approx, force, &min, &max, &mean, &std_dev);
-  popStatsErrorHandler();
-  if (!stats_file_err.empty()) {
-    Nan::ThrowError(stats_file_err.c_str());
+  if (!errors.file_err.empty()) {
+    Nan::ThrowError(errors.file_err.c_str());
+    return;
   } else if (err) {
     if (!force && err == CE_Warning) {
       Nan::ThrowError("Statistics cannot be efficiently computed without scanning raster");
@@ -440,21 +452,21 @@ GDAL_ASYNCABLE_DEFINE(RasterBand::computeStatistics) {
   NODE_UNWRAP_CHECK(RasterBand, info.This(), band);
 
   GDALAsyncableJob<stats_t> job(band->parent_uid);
+  job.lane = AsyncLane::CPU;
   GDALRasterBand *gdal_obj = band->this_;
 
   job.main = [gdal_obj, approx](const GDALExecutionProgress &) {
     struct stats_t stats;
-    std::lock_guard<std::mutex> guard(stats_lock);
 
     CPLErrorReset();
-    pushStatsErrorHandler();
-    CPLErr err = gdal_obj->ComputeStatistics(approx, &stats.min, &stats.max, &stats.mean, &stats.std_dev, NULL, NULL);
-    popStatsErrorHandler();
-    if (!stats_file_err.empty()) {
-      throw stats_file_err.c_str();
-    } else if (err != CPLE_None) {
-      throw CPLGetLastErrorMsg();
+    CPLErr err;
+    bool file_err;
+    {
+      StatsErrorCapture errors;
+      err = gdal_obj->ComputeStatistics(approx, &stats.min, &stats.max, &stats.mean, &stats.std_dev, NULL, NULL);
+      file_err = !errors.file_err.empty();
     }
+    if (file_err || err != CPLE_None) { throw CPLGetLastErrorMsg(); }
 
     return stats;
   };
@@ -472,6 +484,174 @@ GDAL_ASYNCABLE_DEFINE(RasterBand::computeStatistics) {
   job.run(info, async, 1);
 }
 
+/**
+ * @typedef {object} SummaryOptions
+ * @property {number} [bins=256] Number of bins of the histogram
+ * @property {number} [min] Lower bound of the histogram
+ * @property {number} [max] Upper bound of the histogram
+ * @property {number[]} [percentiles=[25,50,75]] Percentiles to compute, between 0 and 100
+ * @property {number} [threads] Maximum number of threads accumulating the statistics, the number of CPU cores by default, shared with the other running computations
+ * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
+ */
+
+/**
+ * @typedef {object} SummaryHistogram
+ * @property {number} min
+ * @property {number} max
+ * @property {Float64Array} bins
+ */
+
+/**
+ * @typedef {object} Summary
+ * @property {number} count Number of valid pixels
+ * @property {number} nodata_count Number of NoData and NaN pixels
+ * @property {number} min
+ * @property {number} max
+ * @property {number} mean
+ * @property {number} std_dev
+ * @property {SummaryHistogram} histogram
+ * @property {Float64Array} percentiles In the order of `options.percentiles`
+ */
+
+/**
+ * Computes the statistics, the histogram and the percentiles of the band.
+ *
+ * The band is read once, in strips of whole lines, and the strips are accumulated
+ * by several threads in parallel with the reading. When the histogram range is not given,
+ * it is implied by the data type for 8 and 16-bit integers and it requires a
+ * first pass over the data for all other types. The percentiles are derived from
+ * the histogram, they are exact for integer data with one bin per value
+ * (the default for `Byte`) and interpolated within the bins otherwise.
+ *
+ * NoData and NaN pixels are excluded.
+ *
+ * @throws {Error}
+ * @method computeSummary
+ * @instance
+ * @memberof RasterBand
+ * @param {SummaryOptions} [options]
+ * @return {Summary}
+ */
+
+/**
+ * Computes the statistics, the histogram and the percentiles of the band.
+ *
+ * The band is read once, in strips of whole lines, and the strips are accumulated
+ * by several threads in parallel with the reading. When the histogram range is not given,
+ * it is implied by the data type for 8 and 16-bit integers and it requires a
+ * first pass over the data for all other types. The percentiles are derived from
+ * the histogram, they are exact for integer data with one bin per value
+ * (the default for `Byte`) and interpolated within the bins otherwise.
+ *
+ * NoData and NaN pixels are excluded.
+ * @async
+ *
+ * @throws {Error}
+ * @method computeSummaryAsync
+ * @instance
+ * @memberof RasterBand
+ * @param {SummaryOptions} [options]
+ * @param {callback<Summary>} [callback=undefined]
+ * @return {Promise<Summary>}
+ */
+GDAL_ASYNCABLE_DEFINE(RasterBand::computeSummary) {
+  NODE_UNWRAP_CHECK(RasterBand, info.This(), band);
+  GDAL_RAW_CHECK(GDALRasterBand *, band, raw);
+
+  Local<Object> options = Nan::New<Object>();
+  NODE_ARG_OBJECT_OPT(0, "options", options);
+
+  RasterSummaryOptions opts = {256, false, 0, 0, {25, 50, 75}, 0};
+  NODE_INT_FROM_OBJ_OPT(options, "bins", opts.bins);
+  if (opts.bins < 1) {
+    Nan::ThrowRangeError("bins must be positive");
+    return;
+  }
+  Local<String> min_sym = Nan::New("min").ToLocalChecked();
+  Local<String> max_sym = Nan::New("max").ToLocalChecked();
+  if (Nan::HasOwnProperty(options, min_sym).FromMaybe(false) || Nan::HasOwnProperty(options, max_sym).FromMaybe(false)) {
+    opts.has_range = true;
+    opts.min = NAN;
+    opts.max = NAN;
+    NODE_DOUBLE_FROM_OBJ_OPT(options, "min", opts.min);
+    NODE_DOUBLE_FROM_OBJ_OPT(options, "max", opts.max);
+    if (!(opts.max > opts.min)) {
+      Nan::ThrowRangeError("min and max must be both given and max must be greater than min");
+      return;
+    }
+  }
+
+  Local<Array> percentiles;
+  NODE_ARRAY_FROM_OBJ_OPT(options, "percentiles", percentiles);
+  if (!percentiles.IsEmpty()) {
+    opts.percentiles.clear();
+    for (unsigned i = 0; i < percentiles->Length(); i++) {
+      Local<Value> val = Nan::Get(percentiles, i).ToLocalChecked();
+      double p = val->IsNumber() ? Nan::To<double>(val).ToChecked() : NAN;
+      if (!(p >= 0 && p <= 100)) {
+        Nan::ThrowRangeError("percentiles must be numbers between 0 and 100");
+        return;
+      }
+      opts.percentiles.push_back(p);
+    }
+  }
+
+  opts.threads = std::max(1u, std::thread::hardware_concurrency());
+  NODE_INT_FROM_OBJ_OPT(options, "threads", opts.threads);
+  if (opts.threads < 1) {
+    Nan::ThrowRangeError("threads must be positive");
+    return;
+  }
+
+  GDALAsyncableJob<std::shared_ptr<RasterSummary>> job(band->parent_uid);
+  job.lane = AsyncLane::CPU;
+  job.shared = isShareable(raw, band->getParent());
+  Nan::Callback *progress_cb;
+  NODE_CB_FROM_OBJ_OPT(options, "progress_cb", progress_cb);
+  job.progress = progress_cb;
+
+  job.main = [raw, opts](const GDALExecutionProgress &progress) {
+    std::function<bool(double)> report;
+    if (progress.enabled())
+      report = [&progress](double complete) { return ProgressTrampoline(complete, nullptr, (void *)&progress) != 0; };
+    return std::make_shared<RasterSummary>(computeRasterSummary(pooledBand(raw), opts, report));
+  };
+
+  job.rval = [](std::shared_ptr<RasterSummary> s, const GetFromPersistentFunc &) {
+    Nan::EscapableHandleScope scope;
+    Local<Object> result = Nan::New<Object>();
+    Nan::Set(result, Nan::New("count").ToLocalChecked(), Nan::New<Number>(static_cast<double>(s->count)));
+    Nan::Set(
+      result, Nan::New("nodata_count").ToLocalChecked(), Nan::New<Number>(static_cast<double>(s->nodata_count)));
+    Nan::Set(result, Nan::New("min").ToLocalChecked(), Nan::New<Number>(s->min));
+    Nan::Set(result, Nan::New("max").ToLocalChecked(), Nan::New<Number>(s->max));
+    Nan::Set(result, Nan::New("mean").ToLocalChecked(), Nan::New<Number>(s->mean));
+    Nan::Set(result, Nan::New("std_dev").ToLocalChecked(), Nan::New<Number>(s->std_dev));
+
+    Local<Object> histogram = Nan::New<Object>();
+    Nan::Set(histogram, Nan::New("min").ToLocalChecked(), Nan::New<Number>(s->hist_min));
+    Nan::Set(histogram, Nan::New("max").ToLocalChecked(), Nan::New<Number>(s->hist_max));
+    Local<Value> bins = TypedArray::New(GDT_Float64, s->histogram.size());
+    if (!bins.IsEmpty() && bins->IsObject()) {
+      Nan::TypedArrayContents<double> contents(bins);
+      memcpy(*contents, s->histogram.data(), s->histogram.size() * sizeof(double));
+    }
+    Nan::Set(histogram, Nan::New("bins").ToLocalChecked(), bins);
+    Nan::Set(result, Nan::New("histogram").ToLocalChecked(), histogram);
+
+    Local<Value> percentiles = TypedArray::New(GDT_Float64, s->percentiles.size());
+    if (!percentiles.IsEmpty() && percentiles->IsObject() && s->percentiles.size() > 0) {
+      Nan::TypedArrayContents<double> contents(percentiles);
+      memcpy(*contents, s->percentiles.data(), s->percentiles.size() * sizeof(double));
+    }
+    Nan::Set(result, Nan::New("percentiles").ToLocalChecked(), percentiles);
+    return scope.Escape(result);
+  };
+
+  job.run(info, async, 1);
+}
+
 /**
  * Set statistics on the band. This method can be used to store
  * min/max/mean/standard deviation statistics.
@@ -532,8 +712,9 @@ GDAL_ASYNCABLE_DEFINE(RasterBand::getMetadata) {
   GDAL_RAW_CHECK(GDALRasterBand *, band, raw);
 
   GDALAsyncableJob<char **> job(band->parent_uid);
+  job.shared = isShareable(raw, band->getParent());
   job.main = [raw, domain](const GDALExecutionProgress &) {
-    return raw->GetMetadata(domain.empty() ? nullptr : domain.c_str());
+    return pooledBand(raw)->GetMetadata(domain.empty() ? nullptr : domain.c_str());
   };
   job.rval = [](char **md, const GetFromPersistentFunc &) { return MajorObject::getMetadata(md); };
   job.run(info, async, 1);
@@ -20,7 +20,7 @@ namespace node_gdal {
 
 class RasterBand : public Nan::ObjectWrap {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   static void Initialize(Local<Object> target);
   static NAN_METHOD(New);
   static Local<Value> New(GDALRasterBand *band, GDALDataset *parent);
@@ -32,6 +32,7 @@ class RasterBand : public Nan::ObjectWrap {
 #endif
   static NAN_METHOD(getStatistics);
   GDAL_ASYNCABLE_DECLARE(computeStatistics);
+  GDAL_ASYNCABLE_DECLARE(computeSummary);
   static NAN_METHOD(setStatistics);
   static NAN_METHOD(getMaskBand);
   static NAN_METHOD(getMaskFlags);
@@ -0,0 +1,462 @@
+#include <vector>
+#include "gdal_spatial_index.hpp"
+#include "gdal_common.hpp"
+#include "gdal_layer.hpp"
+#include "geometry/gdal_geometry.hpp"
+#include "geometry/gdal_point.hpp"
+#include "utils/geometry_list.hpp"
+#include "utils/typed_array.hpp"
+
+namespace node_gdal {
+
+thread_local Nan::Persistent<FunctionTemplate> SpatialIndex::constructor;
+
+void SpatialIndex::Initialize(Local<Object> target) {
+  Nan::HandleScope scope;
+
+  Local<FunctionTemplate> lcons = Nan::New<FunctionTemplate>(SpatialIndex::New);
+  lcons->InstanceTemplate()->SetInternalFieldCount(1);
+  lcons->SetClassName(Nan::New("SpatialIndex").ToLocalChecked());
+
+  Nan__SetAsyncableMethod(lcons, "fromGeometries", fromGeometries);
+  Nan__SetAsyncableMethod(lcons, "fromLayer", fromLayer);
+
+  Nan::SetPrototypeMethod(lcons, "toString", toString);
+  Nan__SetPrototypeAsyncableMethod(lcons, "search", search);
+  Nan__SetPrototypeAsyncableMethod(lcons, "nearest", nearest);
+  Nan__SetPrototypeAsyncableMethod(lcons, "join", join);
+
+  ATTR(lcons, "count", countGetter, READ_ONLY_SETTER);
+
+  Nan::Set(target, Nan::New("SpatialIndex").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
+
+  constructor.Reset(lcons);
+}
+
+SpatialIndex::SpatialIndex(std::shared_ptr<STRtree> tree) : Nan::ObjectWrap(), this_(tree) {
+  LOG("Created SpatialIndex [%p]", tree.get());
+}
+
+SpatialIndex::SpatialIndex() : Nan::ObjectWrap(), this_() {
+}
+
+SpatialIndex::~SpatialIndex() {
+  LOG("Disposing SpatialIndex [%p]", this_.get());
+}
+
+/**
+ * A static in-memory R-tree bulk-loaded with the Sort-Tile-Recursive algorithm,
+ * created by {@link SpatialIndex.fromGeometries} or {@link SpatialIndex.fromLayer}.
+ *
+ * The index holds the envelopes of the geometries and their identifiers - their
+ * positions in the array or their FIDs. The queries return the identifiers of the
+ * candidates whose envelopes match, an exact test can then be done with
+ * {@link PreparedGeometry}.
+ *
+ * The index cannot be modified once built and any number of queries can run
+ * concurrently.
+ *
+ * @example
+ *
+ * const parcels = await gdal.SpatialIndex.fromLayerAsync(ds.layers.get(0))
+ * const fids = await parcels.searchAsync({ minX: 0, minY: 0, maxX: 100, maxY: 100 })
+ *
+ * @class SpatialIndex
+ */
+NAN_METHOD(SpatialIndex::New) {
+
+  if (!info.IsConstructCall()) {
+    Nan::ThrowError("Cannot call constructor as function, you need to use 'new' keyword");
+    return;
+  }
+
+  if (info[0]->IsExternal()) {
+    Local<External> ext = info[0].As<External>();
+    void *ptr = ext->Value();
+    SpatialIndex *f = static_cast<SpatialIndex *>(ptr);
+    f->Wrap(info.This());
+    info.GetReturnValue().Set(info.This());
+    return;
+  }
+
+  Nan::ThrowError("SpatialIndex cannot be constructed directly, use SpatialIndex.fromGeometries() or fromLayer()");
+}
+
+Local<Value> SpatialIndex::New(std::shared_ptr<STRtree> tree) {
+  Nan::EscapableHandleScope scope;
+
+  SpatialIndex *wrapped = new SpatialIndex(tree);
+
+  Local<Value> ext = Nan::New<External>(wrapped);
+  Local<Object> obj =
+    Nan::NewInstance(Nan::GetFunction(Nan::New(SpatialIndex::constructor)).ToLocalChecked(), 1, &ext).ToLocalChecked();
+
+  return scope.Escape(obj);
+}
+
+NAN_METHOD(SpatialIndex::toString) {
+  info.GetReturnValue().Set(Nan::New("SpatialIndex").ToLocalChecked());
+}
+
+/**
+ * @typedef {object} SpatialIndexOptions
+ * @property {number} [nodeSize=16] The number of children of each node of the tree
+ */
+
+/**
+ * @typedef {object} SpatialIndexNearest
+ * @property {Float64Array} ids The identifiers of the nearest items, closest first
+ * @property {Float64Array} distances The distances to their envelopes
+ */
+
+/**
+ * @typedef {object} SpatialIndexJoin
+ * @property {Float64Array} left The identifiers of the items of this index
+ * @property {Float64Array} right The identifiers of the matching items of the other index
+ */
+
+/**
+ * Builds a spatial index of an array of geometries, the identifier of each
+ * geometry is its position in the array. The `null` and the empty geometries
+ * are not indexed.
+ *
+ * @static
+ * @throws {Error}
+ * @method fromGeometries
+ * @memberof SpatialIndex
+ * @param {(Geometry|Buffer|null)[]} geometries Geometries or WKB buffers
+ * @param {SpatialIndexOptions} [options]
+ * @return {SpatialIndex}
+ */
+
+/**
+ * Builds a spatial index of an array of geometries, the identifier of each
+ * geometry is its position in the array. The `null` and the empty geometries
+ * are not indexed.
+ * @async
+ *
+ * @static
+ * @throws {Error}
+ * @method fromGeometriesAsync
+ * @memberof SpatialIndex
+ * @param {(Geometry|Buffer|null)[]} geometries Geometries or WKB buffers
+ * @param {SpatialIndexOptions} [options]
+ * @param {callback<SpatialIndex>} [callback=undefined]
+ * @return {Promise<SpatialIndex>}
+ */
+GDAL_ASYNCABLE_DEFINE(SpatialIndex::fromGeometries) {
+  Local<Array> array;
+  NODE_ARG_ARRAY(0, "geometries", array);
+  Local<Object> options = Nan::New<Object>();
+  NODE_ARG_OBJECT_OPT(1, "options", options);
+  int node_size = 16;
+  NODE_INT_FROM_OBJ_OPT(options, "nodeSize", node_size);
+  if (node_size < 2) {
+    Nan::ThrowRangeError("nodeSize must be at least 2");
+    return;
+  }
+
+  GeometryList list(true, true);
+  if (list.parse(array, "geometries must be an array of Geometry objects or WKB Buffers")) return;
+  const std::vector<GeometrySource> &sources = list.get();
+
+  GDALAsyncableJob<std::shared_ptr<STRtree>> job(0);
+  job.lane = AsyncLane::CPU;
+  job.persist("geometries", list.persistent());
+  job.main = [sources, node_size](const GDALExecutionProgress &) {
+    std::vector<OGREnvelope> envelopes;
+    std::vector<double> ids;
+    envelopes.reserve(sources.size());
+    ids.reserve(sources.size());
+    for (size_t i = 0; i < sources.size(); i++) {
+      if (sources[i].isNull()) continue;
+      OGREnvelope envelope;
+      OGRGeometry *geom = sources[i].acquire();
+      bool empty = geom->IsEmpty();
+      if (!empty) geom->getEnvelope(&envelope);
+      sources[i].release(geom);
+      if (empty) continue;
+      envelopes.push_back(envelope);
+      ids.push_back(static_cast<double>(i));
+    }
+    return std::make_shared<STRtree>(envelopes, ids, node_size);
+  };
+  job.rval = [](std::shared_ptr<STRtree> tree, const GetFromPersistentFunc &) { return SpatialIndex::New(tree); };
+  job.run(info, async, 2);
+}
+
+/**
+ * Builds a spatial index of the features of a layer, the identifier of each
+ * feature is its FID. The features without a geometry are not indexed.
+ *
+ * The whole layer is scanned in a single operation without creating
+ * {@link Feature} objects. The layer has a single reading position which is
+ * reset, an iteration with {@link LayerFeatures.next} that is in progress
+ * restarts from the first feature.
+ *
+ * @static
+ * @throws {Error}
+ * @method fromLayer
+ * @memberof SpatialIndex
+ * @param {Layer} layer
+ * @param {SpatialIndexOptions} [options]
+ * @return {SpatialIndex}
+ */
+
+/**
+ * Builds a spatial index of the features of a layer, the identifier of each
+ * feature is its FID. The features without a geometry are not indexed.
+ *
+ * The whole layer is scanned in a single operation without creating
+ * {@link Feature} objects. The layer has a single reading position which is
+ * reset, an iteration with {@link LayerFeatures.next} that is in progress
+ * restarts from the first feature.
+ * @async
+ *
+ * @static
+ * @throws {Error}
+ * @method fromLayerAsync
+ * @memberof SpatialIndex
+ * @param {Layer} layer
+ * @param {SpatialIndexOptions} [options]
+ * @param {callback<SpatialIndex>} [callback=undefined]
+ * @return {Promise<SpatialIndex>}
+ */
+GDAL_ASYNCABLE_DEFINE(SpatialIndex::fromLayer) {
+  Layer *layer;
+  NODE_ARG_WRAPPED(0, "layer", Layer, layer);
+  Local<Object> options = Nan::New<Object>();
+  NODE_ARG_OBJECT_OPT(1, "options", options);
+  int node_size = 16;
+  NODE_INT_FROM_OBJ_OPT(options, "nodeSize", node_size);
+  if (node_size < 2) {
+    Nan::ThrowRangeError("nodeSize must be at least 2");
+    return;
+  }
+  OGRLayer *gdal_layer = layer->get();
+
+  GDALAsyncableJob<std::shared_ptr<STRtree>> job(layer->parent_uid);
+  job.persist(info[0].As<Object>());
+  job.main = [gdal_layer, node_size](const GDALExecutionProgress &) {
+    std::vector<OGREnvelope> envelopes;
+    std::vector<double> ids;
+    CPLErrorReset();
+    gdal_layer->ResetReading();
+    OGRFeature *feature;
+    while ((feature = gdal_layer->GetNextFeature()) != nullptr) {
+      OGRGeometry *geom = feature->GetGeometryRef();
+      if (geom != nullptr && !geom->IsEmpty()) {
+        OGREnvelope envelope;
+        geom->getEnvelope(&envelope);
+        envelopes.push_back(envelope);
+        ids.push_back(static_cast<double>(feature->GetFID()));
+      }
+      OGRFeature::DestroyFeature(feature);
+    }
+    gdal_layer->ResetReading();
+    if (CPLGetLastErrorType() == CE_Failure) throw CPLGetLastErrorMsg();
+    return std::make_shared<STRtree>(envelopes, ids, node_size);
+  };
+  job.rval = [](std::shared_ptr<STRtree> tree, const GetFromPersistentFunc &) { return SpatialIndex::New(tree); };
+  job.run(info, async, 2);
+}
+
+/**
+ * Finds the items whose envelopes intersect an envelope or the envelope of a geometry.
+ *
+ * @throws {Error}
+ * @method search
+ * @instance
+ * @memberof SpatialIndex
+ * @param {Envelope|Geometry} envelope
+ * @return {Float64Array} The identifiers of the items in no particular order
+ */
+
+/**
+ * Finds the items whose envelopes intersect an envelope or the envelope of a geometry.
+ * @async
+ *
+ * @throws {Error}
+ * @method searchAsync
+ * @instance
+ * @memberof SpatialIndex
+ * @param {Envelope|Geometry} envelope
+ * @param {callback<Float64Array>} [callback=undefined]
+ * @return {Promise<Float64Array>} The identifiers of the items in no particular order
+ */
+GDAL_ASYNCABLE_DEFINE(SpatialIndex::search) {
+  SpatialIndex *index = Nan::ObjectWrap::Unwrap<SpatialIndex>(info.This());
+  std::shared_ptr<STRtree> tree = index->this_;
+
+  Local<Object> obj;
+  NODE_ARG_OBJECT(0, "envelope", obj);
+  OGREnvelope envelope;
+  if (IS_WRAPPED(obj, Geometry)) {
+    Geometry *geom = Nan::ObjectWrap::Unwrap<Geometry>(obj);
+    if (!geom->isAlive()) {
+      Nan::ThrowError("Geometry object has already been destroyed");
+      return;
+    }
+    uv_sem_wait(geom->asyncLock());
+    geom->get()->getEnvelope(&envelope);
+    uv_sem_post(geom->asyncLock());
+  } else {
+    NODE_DOUBLE_FROM_OBJ(obj, "minX", envelope.MinX);
+    NODE_DOUBLE_FROM_OBJ(obj, "minY", envelope.MinY);
+    NODE_DOUBLE_FROM_OBJ(obj, "maxX", envelope.MaxX);
+    NODE_DOUBLE_FROM_OBJ(obj, "maxY", envelope.MaxY);
+  }
+
+  GDALAsyncableJob<std::shared_ptr<std::vector<double>>> job(0);
+  job.lane = AsyncLane::CPU;
+  job.main = [tree, envelope](const GDALExecutionProgress &) {
+    std::shared_ptr<std::vector<double>> result = std::make_shared<std::vector<double>>();
+    tree->search(envelope, *result);
+    return result;
+  };
+  job.rval = [](std::shared_ptr<std::vector<double>> result, const GetFromPersistentFunc &) {
+    return TypedArray::Copy(GDT_Float64, *result);
+  };
+  job.run(info, async, 1);
+}
+
+struct SpatialIndexResult {
+  std::vector<double> first, second;
+};
+
+/**
+ * Finds the `k` items nearest to a point, the distances are measured to the
+ * envelopes of the items.
+ *
+ * @throws {Error}
+ * @method nearest
+ * @instance
+ * @memberof SpatialIndex
+ * @param {Point|xyz} point
+ * @param {number} [k=1]
+ * @return {SpatialIndexNearest}
+ */
+
+/**
+ * Finds the `k` items nearest to a point, the distances are measured to the
+ * envelopes of the items.
+ * @async
+ *
+ * @throws {Error}
+ * @method nearestAsync
+ * @instance
+ * @memberof SpatialIndex
+ * @param {Point|xyz} point
+ * @param {number} [k=1]
+ * @param {callback<SpatialIndexNearest>} [callback=undefined]
+ * @return {Promise<SpatialIndexNearest>}
+ */
+GDAL_ASYNCABLE_DEFINE(SpatialIndex::nearest) {
+  SpatialIndex *index = Nan::ObjectWrap::Unwrap<SpatialIndex>(info.This());
+  std::shared_ptr<STRtree> tree = index->this_;
+
+  Local<Object> obj;
+  NODE_ARG_OBJECT(0, "point", obj);
+  double x, y;
+  if (IS_WRAPPED(obj, Point)) {
+    Point *point = Nan::ObjectWrap::Unwrap<Point>(obj);
+    if (!point->isAlive()) {
+      Nan::ThrowError("Point object has already been destroyed");
+      return;
+    }
+    x = point->get()->getX();
+    y = point->get()->getY();
+  } else {
+    NODE_DOUBLE_FROM_OBJ(obj, "x", x);
+    NODE_DOUBLE_FROM_OBJ(obj, "y", y);
+  }
+  int k = 1;
+  NODE_ARG_INT_OPT(1, "k", k);
+  if (k < 0) {
+    Nan::ThrowRangeError("k must not be negative");
+    return;
+  }
+
+  GDALAsyncableJob<std::shared_ptr<SpatialIndexResult>> job(0);
+  job.lane = AsyncLane::CPU;
+  job.main = [tree, x, y, k](const GDALExecutionProgress &) {
+    std::shared_ptr<SpatialIndexResult> result = std::make_shared<SpatialIndexResult>();
+    tree->nearest(x, y, static_cast<size_t>(k), result->first, result->second);
+    return result;
+  };
+  job.rval = [](std::shared_ptr<SpatialIndexResult> result, const GetFromPersistentFunc &) {
+    Nan::EscapableHandleScope scope;
+    Local<Object> obj = Nan::New<Object>();
+    Nan::Set(obj, Nan::New("ids").ToLocalChecked(), TypedArray::Copy(GDT_Float64, result->first));
+    Nan::Set(obj, Nan::New("distances").ToLocalChecked(), TypedArray::Copy(GDT_Float64, result->second));
+    return scope.Escape(obj.As<Value>());
+  };
+  job.run(info, async, 2);
+}
+
+/**
+ * Finds all the pairs of items of this index and of another index whose
+ * envelopes intersect. Both indexes are traversed together, which is much
+ * faster than searching the envelopes of one index in the other.
+ *
+ * @throws {Error}
+ * @method join
+ * @instance
+ * @memberof SpatialIndex
+ * @param {SpatialIndex} other
+ * @return {SpatialIndexJoin}
+ */
+
+/**
+ * Finds all the pairs of items of this index and of another index whose
+ * envelopes intersect. Both indexes are traversed together, which is much
+ * faster than searching the envelopes of one index in the other.
+ * @async
+ *
+ * @throws {Error}
+ * @method joinAsync
+ * @instance
+ * @memberof SpatialIndex
+ * @param {SpatialIndex} other
+ * @param {callback<SpatialIndexJoin>} [callback=undefined]
+ * @return {Promise<SpatialIndexJoin>}
+ */
+GDAL_ASYNCABLE_DEFINE(SpatialIndex::join) {
+  SpatialIndex *index = Nan::ObjectWrap::Unwrap<SpatialIndex>(info.This());
+  std::shared_ptr<STRtree> tree = index->this_;
+  SpatialIndex *other;
+  NODE_ARG_WRAPPED(0, "other", SpatialIndex, other);
+  std::shared_ptr<STRtree> other_tree = other->this_;
+
+  GDALAsyncableJob<std::shared_ptr<SpatialIndexResult>> job(0);
+  job.lane = AsyncLane::CPU;
+  job.main = [tree, other_tree](const GDALExecutionProgress &) {
+    std::shared_ptr<SpatialIndexResult> result = std::make_shared<SpatialIndexResult>();
+    tree->join(*other_tree, result->first, result->second);
+    return result;
+  };
+  job.rval = [](std::shared_ptr<SpatialIndexResult> result, const GetFromPersistentFunc &) {
+    Nan::EscapableHandleScope scope;
+    Local<Object> obj = Nan::New<Object>();
+    Nan::Set(obj, Nan::New("left").ToLocalChecked(), TypedArray::Copy(GDT_Float64, result->first));
+    Nan::Set(obj, Nan::New("right").ToLocalChecked(), TypedArray::Copy(GDT_Float64, result->second));
+    return scope.Escape(obj.As<Value>());
+  };
+  job.run(info, async, 1);
+}
+
+/**
+ * The number of indexed items.
+ *
+ * @kind member
+ * @name count
+ * @instance
+ * @memberof SpatialIndex
+ * @type {number}
+ */
+NAN_GETTER(SpatialIndex::countGetter) {
+  SpatialIndex *index = Nan::ObjectWrap::Unwrap<SpatialIndex>(info.This());
+  info.GetReturnValue().Set(Nan::New<Number>(static_cast<double>(index->this_->size())));
+}
+
+} // namespace node_gdal
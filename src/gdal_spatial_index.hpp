@@ -0,0 +1,52 @@
+#ifndef __NODE_GDAL_SPATIAL_INDEX_H__
+#define __NODE_GDAL_SPATIAL_INDEX_H__
+
+#include <memory>
+
+// node
+#include <node.h>
+#include <node_object_wrap.h>
+
+// nan
+#include "nan-wrapper.h"
+
+#include "async.hpp"
+#include "utils/strtree.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+class SpatialIndex : public Nan::ObjectWrap {
+    public:
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
+  static void Initialize(Local<Object> target);
+  static NAN_METHOD(New);
+  static Local<Value> New(std::shared_ptr<STRtree> tree);
+  static NAN_METHOD(toString);
+  GDAL_ASYNCABLE_DECLARE(fromGeometries);
+  GDAL_ASYNCABLE_DECLARE(fromLayer);
+  GDAL_ASYNCABLE_DECLARE(search);
+  GDAL_ASYNCABLE_DECLARE(nearest);
+  GDAL_ASYNCABLE_DECLARE(join);
+
+  static NAN_GETTER(countGetter);
+
+  SpatialIndex();
+  SpatialIndex(std::shared_ptr<STRtree> tree);
+  inline std::shared_ptr<STRtree> get() {
+    return this_;
+  }
+  inline bool isAlive() {
+    return this_ != nullptr;
+  }
+
+    private:
+  ~SpatialIndex();
+  // Immutable once built, the queries are safe to run concurrently
+  std::shared_ptr<STRtree> this_;
+};
+
+} // namespace node_gdal
+#endif
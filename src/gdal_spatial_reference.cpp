@@ -2,11 +2,12 @@
 #include "gdal_spatial_reference.hpp"
 #include "gdal_common.hpp"
 #include "utils/string_list.hpp"
+#include "utils/proj_cache.hpp"
 #include "async.hpp"
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> SpatialReference::constructor;
+thread_local Nan::Persistent<FunctionTemplate> SpatialReference::constructor;
 
 void SpatialReference::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -552,12 +553,16 @@ NAN_METHOD(SpatialReference::fromWKT) {
 
   std::string wkt("");
   NODE_ARG_STR(0, "wkt", wkt);
-  OGRChar *str = (OGRChar *)wkt.c_str();
 
-  OGRSpatialReference *srs = new OGRSpatialReference();
-  int err = srs->importFromWkt(&str);
+  OGRSpatialReference *srs;
+  int err = proj_cache.spatialReference(
+    "WKT:" + wkt,
+    [&wkt](OGRSpatialReference *ref) {
+      OGRChar *str = (OGRChar *)wkt.c_str();
+      return ref->importFromWkt(&str);
+    },
+    srs);
   if (err) {
-    delete srs;
     NODE_THROW_OGRERR(err);
     return;
   }
@@ -581,10 +586,10 @@ NAN_METHOD(SpatialReference::fromProj4) {
   std::string input("");
   NODE_ARG_STR(0, "input", input);
 
-  OGRSpatialReference *srs = new OGRSpatialReference();
-  int err = srs->importFromProj4(input.c_str());
+  OGRSpatialReference *srs;
+  int err = proj_cache.spatialReference(
+    "PROJ4:" + input, [&input](OGRSpatialReference *ref) { return ref->importFromProj4(input.c_str()); }, srs);
   if (err) {
-    delete srs;
     NODE_THROW_OGRERR(err);
     return;
   }
@@ -674,10 +679,10 @@ NAN_METHOD(SpatialReference::fromURN) {
   std::string input("");
   NODE_ARG_STR(0, "input", input);
 
-  OGRSpatialReference *srs = new OGRSpatialReference();
-  int err = srs->importFromURN(input.c_str());
+  OGRSpatialReference *srs;
+  int err = proj_cache.spatialReference(
+    "URN:" + input, [&input](OGRSpatialReference *ref) { return ref->importFromURN(input.c_str()); }, srs);
   if (err) {
-    delete srs;
     NODE_THROW_OGRERR(err);
     return;
   }
@@ -854,12 +859,10 @@ GDAL_ASYNCABLE_DEFINE(SpatialReference::fromUserInput) {
   GDALAsyncableJob<OGRSpatialReference *> job(0);
 
   job.main = [input](const GDALExecutionProgress &progress) {
-    OGRSpatialReference *srs = new OGRSpatialReference();
-    int err = srs->SetFromUserInput(input.c_str());
-    if (err) {
-      delete srs;
-      throw getOGRErrMsg(err);
-    }
+    OGRSpatialReference *srs;
+    int err = proj_cache.spatialReference(
+      "USER:" + input, [&input](OGRSpatialReference *ref) { return ref->SetFromUserInput(input.c_str()); }, srs);
+    if (err) throw getOGRErrMsg(err);
     return srs;
   };
   job.rval = [](OGRSpatialReference *srs, const GetFromPersistentFunc &) { return SpatialReference::New(srs, true); };
@@ -886,10 +889,10 @@ NAN_METHOD(SpatialReference::fromEPSG) {
   int epsg;
   NODE_ARG_INT(0, "epsg", epsg);
 
-  OGRSpatialReference *srs = new OGRSpatialReference();
-  int err = srs->importFromEPSG(epsg);
+  OGRSpatialReference *srs;
+  int err = proj_cache.spatialReference(
+    "EPSG:" + std::to_string(epsg), [epsg](OGRSpatialReference *ref) { return ref->importFromEPSG(epsg); }, srs);
   if (err) {
-    delete srs;
     NODE_THROW_OGRERR(err);
     return;
   }
@@ -923,10 +926,10 @@ NAN_METHOD(SpatialReference::fromEPSGA) {
   int epsg;
   NODE_ARG_INT(0, "epsg", epsg);
 
-  OGRSpatialReference *srs = new OGRSpatialReference();
-  int err = srs->importFromEPSGA(epsg);
+  OGRSpatialReference *srs;
+  int err = proj_cache.spatialReference(
+    "EPSGA:" + std::to_string(epsg), [epsg](OGRSpatialReference *ref) { return ref->importFromEPSGA(epsg); }, srs);
   if (err) {
-    delete srs;
     NODE_THROW_OGRERR(err);
     return;
   }
@@ -26,6 +26,7 @@ void Utils::Initialize(Local<Object> target) {
 /**
  * @typedef {object} UtilOptions
  * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
  */
 
 /**
@@ -89,13 +90,14 @@ GDAL_ASYNCABLE_DEFINE(Utils::translate) {
   if (!options.IsEmpty()) NODE_CB_FROM_OBJ_OPT(options, "progress_cb", progress_cb);
 
   GDALAsyncableJob<GDALDataset *> job(ds->uid);
+  job.lane = AsyncLane::CPU;
   job.progress = progress_cb;
-  job.main = [raw, dst, aosOptions, progress_cb](const GDALExecutionProgress &progress) {
+  job.main = [raw, dst, aosOptions](const GDALExecutionProgress &progress) {
     CPLErrorReset();
     auto b = aosOptions;
     auto psOptions = GDALTranslateOptionsNew(aosOptions->List(), nullptr);
     if (psOptions == nullptr) throw CPLGetLastErrorMsg();
-    if (progress_cb) GDALTranslateOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+    if (progress.enabled()) GDALTranslateOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
     GDALDataset *r = GDALDatasetFromHandle(GDALTranslate(dst.c_str(), GDALDatasetToHandle(raw), psOptions, nullptr));
     GDALTranslateOptionsFree(psOptions);
     if (r == nullptr) throw CPLGetLastErrorMsg();
@@ -185,15 +187,16 @@ GDAL_ASYNCABLE_DEFINE(Utils::vectorTranslate) {
   std::vector<long> uids = {ds->uid};
   if (dst_ds != nullptr) uids.push_back(dst_ds->uid);
   GDALAsyncableJob<GDALDataset *> job(uids);
+  job.lane = AsyncLane::CPU;
   job.progress = progress_cb;
 
-  job.main = [src_raw, dst_filename, dst_raw, aosOptions, progress_cb](const GDALExecutionProgress &progress) {
+  job.main = [src_raw, dst_filename, dst_raw, aosOptions](const GDALExecutionProgress &progress) {
     CPLErrorReset();
-    if (progress_cb) aosOptions->AddString("-progress");
+    if (progress.enabled()) aosOptions->AddString("-progress");
     auto psOptions = GDALVectorTranslateOptionsNew(aosOptions->List(), nullptr);
     if (psOptions == nullptr) throw CPLGetLastErrorMsg();
 
-    if (progress_cb) GDALVectorTranslateOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+    if (progress.enabled()) GDALVectorTranslateOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
 
     auto srcH = GDALDatasetToHandle(src_raw);
     GDALDataset *r = GDALDatasetFromHandle(
@@ -360,14 +363,15 @@ GDAL_ASYNCABLE_DEFINE(Utils::warp) {
   if (!options.IsEmpty()) NODE_CB_FROM_OBJ_OPT(options, "progress_cb", progress_cb);
 
   GDALAsyncableJob<GDALDataset *> job(uids);
+  job.lane = AsyncLane::CPU;
   int src_count = src_ds->Length();
   job.progress = progress_cb;
   job.main =
-    [dst_path, gdal_dst_ds, src_count, gdal_src_ds, aosOptions, progress_cb](const GDALExecutionProgress &progress) {
+    [dst_path, gdal_dst_ds, src_count, gdal_src_ds, aosOptions](const GDALExecutionProgress &progress) {
       CPLErrorReset();
       auto psOptions = GDALWarpAppOptionsNew(aosOptions->List(), nullptr);
       if (psOptions == nullptr) throw CPLGetLastErrorMsg();
-      if (progress_cb) GDALWarpAppOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+      if (progress.enabled()) GDALWarpAppOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
       GDALDatasetH r = GDALWarp(
         dst_path.length() > 0 ? dst_path.c_str() : nullptr,
         gdal_dst_ds,
@@ -487,11 +491,11 @@ GDAL_ASYNCABLE_DEFINE(Utils::buildvrt) {
   int src_count = src_ds->Length();
   job.progress = progress_cb;
   job.main =
-    [dst_path, src_count, gdalSrcDs, aosSrcDs, aosOptions, progress_cb](const GDALExecutionProgress &progress) {
+    [dst_path, src_count, gdalSrcDs, aosSrcDs, aosOptions](const GDALExecutionProgress &progress) {
       CPLErrorReset();
       auto psOptions = GDALBuildVRTOptionsNew(aosOptions->List(), nullptr);
       if (psOptions == nullptr) throw CPLGetLastErrorMsg();
-      if (progress_cb) GDALBuildVRTOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+      if (progress.enabled()) GDALBuildVRTOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
 
       GDALDatasetH r = GDALBuildVRT(
         dst_path.c_str(),
@@ -594,12 +598,13 @@ GDAL_ASYNCABLE_DEFINE(Utils::rasterize) {
   if (!options.IsEmpty()) NODE_CB_FROM_OBJ_OPT(options, "progress_cb", progress_cb);
 
   GDALAsyncableJob<GDALDataset *> job(ds->uid);
+  job.lane = AsyncLane::CPU;
   job.progress = progress_cb;
-  job.main = [dst_path, dst_raw, src_raw, aosOptions, progress_cb](const GDALExecutionProgress &progress) {
+  job.main = [dst_path, dst_raw, src_raw, aosOptions](const GDALExecutionProgress &progress) {
     CPLErrorReset();
     auto psOptions = GDALRasterizeOptionsNew(aosOptions->List(), nullptr);
     if (psOptions == nullptr) throw CPLGetLastErrorMsg();
-    if (progress_cb) GDALRasterizeOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+    if (progress.enabled()) GDALRasterizeOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
 
     GDALDatasetH r = GDALRasterize(
       dst_path.length() > 0 ? dst_path.c_str() : nullptr,
@@ -689,12 +694,13 @@ GDAL_ASYNCABLE_DEFINE(Utils::dem) {
   if (!options.IsEmpty()) NODE_CB_FROM_OBJ_OPT(options, "progress_cb", progress_cb);
 
   GDALAsyncableJob<GDALDataset *> job(ds->uid);
+  job.lane = AsyncLane::CPU;
   job.progress = progress_cb;
-  job.main = [dst_path, mode, raw, colorFilename, aosOptions, progress_cb](const GDALExecutionProgress &progress) {
+  job.main = [dst_path, mode, raw, colorFilename, aosOptions](const GDALExecutionProgress &progress) {
     CPLErrorReset();
     auto psOptions = GDALDEMProcessingOptionsNew(aosOptions->List(), nullptr);
     if (psOptions == nullptr) throw CPLGetLastErrorMsg();
-    if (progress_cb) GDALDEMProcessingOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
+    if (progress.enabled()) GDALDEMProcessingOptionsSetProgress(psOptions, ProgressTrampoline, (void *)&progress);
     GDALDataset *r = GDALDatasetFromHandle(GDALDEMProcessing(
       dst_path.c_str(),
       GDALDatasetToHandle(raw),
@@ -31,6 +31,7 @@ void Warper::Initialize(Local<Object> target) {
  * @property {boolean} [multi]
  * @property {object} [options]
  * @property {ProgressCb} [progress_cb]
+ * @property {AbortSignal} [signal]
  */
 
 /*
@@ -285,13 +286,14 @@ GDAL_ASYNCABLE_DEFINE(Warper::reprojectImage) {
 
   std::vector<long> uids = options->datasetUids();
   GDALAsyncableJob<CPLErr> job(uids);
+  job.lane = AsyncLane::CPU;
 
   job.progress = progress_cb;
 
   // opts is a pointer inside options memory space
   // the lifetime of the options shared_ptr is limited by the lifetime of the lambda
   if (options->useMultithreading()) {
-    job.main = [options, opts, s_srs_str, t_srs_str, maxError, progress_cb](const GDALExecutionProgress &progress) {
+    job.main = [options, opts, s_srs_str, t_srs_str, maxError](const GDALExecutionProgress &progress) {
       CPLErrorReset();
       CPLErr err = GDALReprojectImageMulti(
         opts->hSrcDS,
@@ -301,14 +303,14 @@ GDAL_ASYNCABLE_DEFINE(Warper::reprojectImage) {
         opts->eResampleAlg,
         opts->dfWarpMemoryLimit,
         maxError,
-        progress_cb ? ProgressTrampoline : nullptr,
-        progress_cb ? (void *)&progress : nullptr,
+        progress.enabled() ? ProgressTrampoline : nullptr,
+        progress.enabled() ? (void *)&progress : nullptr,
         opts);
       if (err) { throw CPLGetLastErrorMsg(); }
       return err;
     };
   } else {
-    job.main = [options, opts, s_srs_str, t_srs_str, maxError, progress_cb](const GDALExecutionProgress &progress) {
+    job.main = [options, opts, s_srs_str, t_srs_str, maxError](const GDALExecutionProgress &progress) {
       CPLErrorReset();
       CPLErr err = GDALReprojectImage(
         opts->hSrcDS,
@@ -318,8 +320,8 @@ GDAL_ASYNCABLE_DEFINE(Warper::reprojectImage) {
         opts->eResampleAlg,
         opts->dfWarpMemoryLimit,
         maxError,
-        progress_cb ? ProgressTrampoline : nullptr,
-        progress_cb ? (void *)&progress : nullptr,
+        progress.enabled() ? ProgressTrampoline : nullptr,
+        progress.enabled() ? (void *)&progress : nullptr,
         opts);
       if (err) { throw CPLGetLastErrorMsg(); }
       return err;
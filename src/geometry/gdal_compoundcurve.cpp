@@ -9,7 +9,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> CompoundCurve::constructor;
+thread_local Nan::Persistent<FunctionTemplate> CompoundCurve::constructor;
 
 void CompoundCurve::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -13,17 +13,24 @@
 #include "gdal_multipolygon.hpp"
 #include "gdal_point.hpp"
 #include "gdal_polygon.hpp"
+#include "gdal_prepared_geometry.hpp"
 #include "../gdal_spatial_reference.hpp"
+#include "../utils/geometry_list.hpp"
+#include "../utils/proj_cache.hpp"
+#include "../utils/typed_array.hpp"
 
 #include <node_buffer.h>
 #include <ogr_core.h>
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <sstream>
+#include <utility>
 #include <stdlib.h>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Geometry::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Geometry::constructor;
 
 void Geometry::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -37,6 +44,9 @@ void Geometry::Initialize(Local<Object> target) {
   Nan__SetAsyncableMethod(lcons, "fromWKB", Geometry::createFromWkb);
   Nan__SetAsyncableMethod(lcons, "fromGeoJson", Geometry::createFromGeoJson);
   Nan__SetAsyncableMethod(lcons, "fromGeoJsonBuffer", Geometry::createFromGeoJsonBuffer);
+  Nan__SetAsyncableMethod(lcons, "fromWKBBatch", Geometry::createFromWkbBatch);
+  Nan__SetAsyncableMethod(lcons, "fromGeoJsonBufferBatch", Geometry::createFromGeoJsonBufferBatch);
+  Nan__SetAsyncableMethod(lcons, "toWKBBatch", Geometry::exportToWKBBatch);
   Nan::SetMethod(lcons, "getName", Geometry::getName);
   Nan::SetMethod(lcons, "getConstructor", Geometry::getConstructor);
 
@@ -79,6 +89,7 @@ void Geometry::Initialize(Local<Object> target) {
   Nan__SetPrototypeAsyncableMethod(lcons, "flattenTo2D", flattenTo2D);
   Nan__SetPrototypeAsyncableMethod(lcons, "transform", transform);
   Nan__SetPrototypeAsyncableMethod(lcons, "transformTo", transformTo);
+  Nan__SetPrototypeAsyncableMethod(lcons, "prepare", prepare);
 #if GDAL_VERSION_MAJOR >= 3
   Nan__SetPrototypeAsyncableMethod(lcons, "makeValid", makeValid);
 #endif
@@ -620,8 +631,93 @@ NODE_WRAPPED_ASYNC_METHOD_WITH_OGRERR_RESULT_1_WRAPPED_PARAM(
  * @return {Promise<void>}
  */
 
-NODE_WRAPPED_ASYNC_METHOD_WITH_OGRERR_RESULT_1_WRAPPED_PARAM(
-  Geometry, int, transformTo, transformTo, SpatialReference, "spatial reference");
+GDAL_ASYNCABLE_DEFINE(Geometry::transformTo) {
+  SpatialReference *srs;
+  NODE_ARG_WRAPPED(0, "spatial reference", SpatialReference, srs);
+  Geometry *geom = Nan::ObjectWrap::Unwrap<Geometry>(info.This());
+  if (!geom->isAlive()) {
+    Nan::ThrowError("Geometry object has already been destroyed");
+    return;
+  }
+  OGRGeometry *gdal_geom = geom->this_;
+  OGRSpatialReference *gdal_srs = srs->get();
+
+  GDALAsyncableJob<int> job(0);
+  job.lane = AsyncLane::CPU;
+  job.persist(info[0].As<Object>());
+  // Same as OGRGeometry::transformTo() but the transformation comes from the cache
+  job.main = [gdal_geom, gdal_srs](const GDALExecutionProgress &) {
+    OGRSpatialReference *source = gdal_geom->getSpatialReference();
+    if (source == nullptr) throw getOGRErrMsg(OGRERR_FAILURE);
+    OGRCoordinateTransformation *ct = proj_cache.transformation(source, gdal_srs);
+    if (ct == nullptr) throw getOGRErrMsg(OGRERR_FAILURE);
+    int err = gdal_geom->transform(ct);
+    OGRCoordinateTransformation::DestroyCT(ct);
+    if (err) throw getOGRErrMsg(err);
+    return err;
+  };
+  job.rval = [](int, const GetFromPersistentFunc &) { return Nan::Undefined().As<Value>(); };
+  job.run(info, async, 1);
+}
+
+/**
+ * Prepares the geometry for evaluating the same spatial predicate against
+ * many other geometries.
+ *
+ * The GEOS structures are built once instead of once per comparison.
+ * Requires GDAL to be built with GEOS.
+ *
+ * @throws {Error}
+ * @method prepare
+ * @instance
+ * @memberof Geometry
+ * @return {PreparedGeometry}
+ */
+
+/**
+ * Prepares the geometry for evaluating the same spatial predicate against
+ * many other geometries.
+ *
+ * The GEOS structures are built once instead of once per comparison.
+ * Requires GDAL to be built with GEOS.
+ * @async
+ *
+ * @throws {Error}
+ * @method prepareAsync
+ * @instance
+ * @memberof Geometry
+ * @param {callback<PreparedGeometry>} [callback=undefined]
+ * @return {Promise<PreparedGeometry>}
+ */
+GDAL_ASYNCABLE_DEFINE(Geometry::prepare) {
+  Geometry *geom = Nan::ObjectWrap::Unwrap<Geometry>(info.This());
+  if (!geom->isAlive()) {
+    Nan::ThrowError("Geometry object has already been destroyed");
+    return;
+  }
+  if (!OGRHasPreparedGeometrySupport()) {
+    Nan::ThrowError("GDAL was built without GEOS, prepared geometries are not supported");
+    return;
+  }
+  OGRGeometry *gdal_geom = geom->this_;
+  uv_sem_t *async_lock = geom->async_lock;
+
+  GDALAsyncableJob<std::pair<OGRPreparedGeometry *, OGREnvelope>> job(0);
+  job.lane = AsyncLane::CPU;
+  job.main = [gdal_geom, async_lock](const GDALExecutionProgress &) {
+    uv_sem_wait(async_lock);
+    OGRPreparedGeometry *prepared = OGRCreatePreparedGeometry(gdal_geom);
+    OGREnvelope envelope;
+    gdal_geom->getEnvelope(&envelope);
+    uv_sem_post(async_lock);
+    if (prepared == nullptr) throw CPLGetLastErrorMsg();
+    return std::make_pair(prepared, envelope);
+  };
+  job.rval = [](std::pair<OGRPreparedGeometry *, OGREnvelope> r, const GetFromPersistentFunc &) {
+    return PreparedGeometry::New(r.first, r.second);
+  };
+  job.run(info, async, 0);
+}
 
 /**
  * Clones the instance.
@@ -662,6 +758,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::convexHull) {
   Geometry *geom = Nan::ObjectWrap::Unwrap<Geometry>(info.This());
   OGRGeometry *gdal_geom = geom->this_;
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [gdal_geom](const GDALExecutionProgress &) {
     CPLErrorReset();
     auto r = gdal_geom->ConvexHull();
@@ -698,6 +795,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::boundary) {
   Geometry *geom = Nan::ObjectWrap::Unwrap<Geometry>(info.This());
   OGRGeometry *gdal_geom = geom->this_;
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [gdal_geom](const GDALExecutionProgress &) {
     CPLErrorReset();
     auto r = gdal_geom->Boundary();
@@ -742,6 +840,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::intersection) {
   OGRGeometry *gdal_geom = geom->this_;
   OGRGeometry *gdal_x = x->this_;
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [gdal_geom, gdal_x](const GDALExecutionProgress &) {
     CPLErrorReset();
     auto r = gdal_geom->Intersection(gdal_x);
@@ -786,6 +885,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::unionGeometry) {
   OGRGeometry *gdal_geom = geom->this_;
   OGRGeometry *gdal_x = x->this_;
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [gdal_geom, gdal_x](const GDALExecutionProgress &) {
     CPLErrorReset();
     auto r = gdal_geom->Union(gdal_x);
@@ -830,6 +930,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::difference) {
   OGRGeometry *gdal_geom = geom->this_;
   OGRGeometry *gdal_x = x->this_;
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [gdal_geom, gdal_x](const GDALExecutionProgress &) {
     CPLErrorReset();
     auto r = gdal_geom->Difference(gdal_x);
@@ -874,6 +975,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::symDifference) {
   OGRGeometry *gdal_geom = geom->this_;
   OGRGeometry *gdal_x = x->this_;
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [gdal_geom, gdal_x](const GDALExecutionProgress &) {
     CPLErrorReset();
     auto r = gdal_geom->SymDifference(gdal_x);
@@ -917,6 +1019,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::simplify) {
   OGRGeometry *gdal_geom = geom->this_;
 
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [gdal_geom, tolerance](const GDALExecutionProgress &) {
     CPLErrorReset();
     auto r = gdal_geom->Simplify(tolerance);
@@ -960,6 +1063,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::simplifyPreserveTopology) {
   OGRGeometry *gdal_geom = geom->this_;
 
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [gdal_geom, tolerance](const GDALExecutionProgress &) {
     CPLErrorReset();
     auto r = gdal_geom->SimplifyPreserveTopology(tolerance);
@@ -1009,6 +1113,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::buffer) {
   OGRGeometry *gdal_geom = geom->this_;
 
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [gdal_geom, distance, number_of_segments](const GDALExecutionProgress &) {
     CPLErrorReset();
     auto r = gdal_geom->Buffer(distance, number_of_segments);
@@ -1048,6 +1153,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::makeValid) {
   Geometry *geom = Nan::ObjectWrap::Unwrap<Geometry>(info.This());
   OGRGeometry *gdal_geom = geom->this_;
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [gdal_geom](const GDALExecutionProgress &) {
     CPLErrorReset();
     auto r = gdal_geom->MakeValid();
@@ -1088,6 +1194,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::exportToWKT) {
   OGRGeometry *gdal_geom = geom->this_;
   uv_sem_t *async_lock = geom->async_lock;
   GDALAsyncableJob<char *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [async_lock, gdal_geom](const GDALExecutionProgress &) {
     char *text = NULL;
     uv_sem_wait(async_lock);
@@ -1176,6 +1283,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::exportToWKB) {
   OGRGeometry *gdal_geom = geom->this_;
   uv_sem_t *async_lock = geom->async_lock;
   GDALAsyncableJob<unsigned char *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [async_lock, gdal_geom, data, byte_order, wkb_variant](const GDALExecutionProgress &) {
     uv_sem_wait(async_lock);
     OGRErr err = gdal_geom->exportToWkb(byte_order, data, wkb_variant);
@@ -1237,6 +1345,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::exportToKML) {
   OGRGeometry *gdal_geom = geom->this_;
   uv_sem_t *async_lock = geom->async_lock;
   GDALAsyncableJob<char *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [async_lock, gdal_geom](const GDALExecutionProgress &) {
     CPLErrorReset();
     uv_sem_wait(async_lock);
@@ -1285,6 +1394,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::exportToGML) {
   OGRGeometry *gdal_geom = geom->this_;
   uv_sem_t *async_lock = geom->async_lock;
   GDALAsyncableJob<char *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [async_lock, gdal_geom](const GDALExecutionProgress &) {
     CPLErrorReset();
     uv_sem_wait(async_lock);
@@ -1333,6 +1443,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::exportToJSON) {
   OGRGeometry *gdal_geom = geom->this_;
   uv_sem_t *async_lock = geom->async_lock;
   GDALAsyncableJob<char *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [async_lock, gdal_geom](const GDALExecutionProgress &) {
     CPLErrorReset();
     uv_sem_wait(async_lock);
@@ -1385,6 +1496,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::centroid) {
   OGRGeometry *gdal_geom = geom->this_;
   uv_sem_t *async_lock = geom->async_lock;
   GDALAsyncableJob<OGRPoint *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [async_lock, gdal_geom](const GDALExecutionProgress &) {
     OGRPoint *point = new OGRPoint();
     uv_sem_wait(async_lock);
@@ -1431,6 +1543,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::getEnvelope) {
   uv_sem_t *async_lock = geom->async_lock;
 
   GDALAsyncableJob<OGREnvelope *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [async_lock, gdal_geom](const GDALExecutionProgress &) {
     OGREnvelope *envelope = new OGREnvelope();
     uv_sem_wait(async_lock);
@@ -1483,6 +1596,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::getEnvelope3D) {
   uv_sem_t *async_lock = geom->async_lock;
 
   GDALAsyncableJob<OGREnvelope3D *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [async_lock, gdal_geom](const GDALExecutionProgress &) {
     OGREnvelope3D *envelope = new OGREnvelope3D();
     uv_sem_wait(async_lock);
@@ -1569,6 +1683,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::createFromWkt) {
   if (srs) { ogr_srs = srs->get(); }
 
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [wkt_string, ogr_srs](const GDALExecutionProgress &) {
     std::unique_ptr<std::string> wkt_string_ptr(wkt_string);
     OGRGeometry *geom = NULL;
@@ -1632,6 +1747,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::createFromWkb) {
   if (srs) { ogr_srs = srs->get(); }
 
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [data, length, ogr_srs](const GDALExecutionProgress &) {
     OGRGeometry *geom = NULL;
     OGRErr err = OGRGeometryFactory::createFromWkb(data, ogr_srs, &geom, length);
@@ -1698,6 +1814,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::createFromGeoJson) {
   std::string *val = new std::string(*Nan::Utf8String(stringified));
 
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [val](const GDALExecutionProgress &) {
     CPLErrorReset();
     std::unique_ptr<std::string> val_ptr(val);
@@ -1757,6 +1874,7 @@ GDAL_ASYNCABLE_DEFINE(Geometry::createFromGeoJsonBuffer) {
   size_t length = Buffer::Length(geojson_obj);
 
   GDALAsyncableJob<OGRGeometry *> job(0);
+  job.lane = AsyncLane::CPU;
   job.main = [data, length](const GDALExecutionProgress &) {
     CPLErrorReset();
     CPLJSONDocument oDocument;
@@ -1773,6 +1891,326 @@ GDAL_ASYNCABLE_DEFINE(Geometry::createFromGeoJsonBuffer) {
 #endif
 }
 
+/**
+ * @typedef {object} WKBBatch
+ * @property {Buffer} values The WKB geometries one after another
+ * @property {Int32Array} offsets The start of each geometry in `values` followed by the end of the last one,
+ * the `null` geometries are empty
+ */
+
+// The offsets use the layout of the Apache Arrow binary columns, the one of the
+// geometry column of LayerFeatures.readBatch()
+void Geometry::createFromBatch(const Nan::FunctionCallbackInfo<v8::Value> &info, bool async, bool geojson) {
+#if GDAL_VERSION_MAJOR == 2 && GDAL_VERSION_MINOR < 3
+  if (geojson) {
+    Nan::ThrowError("GDAL < 2.3 does not support parsing GeoJSON directly");
+    return;
+  }
+#endif
+  Local<Object> values_obj;
+  NODE_ARG_OBJECT(0, "values", values_obj);
+  if (!Buffer::HasInstance(values_obj)) {
+    Nan::ThrowTypeError("values must be a Buffer or an Uint8Array");
+    return;
+  }
+  if (info.Length() < 2 || !info[1]->IsInt32Array()) {
+    Nan::ThrowTypeError("offsets must be an Int32Array");
+    return;
+  }
+  SpatialReference *srs = NULL;
+  if (!geojson) { NODE_ARG_WRAPPED_OPT(2, "srs", SpatialReference, srs); }
+
+  unsigned char *data = reinterpret_cast<unsigned char *>(Buffer::Data(values_obj));
+  size_t length = Buffer::Length(values_obj);
+  Nan::TypedArrayContents<int32_t> offsets_contents(info[1]);
+  if (offsets_contents.length() < 1) {
+    Nan::ThrowRangeError("offsets must contain at least one element");
+    return;
+  }
+  int32_t *offsets = *offsets_contents;
+  size_t count = offsets_contents.length() - 1;
+  OGRSpatialReference *ogr_srs = srs ? srs->get() : nullptr;
+
+  GDALAsyncableJob<std::shared_ptr<std::vector<OGRGeometry *>>> job(0);
+  job.lane = AsyncLane::CPU;
+  job.persist("values", values_obj);
+  job.persist("offsets", info[1].As<Object>());
+  if (srs) job.persist("srs", info[2].As<Object>());
+  job.main = [data, length, offsets, count, ogr_srs, geojson](const GDALExecutionProgress &) {
+    std::shared_ptr<std::vector<OGRGeometry *>> geoms = std::make_shared<std::vector<OGRGeometry *>>(count, nullptr);
+    const char *error = nullptr;
+    CPLErrorReset();
+    for (size_t i = 0; i < count && error == nullptr; i++) {
+      int32_t start = offsets[i], end = offsets[i + 1];
+      if (start < 0 || end < start || static_cast<size_t>(end) > length) {
+        error = "offsets must be increasing and within values";
+        break;
+      }
+      if (start == end) continue;
+      if (geojson) {
+#if GDAL_VERSION_MAJOR > 2 || (GDAL_VERSION_MAJOR == 2 && GDAL_VERSION_MINOR >= 3)
+        CPLJSONDocument oDocument;
+        if (!oDocument.LoadMemory(data + start, end - start)) {
+          error = "Parsing the GeoJSON fragment failed";
+          break;
+        }
+        (*geoms)[i] = OGRGeometryFactory::createFromGeoJson(oDocument.GetRoot());
+        if ((*geoms)[i] == nullptr) error = CPLGetLastErrorMsg();
+#endif
+      } else {
+        OGRErr err = OGRGeometryFactory::createFromWkb(data + start, ogr_srs, &(*geoms)[i], end - start);
+        if (err) error = getOGRErrMsg(err);
+      }
+    }
+    if (error != nullptr) {
+      for (OGRGeometry *geom : *geoms)
+        if (geom != nullptr) OGRGeometryFactory::destroyGeometry(geom);
+      throw error;
+    }
+    return geoms;
+  };
+  job.rval = [](std::shared_ptr<std::vector<OGRGeometry *>> geoms, const GetFromPersistentFunc &) {
+    Nan::EscapableHandleScope scope;
+    Local<Array> result = Nan::New<Array>(geoms->size());
+    for (size_t i = 0; i < geoms->size(); i++)
+      Nan::Set(result, static_cast<uint32_t>(i), Geometry::New((*geoms)[i], true));
+    return scope.Escape(result.As<Value>());
+  };
+  job.run(info, async, geojson ? 2 : 3);
+}
+
+/**
+ * Creates Geometries from WKB geometries stored one after another in a single buffer,
+ * such as the geometry column of {@link LayerFeatures#readBatch} or the result of
+ * {@link Geometry.toWKBBatch}.
+ *
+ * All the geometries are parsed in a single call, the empty entries produce `null`.
+ *
+ * @static
+ * @method fromWKBBatch
+ * @instance
+ * @memberof Geometry
+ * @throws {Error}
+ * @param {Buffer|Uint8Array} values
+ * @param {Int32Array} offsets The start of each geometry followed by the end of the last one
+ * @param {SpatialReference} [srs]
+ * @return {(Geometry|null)[]}
+ */
+
+/**
+ * Creates Geometries from WKB geometries stored one after another in a single buffer,
+ * such as the geometry column of {@link LayerFeatures#readBatch} or the result of
+ * {@link Geometry.toWKBBatch}.
+ *
+ * All the geometries are parsed in a single job, the empty entries produce `null`.
+ * @async
+ *
+ * @static
+ * @method fromWKBBatchAsync
+ * @instance
+ * @memberof Geometry
+ * @throws {Error}
+ * @param {Buffer|Uint8Array} values
+ * @param {Int32Array} offsets The start of each geometry followed by the end of the last one
+ * @param {SpatialReference} [srs]
+ * @param {callback<(Geometry|null)[]>} [callback=undefined]
+ * @return {Promise<(Geometry|null)[]>}
+ */
+GDAL_ASYNCABLE_DEFINE(Geometry::createFromWkbBatch) {
+  createFromBatch(info, async, false);
+}
+
+/**
+ * Creates Geometries from GeoJSON fragments in UTF8 format stored one after another
+ * in a single buffer.
+ *
+ * All the geometries are parsed in a single call, the empty entries produce `null`.
+ *
+ * @static
+ * @method fromGeoJsonBufferBatch
+ * @instance
+ * @memberof Geometry
+ * @throws {Error}
+ * @param {Buffer|Uint8Array} values
+ * @param {Int32Array} offsets The start of each fragment followed by the end of the last one
+ * @return {(Geometry|null)[]}
+ */
+
+/**
+ * Creates Geometries from GeoJSON fragments in UTF8 format stored one after another
+ * in a single buffer.
+ *
+ * All the geometries are parsed in a single job, the empty entries produce `null`.
+ * @async
+ *
+ * @static
+ * @method fromGeoJsonBufferBatchAsync
+ * @instance
+ * @memberof Geometry
+ * @throws {Error}
+ * @param {Buffer|Uint8Array} values
+ * @param {Int32Array} offsets The start of each fragment followed by the end of the last one
+ * @param {callback<(Geometry|null)[]>} [callback=undefined]
+ * @return {Promise<(Geometry|null)[]>}
+ */
+GDAL_ASYNCABLE_DEFINE(Geometry::createFromGeoJsonBufferBatch) {
+  createFromBatch(info, async, true);
+}
+
+struct WKBBatch {
+  unsigned char *data;
+  size_t size;
+  std::vector<int32_t> offsets;
+};
+
+/**
+ * Converts geometries into WKB geometries stored one after another in a single buffer.
+ *
+ * All the geometries are converted in a single call without allocating a buffer
+ * for each geometry, the `null` geometries produce empty entries.
+ *
+ * @static
+ * @method toWKBBatch
+ * @instance
+ * @memberof Geometry
+ * @param {(Geometry|null)[]} geometries
+ * @param {string} [byte_order="MSB"] {@link wkbByteOrder|see options}
+ * @param {string} [variant="OGC"] ({@link wkbVariant|see options})
+ * @throws {Error}
+ * @return {WKBBatch}
+ */
+
+/**
+ * Converts geometries into WKB geometries stored one after another in a single buffer.
+ *
+ * All the geometries are converted in a single job without allocating a buffer
+ * for each geometry, the `null` geometries produce empty entries.
+ * @async
+ *
+ * @static
+ * @method toWKBBatchAsync
+ * @instance
+ * @memberof Geometry
+ * @param {(Geometry|null)[]} geometries
+ * @param {string} [byte_order="MSB"] {@link wkbByteOrder|see options}
+ * @param {string} [variant="OGC"] ({@link wkbVariant|see options})
+ * @param {callback<WKBBatch>} [callback=undefined]
+ * @throws {Error}
+ * @return {Promise<WKBBatch>}
+ */
+GDAL_ASYNCABLE_DEFINE(Geometry::exportToWKBBatch) {
+  Local<Array> array;
+  NODE_ARG_ARRAY(0, "geometries", array);
+
+  // byte order
+  OGRwkbByteOrder byte_order;
+  std::string order = "MSB";
+  NODE_ARG_OPT_STR(1, "byte order", order);
+  if (order == "MSB") {
+    byte_order = wkbXDR;
+  } else if (order == "LSB") {
+    byte_order = wkbNDR;
+  } else {
+    Nan::ThrowError("byte order must be 'MSB' or 'LSB'");
+    return;
+  }
+
+  // wkb variant
+  OGRwkbVariant wkb_variant;
+  std::string variant = "OGC";
+  NODE_ARG_OPT_STR(2, "wkb variant", variant);
+  if (variant == "OGC") {
+    wkb_variant = wkbVariantOldOgc;
+  } else if (variant == "ISO") {
+    wkb_variant = wkbVariantIso;
+  } else {
+    Nan::ThrowError("variant must be 'OGC' or 'ISO'");
+    return;
+  }
+
+  GeometryList list(true, false);
+  if (list.parse(array, "geometries must be an array of Geometry objects")) return;
+  const std::vector<GeometrySource> &geoms = list.get();
+
+  GDALAsyncableJob<std::shared_ptr<WKBBatch>> job(0);
+  job.lane = AsyncLane::CPU;
+  job.persist("geometries", list.persistent());
+  job.main = [geoms, byte_order, wkb_variant](const GDALExecutionProgress &) {
+    std::shared_ptr<WKBBatch> batch = std::make_shared<WKBBatch>();
+    batch->data = nullptr;
+    batch->size = 0;
+    batch->offsets.reserve(geoms.size() + 1);
+    batch->offsets.push_back(0);
+    // The buffer grows geometrically and is handed over to the resulting Buffer
+    size_t capacity = 0;
+    for (auto const &g : geoms) {
+      if (!g.isNull()) {
+        uv_sem_wait(g.lock);
+        size_t size = g.geom->WkbSize();
+        if (batch->size + size > INT32_MAX) {
+          uv_sem_post(g.lock);
+          free(batch->data);
+          throw "Batch too large for 32-bit offsets";
+        }
+        if (batch->size + size > capacity) {
+          capacity = std::min(std::max(capacity * 2, batch->size + size), static_cast<size_t>(INT32_MAX));
+          unsigned char *grown = static_cast<unsigned char *>(realloc(batch->data, capacity));
+          if (grown == nullptr) {
+            uv_sem_post(g.lock);
+            free(batch->data);
+            throw "Failed allocating memory";
+          }
+          batch->data = grown;
+        }
+        OGRErr err = g.geom->exportToWkb(byte_order, batch->data + batch->size, wkb_variant);
+        uv_sem_post(g.lock);
+        if (err) {
+          free(batch->data);
+          throw getOGRErrMsg(err);
+        }
+        batch->size += size;
+      }
+      batch->offsets.push_back(static_cast<int32_t>(batch->size));
+    }
+    return batch;
+  };
+
+  job.rval = [](std::shared_ptr<WKBBatch> batch, const GetFromPersistentFunc &) {
+    Nan::EscapableHandleScope scope;
+    Local<Object> result = Nan::New<Object>();
+
+    Local<Value> values;
+    if (batch->size == 0) {
+      free(batch->data);
+      values = Nan::NewBuffer(0).ToLocalChecked();
+    } else {
+      Nan::AdjustExternalMemory(batch->size);
+      int *hint = new int{static_cast<int>(batch->size)};
+      values = Nan::NewBuffer(
+                 reinterpret_cast<char *>(batch->data),
+                 batch->size,
+                 [](char *data, void *hint) {
+                   int *size = reinterpret_cast<int *>(hint);
+                   Nan::AdjustExternalMemory(-(*size));
+                   delete size;
+                   free(data);
+                 },
+                 hint)
+                 .ToLocalChecked();
+    }
+    Nan::Set(result, Nan::New("values").ToLocalChecked(), values);
+
+    Local<Value> offsets = TypedArray::New(GDT_Int32, batch->offsets.size());
+    if (offsets.IsEmpty() || !offsets->IsObject()) throw "Failed creating TypedArray";
+    Nan::TypedArrayContents<int32_t> contents(offsets);
+    memcpy(*contents, batch->offsets.data(), batch->offsets.size() * sizeof(int32_t));
+    Nan::Set(result, Nan::New("offsets").ToLocalChecked(), offsets);
+
+    return scope.Escape(result.As<Value>());
+  };
+  job.run(info, async, 3);
+}
+
 /**
  * Creates an empty Geometry from a WKB type.
  *
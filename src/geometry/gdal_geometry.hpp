@@ -21,7 +21,7 @@ namespace node_gdal {
 
 class Geometry : public GeometryBase<Geometry, OGRGeometry> {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using GeometryBase<Geometry, OGRGeometry>::GeometryBase;
 
   static void Initialize(Local<Object> target);
@@ -69,6 +69,7 @@ class Geometry : public GeometryBase<Geometry, OGRGeometry> {
   GDAL_ASYNCABLE_DECLARE(flattenTo2D);
   GDAL_ASYNCABLE_DECLARE(transform);
   GDAL_ASYNCABLE_DECLARE(transformTo);
+  GDAL_ASYNCABLE_DECLARE(prepare);
 #if GDAL_VERSION_MAJOR >= 3
   GDAL_ASYNCABLE_DECLARE(makeValid);
 #endif
@@ -79,6 +80,9 @@ class Geometry : public GeometryBase<Geometry, OGRGeometry> {
   GDAL_ASYNCABLE_DECLARE(createFromWkb);
   GDAL_ASYNCABLE_DECLARE(createFromGeoJson);
   GDAL_ASYNCABLE_DECLARE(createFromGeoJsonBuffer);
+  GDAL_ASYNCABLE_DECLARE(createFromWkbBatch);
+  GDAL_ASYNCABLE_DECLARE(createFromGeoJsonBufferBatch);
+  GDAL_ASYNCABLE_DECLARE(exportToWKBBatch);
   static NAN_METHOD(getName);
   static NAN_METHOD(getConstructor);
 
@@ -94,6 +98,9 @@ class Geometry : public GeometryBase<Geometry, OGRGeometry> {
 
   static OGRwkbGeometryType getGeometryType_fixed(OGRGeometry *geom);
   static Local<Value> getConstructor(OGRwkbGeometryType type);
+
+    private:
+  static void createFromBatch(const Nan::FunctionCallbackInfo<v8::Value> &info, bool async, bool geojson);
 };
 
 } // namespace node_gdal
@@ -78,6 +78,9 @@ template <class T, class OGRT> class GeometryBase : public Nan::ObjectWrap {
   inline bool isAlive() {
     return this_;
   }
+  inline uv_sem_t *asyncLock() {
+    return async_lock;
+  }
 
     protected:
   ~GeometryBase();
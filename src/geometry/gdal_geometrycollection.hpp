@@ -23,7 +23,7 @@ namespace node_gdal {
 class GeometryCollection : public GeometryCollectionBase<GeometryCollection, OGRGeometryCollection> {
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using GeometryCollectionBase<GeometryCollection, OGRGeometryCollection>::GeometryCollectionBase;
 
   static void Initialize(Local<Object> target);
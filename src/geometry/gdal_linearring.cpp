@@ -9,7 +9,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> LinearRing::constructor;
+thread_local Nan::Persistent<FunctionTemplate> LinearRing::constructor;
 
 void LinearRing::Initialize(Local<Object> target) {
   Nan::HandleScope scope;
@@ -22,7 +22,7 @@ namespace node_gdal {
 class LinearRing : public CurveBase<LinearRing, OGRLinearRing, LineStringPoints> {
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using CurveBase<LinearRing, OGRLinearRing, LineStringPoints>::CurveBase;
 
   static void Initialize(Local<Object> target);
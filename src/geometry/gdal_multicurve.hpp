@@ -21,7 +21,7 @@ namespace node_gdal {
 class MultiCurve : public GeometryCollectionBase<MultiCurve, OGRMultiCurve> {
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using GeometryCollectionBase<MultiCurve, OGRMultiCurve>::GeometryCollectionBase;
 
   static void Initialize(Local<Object> target);
@@ -21,7 +21,7 @@ namespace node_gdal {
 class MultiPolygon : public GeometryCollectionBase<MultiPolygon, OGRMultiPolygon> {
 
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using GeometryCollectionBase<MultiPolygon, OGRMultiPolygon>::GeometryCollectionBase;
 
   static void Initialize(Local<Object> target);
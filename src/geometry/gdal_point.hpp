@@ -20,7 +20,7 @@ namespace node_gdal {
 
 class Point : public GeometryBase<Point, OGRPoint> {
     public:
-  static Nan::Persistent<FunctionTemplate> constructor;
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
   using GeometryBase<Point, OGRPoint>::GeometryBase;
 
   static void Initialize(Local<Object> target);
@@ -0,0 +1,234 @@
+#include <vector>
+#include "gdal_prepared_geometry.hpp"
+#include "gdal_geometry.hpp"
+#include "../gdal_common.hpp"
+#include "../utils/geometry_list.hpp"
+#include "../utils/typed_array.hpp"
+
+namespace node_gdal {
+
+thread_local Nan::Persistent<FunctionTemplate> PreparedGeometry::constructor;
+
+void PreparedGeometry::Initialize(Local<Object> target) {
+  Nan::HandleScope scope;
+
+  Local<FunctionTemplate> lcons = Nan::New<FunctionTemplate>(PreparedGeometry::New);
+  lcons->InstanceTemplate()->SetInternalFieldCount(1);
+  lcons->SetClassName(Nan::New("PreparedGeometry").ToLocalChecked());
+
+  Nan::SetPrototypeMethod(lcons, "toString", toString);
+  Nan__SetPrototypeAsyncableMethod(lcons, "intersectsMany", intersectsMany);
+#if GDAL_VERSION_MAJOR > 2 || (GDAL_VERSION_MAJOR == 2 && GDAL_VERSION_MINOR >= 3)
+  Nan__SetPrototypeAsyncableMethod(lcons, "containsMany", containsMany);
+#endif
+
+  Nan::Set(target, Nan::New("PreparedGeometry").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
+
+  constructor.Reset(lcons);
+}
+
+PreparedGeometry::PreparedGeometry(OGRPreparedGeometry *prepared, const OGREnvelope &envelope)
+  : Nan::ObjectWrap(), this_(prepared), envelope_(envelope) {
+  LOG("Created PreparedGeometry [%p]", prepared);
+  async_lock = new uv_sem_t;
+  uv_sem_init(async_lock, 1);
+}
+
+PreparedGeometry::PreparedGeometry() : Nan::ObjectWrap(), this_(NULL), envelope_() {
+  async_lock = new uv_sem_t;
+  uv_sem_init(async_lock, 1);
+}
+
+PreparedGeometry::~PreparedGeometry() {
+  if (this_) {
+    LOG("Disposing PreparedGeometry [%p]", this_);
+    OGRDestroyPreparedGeometry(this_);
+    LOG("Disposed PreparedGeometry [%p]", this_);
+    this_ = NULL;
+  }
+  uv_sem_destroy(async_lock);
+  delete async_lock;
+}
+
+/**
+ * A geometry prepared for evaluating repeatedly the same spatial predicate
+ * against many other geometries, created by {@link Geometry#prepare}.
+ *
+ * The prepared geometry is a snapshot: later changes to the original
+ * geometry are not reflected. Requires GDAL to be built with GEOS.
+ *
+ * @example
+ *
+ * const fence = polygon.prepare()
+ * const inside = await fence.containsManyAsync(points)
+ *
+ * @class PreparedGeometry
+ */
+NAN_METHOD(PreparedGeometry::New) {
+
+  if (!info.IsConstructCall()) {
+    Nan::ThrowError("Cannot call constructor as function, you need to use 'new' keyword");
+    return;
+  }
+
+  if (info[0]->IsExternal()) {
+    Local<External> ext = info[0].As<External>();
+    void *ptr = ext->Value();
+    PreparedGeometry *f = static_cast<PreparedGeometry *>(ptr);
+    f->Wrap(info.This());
+    info.GetReturnValue().Set(info.This());
+    return;
+  }
+
+  Nan::ThrowError("PreparedGeometry cannot be constructed directly, use Geometry.prepare()");
+}
+
+Local<Value> PreparedGeometry::New(OGRPreparedGeometry *prepared, const OGREnvelope &envelope) {
+  Nan::EscapableHandleScope scope;
+
+  if (!prepared) { return scope.Escape(Nan::Null()); }
+
+  PreparedGeometry *wrapped = new PreparedGeometry(prepared, envelope);
+
+  Local<Value> ext = Nan::New<External>(wrapped);
+  Local<Object> obj =
+    Nan::NewInstance(Nan::GetFunction(Nan::New(PreparedGeometry::constructor)).ToLocalChecked(), 1, &ext)
+      .ToLocalChecked();
+
+  return scope.Escape(obj);
+}
+
+NAN_METHOD(PreparedGeometry::toString) {
+  info.GetReturnValue().Set(Nan::New("PreparedGeometry").ToLocalChecked());
+}
+
+void PreparedGeometry::evaluateMany(const Nan::FunctionCallbackInfo<v8::Value> &info, bool async, bool contains) {
+  PreparedGeometry *prepared = Nan::ObjectWrap::Unwrap<PreparedGeometry>(info.This());
+  if (!prepared->isAlive()) {
+    Nan::ThrowError("PreparedGeometry object has already been destroyed");
+    return;
+  }
+
+  Local<Array> array;
+  NODE_ARG_ARRAY(0, "candidates", array);
+
+  GeometryList list(false, true);
+  if (list.parse(array, "candidates must be an array of Geometry objects or WKB Buffers")) return;
+  const std::vector<GeometrySource> &candidates = list.get();
+
+  Local<Value> result = TypedArray::New(GDT_Byte, candidates.size());
+  if (result.IsEmpty() || !result->IsObject()) return; // TypedArray::New threw an error
+  uint8_t *data = *Nan::TypedArrayContents<uint8_t>(result);
+
+  OGRPreparedGeometry *gdal_prepared = prepared->this_;
+  OGREnvelope envelope = prepared->envelope_;
+  uv_sem_t *async_lock = prepared->async_lock;
+
+  GDALAsyncableJob<OGRErr> job(0);
+  job.lane = AsyncLane::CPU;
+  job.persist("candidates", list.persistent());
+  job.persist("result", result.As<Object>());
+  job.main = [gdal_prepared, envelope, async_lock, candidates, data, contains](const GDALExecutionProgress &) {
+    uv_sem_wait(async_lock);
+    for (size_t i = 0; i < candidates.size(); i++) {
+      OGRGeometry *geom;
+      try {
+        geom = candidates[i].acquire();
+      } catch (...) {
+        uv_sem_post(async_lock);
+        throw;
+      }
+
+      // The envelopes are compared first, GEOS is called only for the remaining candidates
+      OGREnvelope candidate_envelope;
+      geom->getEnvelope(&candidate_envelope);
+      bool r;
+      if (contains) {
+#if GDAL_VERSION_MAJOR > 2 || (GDAL_VERSION_MAJOR == 2 && GDAL_VERSION_MINOR >= 3)
+        r = envelope.Contains(candidate_envelope) && OGRPreparedGeometryContains(gdal_prepared, geom);
+#else
+        r = false;
+#endif
+      } else {
+        r = envelope.Intersects(candidate_envelope) && OGRPreparedGeometryIntersects(gdal_prepared, geom);
+      }
+      data[i] = r ? 1 : 0;
+
+      candidates[i].release(geom);
+    }
+    uv_sem_post(async_lock);
+    return OGRERR_NONE;
+  };
+  job.rval = [](OGRErr, const GetFromPersistentFunc &getter) { return getter("result"); };
+  job.run(info, async, 1);
+}
+
+/**
+ * Tests which of the candidates intersect the prepared geometry.
+ *
+ * The candidates are evaluated in a single call, the WKB buffers are parsed
+ * without creating Geometry objects.
+ *
+ * @throws {Error}
+ * @method intersectsMany
+ * @instance
+ * @memberof PreparedGeometry
+ * @param {(Geometry|Buffer)[]} candidates Geometries or WKB buffers
+ * @return {Uint8Array} `1` for every candidate that intersects, `0` otherwise
+ */
+
+/**
+ * Tests which of the candidates intersect the prepared geometry.
+ *
+ * The candidates are evaluated in a single job, the WKB buffers are parsed
+ * without creating Geometry objects.
+ * @async
+ *
+ * @throws {Error}
+ * @method intersectsManyAsync
+ * @instance
+ * @memberof PreparedGeometry
+ * @param {(Geometry|Buffer)[]} candidates Geometries or WKB buffers
+ * @param {callback<Uint8Array>} [callback=undefined]
+ * @return {Promise<Uint8Array>} `1` for every candidate that intersects, `0` otherwise
+ */
+GDAL_ASYNCABLE_DEFINE(PreparedGeometry::intersectsMany) {
+  evaluateMany(info, async, false);
+}
+
+#if GDAL_VERSION_MAJOR > 2 || (GDAL_VERSION_MAJOR == 2 && GDAL_VERSION_MINOR >= 3)
+/**
+ * Tests which of the candidates are contained in the prepared geometry.
+ *
+ * The candidates are evaluated in a single call, the WKB buffers are parsed
+ * without creating Geometry objects.
+ *
+ * @throws {Error}
+ * @method containsMany
+ * @instance
+ * @memberof PreparedGeometry
+ * @param {(Geometry|Buffer)[]} candidates Geometries or WKB buffers
+ * @return {Uint8Array} `1` for every candidate that is contained, `0` otherwise
+ */
+
+/**
+ * Tests which of the candidates are contained in the prepared geometry.
+ *
+ * The candidates are evaluated in a single job, the WKB buffers are parsed
+ * without creating Geometry objects.
+ * @async
+ *
+ * @throws {Error}
+ * @method containsManyAsync
+ * @instance
+ * @memberof PreparedGeometry
+ * @param {(Geometry|Buffer)[]} candidates Geometries or WKB buffers
+ * @param {callback<Uint8Array>} [callback=undefined]
+ * @return {Promise<Uint8Array>} `1` for every candidate that is contained, `0` otherwise
+ */
+GDAL_ASYNCABLE_DEFINE(PreparedGeometry::containsMany) {
+  evaluateMany(info, async, true);
+}
+#endif
+
+} // namespace node_gdal
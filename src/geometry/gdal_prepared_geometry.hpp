@@ -0,0 +1,52 @@
+#ifndef __NODE_OGR_PREPARED_GEOMETRY_H__
+#define __NODE_OGR_PREPARED_GEOMETRY_H__
+
+// node
+#include <node.h>
+#include <node_object_wrap.h>
+
+// nan
+#include "../nan-wrapper.h"
+
+// ogr
+#include <ogrsf_frmts.h>
+
+#include "../async.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+class PreparedGeometry : public Nan::ObjectWrap {
+    public:
+  static thread_local Nan::Persistent<FunctionTemplate> constructor;
+  static void Initialize(Local<Object> target);
+  static NAN_METHOD(New);
+  static Local<Value> New(OGRPreparedGeometry *prepared, const OGREnvelope &envelope);
+  static NAN_METHOD(toString);
+  GDAL_ASYNCABLE_DECLARE(intersectsMany);
+#if GDAL_VERSION_MAJOR > 2 || (GDAL_VERSION_MAJOR == 2 && GDAL_VERSION_MINOR >= 3)
+  GDAL_ASYNCABLE_DECLARE(containsMany);
+#endif
+
+  PreparedGeometry();
+  PreparedGeometry(OGRPreparedGeometry *prepared, const OGREnvelope &envelope);
+  inline OGRPreparedGeometry *get() {
+    return this_;
+  }
+  inline bool isAlive() {
+    return this_;
+  }
+
+    private:
+  ~PreparedGeometry();
+  static void evaluateMany(const Nan::FunctionCallbackInfo<v8::Value> &info, bool async, bool contains);
+  OGRPreparedGeometry *this_;
+  OGREnvelope envelope_;
+  // The GEOS prepared geometries are not thread-safe
+  uv_sem_t *async_lock;
+};
+
+} // namespace node_gdal
+#endif
@@ -40,11 +40,14 @@
 #include "geometry/gdal_multipolygon.hpp"
 #include "geometry/gdal_point.hpp"
 #include "geometry/gdal_polygon.hpp"
+#include "geometry/gdal_prepared_geometry.hpp"
 #include "gdal_spatial_reference.hpp"
+#include "gdal_spatial_index.hpp"
 #include "gdal_memfile.hpp"
 #include "gdal_fs.hpp"
 
 #include "utils/field_types.hpp"
+#include "utils/proj_cache.hpp"
 
 // collections
 #include "collections/dataset_bands.hpp"
@@ -69,6 +72,8 @@
 #include "collections/colortable.hpp"
 
 // std
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -79,8 +84,10 @@ using namespace node;
 using namespace v8;
 
 FILE *log_file = NULL;
-ObjectStore object_store;
+// One per isolate, see ptr_manager.cpp
+thread_local ObjectStore object_store;
 bool eventLoopWarn = true;
+std::atomic<CPLErrorHandler> globalErrorHandler(CPLDefaultErrorHandler);
 
 static NAN_GETTER(LastErrorGetter) {
 
@@ -119,15 +126,79 @@ static NAN_SETTER(EventLoopWarningSetter) {
   eventLoopWarn = Nan::To<bool>(value).ToChecked();
 }
 
+static NAN_GETTER(IOThreadsGetter) {
+  info.GetReturnValue().Set(Nan::New<Integer>(async_thread_pool.size(AsyncLane::IO)));
+}
+
+static NAN_GETTER(CPUThreadsGetter) {
+  info.GetReturnValue().Set(Nan::New<Integer>(async_thread_pool.size(AsyncLane::CPU)));
+}
+
+static void ThreadPoolResize(AsyncLane lane, const char *name, Local<Value> value) {
+  if (!value->IsUint32()) {
+    Nan::ThrowError((std::string("'") + name + "' must be a positive integer").c_str());
+    return;
+  }
+  try {
+    async_thread_pool.resize(lane, Nan::To<uint32_t>(value).ToChecked());
+  } catch (const char *err) { Nan::ThrowError(err); }
+}
+
+static NAN_SETTER(IOThreadsSetter) {
+  ThreadPoolResize(AsyncLane::IO, "ioThreads", value);
+}
+
+static NAN_SETTER(CPUThreadsSetter) {
+  ThreadPoolResize(AsyncLane::CPU, "cpuThreads", value);
+}
+
+static NAN_GETTER(ProjCacheSizeGetter) {
+  info.GetReturnValue().Set(Nan::New<Number>(static_cast<double>(proj_cache.capacity())));
+}
+
+static NAN_SETTER(ProjCacheSizeSetter) {
+  if (!value->IsUint32()) {
+    Nan::ThrowError("'projCacheSize' must be a positive integer");
+    return;
+  }
+  proj_cache.resize(Nan::To<uint32_t>(value).ToChecked());
+}
+
+static NAN_GETTER(ProgressIntervalGetter) {
+  info.GetReturnValue().Set(Nan::New<Number>(progressThrottle.interval_us / 1000.0));
+}
+
+static NAN_SETTER(ProgressIntervalSetter) {
+  if (!value->IsNumber() || !(Nan::To<double>(value).ToChecked() >= 0)) {
+    Nan::ThrowError("'progressInterval' must be a positive number");
+    return;
+  }
+  progressThrottle.interval_us = static_cast<int64_t>(Nan::To<double>(value).ToChecked() * 1000);
+}
+
+static NAN_GETTER(ProgressDeltaGetter) {
+  info.GetReturnValue().Set(Nan::New<Number>(progressThrottle.delta));
+}
+
+static NAN_SETTER(ProgressDeltaSetter) {
+  if (!value->IsNumber() || !(Nan::To<double>(value).ToChecked() >= 0)) {
+    Nan::ThrowError("'progressDelta' must be a positive number");
+    return;
+  }
+  progressThrottle.delta = Nan::To<double>(value).ToChecked();
+}
+
 extern "C" {
 
 static NAN_METHOD(QuietOutput) {
   CPLSetErrorHandler(CPLQuietErrorHandler);
+  globalErrorHandler = CPLQuietErrorHandler;
   return;
 }
 
 static NAN_METHOD(VerboseOutput) {
   CPLSetErrorHandler(CPLDefaultErrorHandler);
+  globalErrorHandler = CPLDefaultErrorHandler;
   return;
 }
 
@@ -217,22 +288,49 @@ GDAL_ASYNCABLE_DEFINE(gdal_open) {
 #if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
     } else if (mode[i] == 'm') {
       flags |= GDAL_OF_MULTIDIM_RASTER;
+#endif
+#if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 10)
+    } else if (mode[i] == 't') {
+      flags |= GDAL_OF_RASTER | GDAL_OF_THREAD_SAFE;
 #endif
     } else {
-      Nan::ThrowError("Invalid open mode. Must contain only \"r\" or \"r+\" and \"m\" ");
+      Nan::ThrowError("Invalid open mode. Must contain only \"r\" or \"r+\", \"m\" and \"t\" ");
       return;
     }
   }
   flags |= GDAL_OF_VERBOSE_ERROR;
 
-  GDALAsyncableJob<GDALDataset *> job(0);
-  job.rval = [](GDALDataset *ds, const GetFromPersistentFunc &) { return Dataset::New(ds); };
-  job.main = [path, flags](const GDALExecutionProgress &) {
-    GDALDataset *ds = (GDALDataset *)GDALOpenEx(path.c_str(), flags, NULL, NULL, NULL);
-    if (!ds) throw CPLGetLastErrorMsg();
-    return ds;
+  Local<Object> options;
+  int pool = 1;
+  NODE_ARG_OBJECT_OPT(2, "options", options);
+  if (!options.IsEmpty()) NODE_INT_FROM_OBJ_OPT(options, "pool", pool);
+  if (pool < 1 || pool > (int)maxConcurrentReaders) {
+    Nan::ThrowRangeError(("pool must be between 1 and " + std::to_string(maxConcurrentReaders)).c_str());
+    return;
+  }
+  if (pool > 1 && (flags & GDAL_OF_UPDATE)) {
+    Nan::ThrowError("A pool of handles can be used only in read-only mode");
+    return;
+  }
+
+  // The first handle is the Dataset, the others are its pool
+  GDALAsyncableJob<std::vector<GDALDataset *>> job(0);
+  job.rval = [](std::vector<GDALDataset *> handles, const GetFromPersistentFunc &) {
+    return Dataset::New(handles[0], nullptr, std::vector<GDALDataset *>(handles.begin() + 1, handles.end()));
   };
-  job.run(info, async, 2);
+  job.main = [path, flags, pool](const GDALExecutionProgress &) {
+    std::vector<GDALDataset *> handles;
+    for (int i = 0; i < pool; i++) {
+      GDALDataset *ds = (GDALDataset *)GDALOpenEx(path.c_str(), flags, NULL, NULL, NULL);
+      if (!ds) {
+        for (GDALDataset *h : handles) GDALClose(h);
+        throw CPLGetLastErrorMsg();
+      }
+      handles.push_back(ds);
+    }
+    return handles;
+  };
+  job.run(info, async, 3);
 }
 
 static NAN_METHOD(setConfigOption) {
@@ -330,18 +428,164 @@ static NAN_METHOD(isAlive) {
   info.GetReturnValue().Set(Nan::New(object_store.isAlive(uid)));
 }
 
+// Called by the AbortSignal listeners, the scheduler removes the aborted jobs from its queues
+static NAN_METHOD(wakeScheduler) {
+  async_scheduler.wake();
+}
+
+/**
+ * @typedef {object} MetricsHistogram
+ * @property {number} count
+ * @property {number} mean in milliseconds
+ * @property {number} max in milliseconds
+ * @property {number} p50 in milliseconds
+ * @property {number} p90 in milliseconds
+ * @property {number} p99 in milliseconds
+ */
+
+/**
+ * @typedef {object} MethodMetrics
+ * @property {number} calls
+ * @property {number} errors
+ * @property {MetricsHistogram} lockWait time spent waiting for the Dataset locks
+ * @property {MetricsHistogram} queueWait time spent waiting for a thread of the pool (async only)
+ * @property {MetricsHistogram} execute time spent in GDAL
+ * @property {MetricsHistogram} rval time spent on the main thread producing the result
+ */
+
+/**
+ * @typedef {object} DatasetMetrics
+ * @property {number} inFlight async jobs scheduled and not yet completed
+ * @property {number} waiting async jobs waiting in the queue of the Dataset
+ * @property {number} jobs
+ * @property {number} lockWait total time spent waiting for the lock in milliseconds
+ */
+
+/**
+ * @typedef {object} CacheMetrics
+ * @property {number} hits
+ * @property {number} misses
+ * @property {number} size number of cached objects
+ */
+
+/**
+ * @typedef {object} ProjCacheMetrics
+ * @property {CacheMetrics} srs
+ * @property {CacheMetrics} transformations
+ */
+
+/**
+ * @typedef {object} Metrics
+ * @property {Record<string, MethodMetrics>} methods
+ * @property {Record<number, DatasetMetrics>} datasets by Dataset uid
+ * @property {number} bytesRead the raster data read by the pixel methods and streams, shared by all the `worker_threads`
+ * @property {ProjCacheMetrics} projCache shared by all the `worker_threads`
+ */
+
+/**
+ * Returns the performance metrics collected since the start or since the last reset.
+ *
+ * The methods are identified by their class and name, ie `RasterBandPixels.read`,
+ * the sync and async versions are counted together.
+ * The durations are recorded in lock-free histograms with a relative
+ * error of at most 25%.
+ * Each `worker_thread` has its own metrics.
+ *
+ * @static
+ * @method metrics
+ * @param {boolean} [reset=false] reset the counters after reading them
+ * @return {Metrics}
+ */
+static NAN_METHOD(getMetrics) {
+  bool reset = false;
+  NODE_ARG_BOOL_OPT(0, "reset", reset);
+
+  info.GetReturnValue().Set(metrics.toObject());
+  if (reset) metrics.reset();
+}
+
+// Called by lib/diagnostics.js with the diagnostics_channel Channel objects of the job events
+static NAN_METHOD(setDiagnosticsChannels) {
+  Local<Object> start, lock, end;
+  NODE_ARG_OBJECT(0, "start", start);
+  NODE_ARG_OBJECT(1, "lock", lock);
+  NODE_ARG_OBJECT(2, "end", end);
+  diagnostics.setChannels(start, lock, end);
+}
+
+// Used by RasterMuxStream and RasterWriteStream to consolidate the chunks
+// of several inputs in a single call: the chunks in sources[i] are copied
+// back to back into targets[i] until it is full
+static NAN_METHOD(gather) {
+  Local<Array> sources, targets;
+  NODE_ARG_ARRAY(0, "sources", sources);
+  NODE_ARG_ARRAY(1, "targets", targets);
+
+  if (sources->Length() != targets->Length()) {
+    Nan::ThrowRangeError("sources and targets must have the same length");
+    return;
+  }
+
+  for (uint32_t i = 0; i < targets->Length(); i++) {
+    Local<Value> target = Nan::Get(targets, i).ToLocalChecked();
+    Local<Value> list = Nan::Get(sources, i).ToLocalChecked();
+    if (!target->IsTypedArray() || !list->IsArray()) {
+      Nan::ThrowTypeError("targets must be TypedArrays and sources must be arrays of TypedArrays");
+      return;
+    }
+    Local<Object> dst = target.As<Object>();
+    Local<Array> chunks = list.As<Array>();
+    Nan::TypedArrayContents<uint8_t> dst_data(dst);
+    size_t len = dst_data.length(), pos = 0;
+
+    for (uint32_t j = 0; j < chunks->Length() && pos < len; j++) {
+      Local<Value> chunk = Nan::Get(chunks, j).ToLocalChecked();
+      if (!chunk->IsTypedArray() || !chunk.As<Object>()->GetConstructorName()->StrictEquals(dst->GetConstructorName())) {
+        Nan::ThrowTypeError("All chunks must have the same type as their target");
+        return;
+      }
+      Nan::TypedArrayContents<uint8_t> src_data(chunk);
+      size_t n = std::min(src_data.length(), len - pos);
+      memcpy(*dst_data + pos, *src_data, n);
+      pos += n;
+    }
+
+    if (pos < len) {
+      Nan::ThrowRangeError("Not enough data to fill the target");
+      return;
+    }
+  }
+}
+
+// Called when the isolate exits, the main thread or a worker_thread
 void Cleanup(void *) {
+  // The jobs blocked on the pixel functions of this isolate must fail before
+  // anything waits for them
+  Algorithms::Shutdown();
   object_store.cleanup();
+  async_scheduler.shutdown();
+  async_completion.shutdown();
+  Memfile::Shutdown();
+  async_thread_pool.detach();
+  // The destroyed jobs are freed by the close callbacks of their handles,
+  // these must run while the isolate is still alive
+  uv_run(Nan::GetCurrentEventLoop(), UV_RUN_NOWAIT);
 }
 
-static void Init(Local<Object> target, Local<v8::Value>, void *) {
-  static bool initialized = false;
+// The module can be loaded once in each isolate, the main thread and the worker_threads,
+// each one has its own ObjectStore and scheduler while the thread pool
+// and GDAL itself (drivers, block cache, /vsimem/) are shared
+static void Init(Local<Object> target) {
+  static thread_local bool initialized = false;
   if (initialized) {
     Nan::ThrowError("gdal-async does not yet support multiple instances per V8 isolate");
     return;
   }
   initialized = true;
   mainV8ThreadId = std::this_thread::get_id();
+  async_scheduler.init(Nan::GetCurrentEventLoop());
+  async_completion.init(Nan::GetCurrentEventLoop());
+  async_thread_pool.attach();
 
   Nan__SetAsyncableMethod(target, "open", gdal_open);
   Nan::SetMethod(target, "setConfigOption", setConfigOption);
@@ -350,6 +594,10 @@ static void Init(Local<Object> target, Local<v8::Value>, void *) {
   Nan::SetMethod(target, "setPROJSearchPath", setPROJSearchPath);
   Nan::SetMethod(target, "_triggerCPLError", ThrowDummyCPLError); // for tests
   Nan::SetMethod(target, "_isAlive", isAlive);                    // for tests
+  Nan::SetMethod(target, "_gather", gather);
+  Nan::SetMethod(target, "_wakeScheduler", wakeScheduler);
+  Nan::SetMethod(target, "metrics", getMetrics);
+  Nan::SetMethod(target, "_setDiagnosticsChannels", setDiagnosticsChannels);
 
   Warper::Initialize(target);
   Algorithms::Initialize(target);
@@ -381,6 +629,8 @@ static void Init(Local<Object> target, Local<v8::Value>, void *) {
   CircularString::Initialize(target);
   CompoundCurve::Initialize(target);
   MultiCurve::Initialize(target);
+  PreparedGeometry::Initialize(target);
+  SpatialIndex::Initialize(target);
 
   SpatialReference::Initialize(target);
   CoordinateTransformation::Initialize(target);
@@ -1753,6 +2003,69 @@ static void Init(Local<Object> target, Local<v8::Value>, void *) {
   Nan::SetAccessor(
     target, Nan::New<v8::String>("eventLoopWarning").ToLocalChecked(), EventLoopWarningGetter, EventLoopWarningSetter);
 
+  /**
+   * Number of threads running the I/O-bound asynchronous operations
+   * (reading, writing, opening, metadata), defaults to 4.
+   * The asynchronous operations use their own thread pool, independent
+   * of `UV_THREADPOOL_SIZE` and the Node.js thread pool, it is shared
+   * by all the `worker_threads`.
+   * Can be changed only before launching the first asynchronous operation of the process.
+   *
+   * @var {number} ioThreads
+   */
+  Nan::SetAccessor(target, Nan::New<v8::String>("ioThreads").ToLocalChecked(), IOThreadsGetter, IOThreadsSetter);
+
+  /**
+   * Number of threads running the CPU-bound asynchronous operations
+   * (warping, translating, polygonizing, computing statistics, building overviews,
+   * geometry operations), defaults to the number of CPU cores.
+   * These threads also run I/O-bound operations when they are idle.
+   * They are shared by all the `worker_threads`.
+   * Can be changed only before launching the first asynchronous operation of the process.
+   *
+   * @var {number} cpuThreads
+   */
+  Nan::SetAccessor(target, Nan::New<v8::String>("cpuThreads").ToLocalChecked(), CPUThreadsGetter, CPUThreadsSetter);
+
+  /**
+   * Minimum interval in milliseconds between two invocations of
+   * a progress callback, defaults to 100.
+   * The first and the final invocations are never delayed and the latest
+   * skipped progress is delivered before the operation completes.
+   * Applies to the operations launched by the current thread after it has been changed.
+   *
+   * @var {number} progressInterval
+   */
+  Nan::SetAccessor(
+    target, Nan::New<v8::String>("progressInterval").ToLocalChecked(), ProgressIntervalGetter, ProgressIntervalSetter);
+
+  /**
+   * Minimum progress, between 0 and 1, between two invocations of
+   * a progress callback, defaults to 0.01.
+   * The first and the final invocations are never skipped and the latest
+   * skipped progress is delivered before the operation completes.
+   * Applies to the operations launched by the current thread after it has been changed.
+   *
+   * @var {number} progressDelta
+   */
+  Nan::SetAccessor(
+    target, Nan::New<v8::String>("progressDelta").ToLocalChecked(), ProgressDeltaGetter, ProgressDeltaSetter);
+
+  /**
+   * Maximum number of spatial references and of coordinate transformations
+   * kept in the cache, defaults to 64 of each, 0 disables the cache.
+   *
+   * `SpatialReference.fromEPSG`, `fromEPSGA`, `fromWKT`, `fromProj4`, `fromURN`
+   * and `fromUserInput`, the `CoordinateTransformation` constructor and
+   * `Geometry.transformTo` return copies of the cached objects instead of
+   * querying the PROJ database and building a new PROJ pipeline.
+   * The cache is shared by all the `worker_threads`.
+   *
+   * @var {number} projCacheSize
+   */
+  Nan::SetAccessor(
+    target, Nan::New<v8::String>("projCacheSize").ToLocalChecked(), ProjCacheSizeGetter, ProjCacheSizeSetter);
+
   // Local<Object> versions = Nan::New<Object>();
   // Nan::Set(versions, Nan::New("node").ToLocalChecked(),
   // Nan::New(NODE_VERSION+1)); Nan::Set(versions,
@@ -1796,4 +2109,4 @@ static void Init(Local<Object> target, Local<v8::Value>, void *) {
 
 } // namespace node_gdal
 
-NODE_MODULE(NODE_GYP_MODULE_NAME, node_gdal::Init);
+NAN_MODULE_WORKER_ENABLED(NODE_GYP_MODULE_NAME, node_gdal::Init)
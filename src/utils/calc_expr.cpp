@@ -0,0 +1,356 @@
+#include "calc_expr.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+
+namespace node_gdal {
+
+CalcExpression::CalcExpression() : program(), vars(), source(), pos(0), err() {
+}
+
+// The parser is a plain recursive descent parser,
+// it never throws, errors are reported by returning -1
+bool CalcExpression::compile(const std::string &expr, const std::vector<std::string> &variables) {
+  program.clear();
+  vars = variables;
+  source = expr;
+  pos = 0;
+  err.clear();
+
+  int r = parseTernary();
+  if (r < 0) return false;
+  skipSpace();
+  if (pos < source.size()) {
+    fail("unexpected character");
+    return false;
+  }
+  return true;
+}
+
+int CalcExpression::fail(const std::string &msg) {
+  if (err.empty()) err = "Invalid expression at position " + std::to_string(pos) + ": " + msg;
+  return -1;
+}
+
+int CalcExpression::emit(Opcode op, int a, int b, int c, double value) {
+  program.push_back({op, a, b, c, value});
+  return static_cast<int>(program.size()) - 1;
+}
+
+void CalcExpression::skipSpace() {
+  while (pos < source.size() && isspace(static_cast<unsigned char>(source[pos]))) pos++;
+}
+
+bool CalcExpression::accept(const char *token) {
+  skipSpace();
+  size_t len = strlen(token);
+  if (source.compare(pos, len, token) != 0) return false;
+  // Do not split two-character operators
+  if (len == 1 && pos + 1 < source.size()) {
+    char next = source[pos + 1];
+    if ((*token == '<' || *token == '>' || *token == '!' || *token == '=') && next == '=') return false;
+    if (*token == '*' && next == '*') return false;
+  }
+  pos += len;
+  return true;
+}
+
+int CalcExpression::parseTernary() {
+  int cond = parseOr();
+  if (cond < 0) return -1;
+  if (!accept("?")) return cond;
+  int a = parseTernary();
+  if (a < 0) return -1;
+  if (!accept(":")) return fail("expected ':'");
+  int b = parseTernary();
+  if (b < 0) return -1;
+  return emit(Select, cond, a, b);
+}
+
+int CalcExpression::parseOr() {
+  int a = parseAnd();
+  while (a >= 0 && accept("||")) {
+    int b = parseAnd();
+    if (b < 0) return -1;
+    a = emit(Or, a, b);
+  }
+  return a;
+}
+
+int CalcExpression::parseAnd() {
+  int a = parseEquality();
+  while (a >= 0 && accept("&&")) {
+    int b = parseEquality();
+    if (b < 0) return -1;
+    a = emit(And, a, b);
+  }
+  return a;
+}
+
+int CalcExpression::parseEquality() {
+  int a = parseComparison();
+  while (a >= 0) {
+    Opcode op;
+    if (accept("=="))
+      op = Eq;
+    else if (accept("!="))
+      op = Ne;
+    else
+      break;
+    int b = parseComparison();
+    if (b < 0) return -1;
+    a = emit(op, a, b);
+  }
+  return a;
+}
+
+int CalcExpression::parseComparison() {
+  int a = parseAdditive();
+  while (a >= 0) {
+    Opcode op;
+    if (accept("<="))
+      op = Le;
+    else if (accept(">="))
+      op = Ge;
+    else if (accept("<"))
+      op = Lt;
+    else if (accept(">"))
+      op = Gt;
+    else
+      break;
+    int b = parseAdditive();
+    if (b < 0) return -1;
+    a = emit(op, a, b);
+  }
+  return a;
+}
+
+int CalcExpression::parseAdditive() {
+  int a = parseMultiplicative();
+  while (a >= 0) {
+    Opcode op;
+    if (accept("+"))
+      op = Add;
+    else if (accept("-"))
+      op = Sub;
+    else
+      break;
+    int b = parseMultiplicative();
+    if (b < 0) return -1;
+    a = emit(op, a, b);
+  }
+  return a;
+}
+
+int CalcExpression::parseMultiplicative() {
+  int a = parseUnary();
+  while (a >= 0) {
+    Opcode op;
+    if (accept("*"))
+      op = Mul;
+    else if (accept("/"))
+      op = Div;
+    else
+      break;
+    int b = parseUnary();
+    if (b < 0) return -1;
+    a = emit(op, a, b);
+  }
+  return a;
+}
+
+int CalcExpression::parseUnary() {
+  if (accept("-")) {
+    int a = parseUnary();
+    if (a < 0) return -1;
+    return emit(Neg, a);
+  }
+  if (accept("+")) return parseUnary();
+  if (accept("!")) {
+    int a = parseUnary();
+    if (a < 0) return -1;
+    return emit(Not, a);
+  }
+  return parsePower();
+}
+
+// ** is right-associative and binds tighter than unary minus on its left
+int CalcExpression::parsePower() {
+  int a = parsePrimary();
+  if (a < 0) return -1;
+  if (accept("**")) {
+    int b = parseUnary();
+    if (b < 0) return -1;
+    return emit(Pow, a, b);
+  }
+  return a;
+}
+
+int CalcExpression::parsePrimary() {
+  skipSpace();
+  if (pos >= source.size()) return fail("unexpected end of expression");
+
+  if (accept("(")) {
+    int a = parseTernary();
+    if (a < 0) return -1;
+    if (!accept(")")) return fail("expected ')'");
+    return a;
+  }
+
+  char c = source[pos];
+  if (isdigit(static_cast<unsigned char>(c)) || c == '.') {
+    const char *start = source.c_str() + pos;
+    char *end;
+    double value = strtod(start, &end);
+    if (end == start) return fail("invalid number");
+    pos += end - start;
+    return emit(Const, -1, -1, -1, value);
+  }
+
+  if (isalpha(static_cast<unsigned char>(c)) || c == '_') {
+    size_t start = pos;
+    while (pos < source.size() && (isalnum(static_cast<unsigned char>(source[pos])) || source[pos] == '_')) pos++;
+    std::string name = source.substr(start, pos - start);
+
+    skipSpace();
+    if (pos < source.size() && source[pos] == '(') {
+      static const struct {
+        const char *name;
+        Opcode op;
+        int args;
+      } functions[] = {
+        {"abs", Abs, 1},
+        {"sqrt", Sqrt, 1},
+        {"exp", Exp, 1},
+        {"log", Log, 1},
+        {"floor", Floor, 1},
+        {"ceil", Ceil, 1},
+        {"min", Min, 2},
+        {"max", Max, 2},
+        {"pow", Pow, 2}};
+      for (const auto &fn : functions) {
+        if (name != fn.name) continue;
+        pos++;
+        int a = parseTernary();
+        if (a < 0) return -1;
+        int b = -1;
+        if (fn.args == 2) {
+          if (!accept(",")) return fail("expected ','");
+          b = parseTernary();
+          if (b < 0) return -1;
+        }
+        if (!accept(")")) return fail("expected ')'");
+        return emit(fn.op, a, b);
+      }
+      return fail("unknown function " + name);
+    }
+
+    for (size_t i = 0; i < vars.size(); i++)
+      if (vars[i] == name) return emit(Var, static_cast<int>(i));
+    if (name == "NaN") return emit(Const, -1, -1, -1, NAN);
+    return fail("unknown variable " + name);
+  }
+
+  return fail("unexpected character");
+}
+
+// The loops below are the hot path, they must stay simple enough
+// to be vectorized by the compiler (no function calls except the
+// ones that have vector versions, no branches, no aliasing)
+#define CALC_UNARY(EXPR)                                                                                               \
+  {                                                                                                                    \
+    const double *x = reg(op.a);                                                                                       \
+    for (size_t i = 0; i < n; i++) d[i] = (EXPR);                                                                      \
+  }                                                                                                                    \
+  break;
+
+#define CALC_BINARY(EXPR)                                                                                              \
+  {                                                                                                                    \
+    const double *x = reg(op.a);                                                                                       \
+    const double *y = reg(op.b);                                                                                       \
+    for (size_t i = 0; i < n; i++) d[i] = (EXPR);                                                                      \
+  }                                                                                                                    \
+  break;
+
+// The pixels are processed in small blocks so that all the registers stay in the CPU cache
+static const size_t calcBlockSize = 4096;
+
+void CalcExpression::evaluate(
+  const std::vector<const double *> &inputs, double *result, size_t n, std::vector<double> &scratch) const {
+  if (program.empty()) return;
+  if (scratch.size() < program.size() * calcBlockSize) scratch.resize(program.size() * calcBlockSize);
+
+  std::vector<const double *> block_inputs(inputs.size());
+  for (size_t offset = 0; offset < n; offset += calcBlockSize) {
+    size_t len = std::min(calcBlockSize, n - offset);
+    for (size_t i = 0; i < inputs.size(); i++) block_inputs[i] = inputs[i] + offset;
+    evaluateBlock(block_inputs, result + offset, len, scratch);
+  }
+}
+
+void CalcExpression::evaluateBlock(
+  const std::vector<const double *> &inputs, double *result, size_t n, std::vector<double> &scratch) const {
+  // Variables are not copied, their registers point to the input
+  std::vector<const double *> regs(program.size());
+  for (size_t r = 0; r < program.size(); r++) {
+    if (program[r].op == Var)
+      regs[r] = inputs[program[r].a];
+    else
+      regs[r] = r == program.size() - 1 ? result : scratch.data() + r * calcBlockSize;
+  }
+  auto reg = [&regs](int r) { return regs[r]; };
+
+  for (size_t r = 0; r < program.size(); r++) {
+    const Operation &op = program[r];
+    if (op.op == Var) continue;
+    double *d = const_cast<double *>(regs[r]);
+    switch (op.op) {
+      case Const: {
+        double v = op.value;
+        for (size_t i = 0; i < n; i++) d[i] = v;
+      } break;
+      case Var: break;
+      case Neg: CALC_UNARY(-x[i]);
+      case Not: CALC_UNARY(x[i] == 0 ? 1.0 : 0.0);
+      case Abs: CALC_UNARY(std::fabs(x[i]));
+      case Sqrt: CALC_UNARY(std::sqrt(x[i]));
+      case Exp: CALC_UNARY(std::exp(x[i]));
+      case Log: CALC_UNARY(std::log(x[i]));
+      case Floor: CALC_UNARY(std::floor(x[i]));
+      case Ceil: CALC_UNARY(std::ceil(x[i]));
+      case Add: CALC_BINARY(x[i] + y[i]);
+      case Sub: CALC_BINARY(x[i] - y[i]);
+      case Mul: CALC_BINARY(x[i] * y[i]);
+      case Div: CALC_BINARY(x[i] / y[i]);
+      case Pow: CALC_BINARY(std::pow(x[i], y[i]));
+      // NaN-propagating like Math.min/Math.max
+      case Min: CALC_BINARY(x[i] != x[i] || y[i] != y[i] ? NAN : (x[i] < y[i] ? x[i] : y[i]));
+      case Max: CALC_BINARY(x[i] != x[i] || y[i] != y[i] ? NAN : (x[i] > y[i] ? x[i] : y[i]));
+      case Lt: CALC_BINARY(x[i] < y[i] ? 1.0 : 0.0);
+      case Le: CALC_BINARY(x[i] <= y[i] ? 1.0 : 0.0);
+      case Gt: CALC_BINARY(x[i] > y[i] ? 1.0 : 0.0);
+      case Ge: CALC_BINARY(x[i] >= y[i] ? 1.0 : 0.0);
+      case Eq: CALC_BINARY(x[i] == y[i] ? 1.0 : 0.0);
+      case Ne: CALC_BINARY(x[i] != y[i] ? 1.0 : 0.0);
+      case And: CALC_BINARY(x[i] != 0 && y[i] != 0 ? 1.0 : 0.0);
+      case Or: CALC_BINARY(x[i] != 0 || y[i] != 0 ? 1.0 : 0.0);
+      case Select: {
+        const double *c = reg(op.a);
+        const double *x = reg(op.b);
+        const double *y = reg(op.c);
+        for (size_t i = 0; i < n; i++) d[i] = c[i] != 0 ? x[i] : y[i];
+      } break;
+    }
+  }
+
+  // The result register is a variable when the expression is a single variable
+  if (program.back().op == Var) {
+    const double *src = regs.back();
+    for (size_t i = 0; i < n; i++) result[i] = src[i];
+  }
+}
+
+} // namespace node_gdal
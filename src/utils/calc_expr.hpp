@@ -0,0 +1,102 @@
+#ifndef __CALC_EXPR_H__
+#define __CALC_EXPR_H__
+
+#include <string>
+#include <vector>
+
+namespace node_gdal {
+
+// A small arithmetic expression language for pixel-wise raster calculations
+//
+// The expression is compiled to a list of operations on registers
+// Each operation is applied to a whole chunk of pixels at once
+// in a tight loop without branches that the compiler vectorizes
+// for the instruction set of the build target - no intrinsics are used
+//
+// Supported syntax:
+// * numbers and variables (the names of the input bands)
+// * + - * / ** (power), unary - and !
+// * < <= > >= == != && || (the result is 1 or 0)
+// * c ? a : b
+// * abs(x), sqrt(x), exp(x), log(x), floor(x), ceil(x), min(x, y), max(x, y), pow(x, y)
+
+class CalcExpression {
+    public:
+  CalcExpression();
+
+  // Returns false and sets error() if the expression is not valid
+  bool compile(const std::string &expr, const std::vector<std::string> &variables);
+  inline const std::string &error() const {
+    return err;
+  }
+
+  // inputs[i] are the n values of variables[i], result receives n values
+  // scratch is resized as needed and can be reused between calls
+  void evaluate(const std::vector<const double *> &inputs, double *result, size_t n, std::vector<double> &scratch)
+    const;
+
+  enum Opcode {
+    Const,
+    Var,
+    Neg,
+    Not,
+    Abs,
+    Sqrt,
+    Exp,
+    Log,
+    Floor,
+    Ceil,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Pow,
+    Min,
+    Max,
+    Lt,
+    Le,
+    Gt,
+    Ge,
+    Eq,
+    Ne,
+    And,
+    Or,
+    Select
+  };
+
+  // The result of every operation goes to its own register
+  // the result of the last one is the result of the expression
+  struct Operation {
+    Opcode op;
+    int a, b, c;
+    double value;
+  };
+
+    private:
+  std::vector<Operation> program;
+  std::vector<std::string> vars;
+  std::string source;
+  size_t pos;
+  std::string err;
+
+  void evaluateBlock(
+    const std::vector<const double *> &inputs, double *result, size_t n, std::vector<double> &scratch) const;
+  int emit(Opcode op, int a = -1, int b = -1, int c = -1, double value = 0);
+  void skipSpace();
+  bool accept(const char *token);
+  int parseTernary();
+  int parseOr();
+  int parseAnd();
+  int parseEquality();
+  int parseComparison();
+  int parseAdditive();
+  int parseMultiplicative();
+  int parseUnary();
+  int parsePower();
+  int parsePrimary();
+  int fail(const std::string &msg);
+};
+
+} // namespace node_gdal
+
+#endif
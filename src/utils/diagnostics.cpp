@@ -0,0 +1,37 @@
+#include "diagnostics.hpp"
+
+namespace node_gdal {
+
+thread_local Diagnostics diagnostics;
+
+Diagnostics::Diagnostics() : enabled(false) {
+}
+
+void Diagnostics::setChannels(v8::Local<v8::Object> start, v8::Local<v8::Object> lock, v8::Local<v8::Object> end) {
+  channels[static_cast<int>(JobEvent::Start)].Reset(start);
+  channels[static_cast<int>(JobEvent::Lock)].Reset(lock);
+  channels[static_cast<int>(JobEvent::End)].Reset(end);
+  enabled = true;
+}
+
+// This is the only cost of the integration when nobody is listening
+bool Diagnostics::active(JobEvent event) {
+  if (!enabled) return false;
+  Nan::HandleScope scope;
+  v8::Local<v8::Object> channel = Nan::New(channels[static_cast<int>(event)]);
+  Nan::MaybeLocal<v8::Value> subscribers = Nan::Get(channel, Nan::New("hasSubscribers").ToLocalChecked());
+  return !subscribers.IsEmpty() && Nan::To<bool>(subscribers.ToLocalChecked()).FromMaybe(false);
+}
+
+// The errors of the subscribers are reported by diagnostics_channel itself
+void Diagnostics::publish(JobEvent event, v8::Local<v8::Object> message) {
+  Nan::HandleScope scope;
+  v8::Local<v8::Object> channel = Nan::New(channels[static_cast<int>(event)]);
+  Nan::MaybeLocal<v8::Value> publish = Nan::Get(channel, Nan::New("publish").ToLocalChecked());
+  if (publish.IsEmpty() || !publish.ToLocalChecked()->IsFunction()) return;
+  v8::Local<v8::Value> argv[] = {message};
+  Nan::TryCatch try_catch;
+  Nan::Call(publish.ToLocalChecked().As<v8::Function>(), channel, 1, argv);
+}
+
+} // namespace node_gdal
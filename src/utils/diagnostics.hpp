@@ -0,0 +1,36 @@
+#ifndef __NODE_GDAL_DIAGNOSTICS_H__
+#define __NODE_GDAL_DIAGNOSTICS_H__
+
+#include "../nan-wrapper.h"
+
+namespace node_gdal {
+
+// The events of the async jobs, one diagnostics_channel each
+enum class JobEvent { Start = 0, Lock = 1, End = 2 };
+
+//
+// The diagnostics_channel integration of the async jobs
+//
+// The Channel objects are created by lib/diagnostics.js when the module
+// is available, a job builds and publishes its message only when
+// someone is subscribed to the channel
+//
+// Main thread only
+//
+class Diagnostics {
+    public:
+  Diagnostics();
+  void setChannels(v8::Local<v8::Object> start, v8::Local<v8::Object> lock, v8::Local<v8::Object> end);
+  bool active(JobEvent event);
+  void publish(JobEvent event, v8::Local<v8::Object> message);
+
+    private:
+  bool enabled;
+  Nan::Persistent<v8::Object> channels[3];
+};
+
+extern thread_local Diagnostics diagnostics;
+
+} // namespace node_gdal
+
+#endif
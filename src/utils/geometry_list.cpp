@@ -0,0 +1,57 @@
+#include "geometry_list.hpp"
+#include "../gdal_common.hpp"
+#include "../geometry/gdal_geometry.hpp"
+
+namespace node_gdal {
+
+OGRGeometry *GeometrySource::acquire() const {
+  if (geom != nullptr) {
+    uv_sem_wait(lock);
+    return geom;
+  }
+  OGRGeometry *parsed = nullptr;
+  OGRErr err = OGRGeometryFactory::createFromWkb(wkb, nullptr, &parsed, length);
+  if (err) throw getOGRErrMsg(err);
+  return parsed;
+}
+
+void GeometrySource::release(OGRGeometry *acquired) const {
+  if (geom != nullptr)
+    uv_sem_post(lock);
+  else
+    OGRGeometryFactory::destroyGeometry(acquired);
+}
+
+GeometryList::GeometryList(bool accept_null, bool accept_wkb)
+  : accept_null(accept_null), accept_wkb(accept_wkb), sources(), copy() {
+}
+
+int GeometryList::parse(Local<Array> array, const char *error) {
+  copy = Nan::New<Array>(array->Length());
+  sources.reserve(array->Length());
+  for (unsigned i = 0; i < array->Length(); i++) {
+    Local<Value> element = Nan::Get(array, i).ToLocalChecked();
+    if (accept_null && (element->IsNull() || element->IsUndefined())) {
+      sources.push_back({nullptr, nullptr, nullptr, 0});
+      continue;
+    }
+    if (IS_WRAPPED(element, Geometry)) {
+      Geometry *geom = Nan::ObjectWrap::Unwrap<Geometry>(element.As<Object>());
+      if (!geom->isAlive()) {
+        Nan::ThrowError("Geometry object has already been destroyed");
+        return 1;
+      }
+      sources.push_back({geom->get(), geom->asyncLock(), nullptr, 0});
+    } else if (accept_wkb && Buffer::HasInstance(element)) {
+      sources.push_back(
+        {nullptr, nullptr, reinterpret_cast<unsigned char *>(Buffer::Data(element)), Buffer::Length(element)});
+    } else {
+      Nan::ThrowTypeError(error);
+      return 1;
+    }
+    Nan::Set(copy, i, element);
+  }
+  return 0;
+}
+
+} // namespace node_gdal
@@ -0,0 +1,70 @@
+#ifndef __NODE_GDAL_GEOMETRY_LIST_H__
+#define __NODE_GDAL_GEOMETRY_LIST_H__
+
+#include <vector>
+
+// node
+#include <node.h>
+#include <uv.h>
+
+// nan
+#include "../nan-wrapper.h"
+
+// ogr
+#include <ogr_geometry.h>
+
+using namespace v8;
+
+namespace node_gdal {
+
+// A geometry used by a job, either a Geometry object that is locked while
+// it is used or a WKB buffer that is parsed in the job
+struct GeometrySource {
+  OGRGeometry *geom;
+  uv_sem_t *lock;
+  unsigned char *wkb;
+  size_t length;
+
+  inline bool isNull() const {
+    return geom == nullptr && wkb == nullptr;
+  }
+
+  // Locks or parses the geometry, throws a const char * if the WKB is invalid
+  OGRGeometry *acquire() const;
+  void release(OGRGeometry *acquired) const;
+};
+
+// A class for parsing an array of geometries passed to a job
+//
+// inputs:
+// [Geometry | Buffer | null, ...]
+//
+// outputs:
+// one GeometrySource per element, the null elements have neither a geometry nor a WKB
+//
+// The array is copied so that its elements remain protected from the GC even
+// if the caller modifies it while the job is running, the job must persist the copy
+class GeometryList {
+    public:
+  GeometryList(bool accept_null, bool accept_wkb);
+
+  int parse(Local<Array> array, const char *error);
+
+  inline const std::vector<GeometrySource> &get() const {
+    return sources;
+  }
+
+  inline Local<Array> persistent() const {
+    return copy;
+  }
+
+    private:
+  bool accept_null;
+  bool accept_wkb;
+  std::vector<GeometrySource> sources;
+  Local<Array> copy;
+};
+
+} // namespace node_gdal
+
+#endif
@@ -0,0 +1,81 @@
+#include "helper_threads.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+
+namespace node_gdal {
+
+static std::atomic<int> helpersInUse(0);
+
+int reserveHelpers(int wanted) {
+  int max = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  int used = helpersInUse.load();
+  int n;
+  do {
+    n = std::max(0, std::min(wanted, max - used));
+  } while (!helpersInUse.compare_exchange_weak(used, used + n));
+  return n;
+}
+
+void releaseHelpers(int n) {
+  helpersInUse -= n;
+}
+
+HelperThreads::HelperThreads(int wanted) : pending(0), stopping(false) {
+  int reserved = reserveHelpers(wanted);
+  try {
+    for (int i = 0; i < reserved; i++) threads.emplace_back(&HelperThreads::work, this);
+  } catch (const std::system_error &) {
+    // Continue with the threads that were started
+  }
+  releaseHelpers(reserved - static_cast<int>(threads.size()));
+}
+
+HelperThreads::~HelperThreads() {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stopping = true;
+  }
+  ready.notify_all();
+  for (std::thread &t : threads) t.join();
+  releaseHelpers(static_cast<int>(threads.size()));
+}
+
+void HelperThreads::submit(const std::function<void()> &task) {
+  if (threads.empty()) {
+    task();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    tasks.push_back(task);
+    pending++;
+  }
+  ready.notify_one();
+}
+
+void HelperThreads::wait() {
+  std::unique_lock<std::mutex> guard(lock);
+  idle.wait(guard, [this]() { return pending == 0; });
+}
+
+void HelperThreads::work() {
+  std::unique_lock<std::mutex> guard(lock);
+  while (true) {
+    if (!tasks.empty()) {
+      std::function<void()> task = std::move(tasks.front());
+      tasks.pop_front();
+      guard.unlock();
+      task();
+      guard.lock();
+      if (--pending == 0) idle.notify_all();
+    } else if (stopping) {
+      return;
+    } else {
+      ready.wait(guard);
+    }
+  }
+}
+
+} // namespace node_gdal
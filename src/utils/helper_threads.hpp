@@ -0,0 +1,53 @@
+#ifndef __NODE_GDAL_HELPER_THREADS_H__
+#define __NODE_GDAL_HELPER_THREADS_H__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace node_gdal {
+
+// The helper threads started by the jobs themselves share a process-wide budget
+// of one thread per core, so concurrent jobs cannot oversubscribe the CPU
+//
+// reserveHelpers returns the number of threads that were actually reserved
+int reserveHelpers(int wanted);
+void releaseHelpers(int n);
+
+// A fixed set of helper threads running the tasks of one job,
+// they are joined when it goes out of scope, even if the job throws
+//
+// It can end up with fewer threads than wanted when the budget is exhausted or
+// when a thread cannot be started, without any threads the tasks are run
+// by the calling thread
+class HelperThreads {
+    public:
+  HelperThreads(int wanted);
+  ~HelperThreads();
+
+  inline int size() const {
+    return static_cast<int>(threads.size());
+  }
+
+  void submit(const std::function<void()> &task);
+  // Wait for all the submitted tasks
+  void wait();
+
+    private:
+  std::vector<std::thread> threads;
+  std::mutex lock;
+  std::condition_variable ready;
+  std::condition_variable idle;
+  std::deque<std::function<void()>> tasks;
+  size_t pending;
+  bool stopping;
+
+  void work();
+};
+
+} // namespace node_gdal
+
+#endif
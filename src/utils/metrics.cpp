@@ -0,0 +1,220 @@
+#include "metrics.hpp"
+#include "proj_cache.hpp"
+#include "../gdal_common.hpp"
+
+namespace node_gdal {
+
+thread_local Metrics metrics;
+std::atomic<uint64_t> bytesRead(0);
+thread_local const char *currentMethodName = nullptr;
+
+MetricsHistogram::MetricsHistogram() : count(0), sum(0), max(0) {
+  for (int i = 0; i < buckets; i++) counts[i] = 0;
+}
+
+int MetricsHistogram::bucketOf(uint64_t us) {
+  if (us < 2 * subBuckets) return static_cast<int>(us);
+  int e = 0;
+  for (uint64_t v = us; v > 1; v >>= 1) e++;
+  int bucket = subBuckets * (e - 1) + static_cast<int>((us >> (e - 2)) & (subBuckets - 1));
+  return bucket < buckets ? bucket : buckets - 1;
+}
+
+// The highest value that falls in a bucket
+uint64_t MetricsHistogram::upperBound(int bucket) {
+  if (bucket < 2 * subBuckets) return bucket;
+  int e = bucket / subBuckets + 1;
+  uint64_t step = uint64_t(1) << (e - 2);
+  return (subBuckets + bucket % subBuckets) * step + step - 1;
+}
+
+void MetricsHistogram::record(int64_t us) {
+  uint64_t v = us > 0 ? static_cast<uint64_t>(us) : 0;
+  counts[bucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+  count.fetch_add(1, std::memory_order_relaxed);
+  sum.fetch_add(v, std::memory_order_relaxed);
+  uint64_t prev = max.load(std::memory_order_relaxed);
+  while (prev < v && !max.compare_exchange_weak(prev, v, std::memory_order_relaxed))
+    ;
+}
+
+void MetricsHistogram::reset() {
+  for (int i = 0; i < buckets; i++) counts[i].store(0, std::memory_order_relaxed);
+  count.store(0, std::memory_order_relaxed);
+  sum.store(0, std::memory_order_relaxed);
+  max.store(0, std::memory_order_relaxed);
+}
+
+// The buckets can be updated while they are being read, the result is approximate
+double MetricsHistogram::percentile(double p) const {
+  uint64_t snapshot[buckets];
+  uint64_t total = 0;
+  for (int i = 0; i < buckets; i++) {
+    snapshot[i] = counts[i].load(std::memory_order_relaxed);
+    total += snapshot[i];
+  }
+  if (total == 0) return 0;
+  uint64_t rank = static_cast<uint64_t>(p * total + 0.5);
+  if (rank < 1) rank = 1;
+  uint64_t seen = 0;
+  uint64_t highest = max.load(std::memory_order_relaxed);
+  for (int i = 0; i < buckets; i++) {
+    seen += snapshot[i];
+    if (seen >= rank) return static_cast<double>(std::min(upperBound(i), highest));
+  }
+  return static_cast<double>(highest);
+}
+
+v8::Local<v8::Object> MetricsHistogram::toObject() const {
+  Nan::EscapableHandleScope scope;
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  uint64_t n = count.load(std::memory_order_relaxed);
+  double total = static_cast<double>(sum.load(std::memory_order_relaxed));
+  Nan::Set(result, Nan::New("count").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(n)));
+  Nan::Set(result, Nan::New("mean").ToLocalChecked(), Nan::New<v8::Number>(n > 0 ? total / n / 1000 : 0));
+  Nan::Set(
+    result,
+    Nan::New("max").ToLocalChecked(),
+    Nan::New<v8::Number>(static_cast<double>(max.load(std::memory_order_relaxed)) / 1000));
+  Nan::Set(result, Nan::New("p50").ToLocalChecked(), Nan::New<v8::Number>(percentile(0.5) / 1000));
+  Nan::Set(result, Nan::New("p90").ToLocalChecked(), Nan::New<v8::Number>(percentile(0.9) / 1000));
+  Nan::Set(result, Nan::New("p99").ToLocalChecked(), Nan::New<v8::Number>(percentile(0.99) / 1000));
+  return scope.Escape(result);
+}
+
+void MethodMetrics::reset() {
+  calls.store(0, std::memory_order_relaxed);
+  errors.store(0, std::memory_order_relaxed);
+  lockWait.reset();
+  queueWait.reset();
+  execute.reset();
+  rval.reset();
+}
+
+Metrics::Metrics() : methods(), byPointer(), datasets(), pruneAt(64) {
+}
+
+// "RasterBandPixels::read" -> "RasterBandPixels.read", "Dataset::srsGetter" -> "Dataset.srs"
+static std::string methodName(const char *name) {
+  if (name == nullptr) return "unknown";
+  std::string r(name);
+  for (size_t i = r.find("::"); i != std::string::npos; i = r.find("::", i + 1)) r.replace(i, 2, ".");
+  static const std::string getter = "Getter";
+  if (r.size() > getter.size() && r.compare(r.size() - getter.size(), getter.size(), getter) == 0)
+    r.erase(r.size() - getter.size());
+  return r;
+}
+
+MethodMetrics *Metrics::method(const char *name) {
+  auto cached = byPointer.find(name);
+  if (cached != byPointer.end()) return cached->second;
+  std::string key = methodName(name);
+  std::unique_ptr<MethodMetrics> &entry = methods[key];
+  if (entry == nullptr) entry.reset(new MethodMetrics(key));
+  byPointer[name] = entry.get();
+  return entry.get();
+}
+
+void Metrics::scheduled(const std::vector<long> &uids) {
+  // The entries of the Datasets closed while idle are dropped every time the registry doubles in size
+  if (datasets.size() >= pruneAt) {
+    prune();
+    pruneAt = std::max<size_t>(64, 2 * datasets.size());
+  }
+  for (long uid : uids) {
+    DatasetMetrics &ds = datasets[uid];
+    ds.inFlight++;
+    ds.jobs++;
+  }
+}
+
+void Metrics::queued(const std::vector<long> &uids) {
+  for (long uid : uids) datasets[uid].waiting++;
+}
+
+void Metrics::dispatched(const std::vector<long> &uids, bool queued, int64_t lock_wait) {
+  for (long uid : uids) {
+    DatasetMetrics &ds = datasets[uid];
+    if (queued) ds.waiting--;
+    ds.lockWait += lock_wait;
+  }
+}
+
+// The entry of a closed Dataset is dropped with its last job
+void Metrics::completed(const std::vector<long> &uids) {
+  for (long uid : uids) {
+    auto it = datasets.find(uid);
+    if (it == datasets.end()) continue;
+    it->second.inFlight--;
+    if (it->second.inFlight <= 0 && it->second.waiting <= 0 && !object_store.isAlive(uid)) datasets.erase(it);
+  }
+}
+
+// The entries of the closed Datasets are dropped once they are idle
+void Metrics::prune() {
+  for (auto it = datasets.begin(); it != datasets.end();) {
+    if (it->second.inFlight <= 0 && it->second.waiting <= 0 && !object_store.isAlive(it->first))
+      it = datasets.erase(it);
+    else
+      it++;
+  }
+}
+
+v8::Local<v8::Object> Metrics::toObject() {
+  Nan::EscapableHandleScope scope;
+  prune();
+
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  v8::Local<v8::Object> methodsObj = Nan::New<v8::Object>();
+  for (auto const &m : methods) {
+    const MethodMetrics &mm = *m.second;
+    if (mm.calls.load(std::memory_order_relaxed) == 0) continue;
+    v8::Local<v8::Object> obj = Nan::New<v8::Object>();
+    Nan::Set(
+      obj,
+      Nan::New("calls").ToLocalChecked(),
+      Nan::New<v8::Number>(static_cast<double>(mm.calls.load(std::memory_order_relaxed))));
+    Nan::Set(
+      obj,
+      Nan::New("errors").ToLocalChecked(),
+      Nan::New<v8::Number>(static_cast<double>(mm.errors.load(std::memory_order_relaxed))));
+    Nan::Set(obj, Nan::New("lockWait").ToLocalChecked(), mm.lockWait.toObject());
+    Nan::Set(obj, Nan::New("queueWait").ToLocalChecked(), mm.queueWait.toObject());
+    Nan::Set(obj, Nan::New("execute").ToLocalChecked(), mm.execute.toObject());
+    Nan::Set(obj, Nan::New("rval").ToLocalChecked(), mm.rval.toObject());
+    Nan::Set(methodsObj, Nan::New(m.first).ToLocalChecked(), obj);
+  }
+  Nan::Set(result, Nan::New("methods").ToLocalChecked(), methodsObj);
+
+  v8::Local<v8::Object> datasetsObj = Nan::New<v8::Object>();
+  for (auto const &d : datasets) {
+    v8::Local<v8::Object> obj = Nan::New<v8::Object>();
+    Nan::Set(obj, Nan::New("inFlight").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(d.second.inFlight)));
+    Nan::Set(obj, Nan::New("waiting").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(d.second.waiting)));
+    Nan::Set(obj, Nan::New("jobs").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(d.second.jobs)));
+    Nan::Set(
+      obj, Nan::New("lockWait").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(d.second.lockWait) / 1000));
+    Nan::Set(datasetsObj, Nan::New<v8::Number>(static_cast<double>(d.first)), obj);
+  }
+  Nan::Set(result, Nan::New("datasets").ToLocalChecked(), datasetsObj);
+
+  Nan::Set(
+    result,
+    Nan::New("bytesRead").ToLocalChecked(),
+    Nan::New<v8::Number>(static_cast<double>(bytesRead.load(std::memory_order_relaxed))));
+  Nan::Set(result, Nan::New("projCache").ToLocalChecked(), proj_cache.toObject());
+  return scope.Escape(result);
+}
+
+// The in-flight and waiting counters describe the current state and they are not reset
+void Metrics::reset() {
+  for (auto const &m : methods) m.second->reset();
+  for (auto &d : datasets) {
+    d.second.jobs = 0;
+    d.second.lockWait = 0;
+  }
+  bytesRead.store(0, std::memory_order_relaxed);
+  proj_cache.reset();
+}
+
+} // namespace node_gdal
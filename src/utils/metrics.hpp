@@ -0,0 +1,135 @@
+#ifndef __NODE_GDAL_METRICS_H__
+#define __NODE_GDAL_METRICS_H__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../nan-wrapper.h"
+
+namespace node_gdal {
+
+// Microseconds on a monotonic clock, all the timestamps of the metrics use it
+inline int64_t metricsNow() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+//
+// A lock-free log-linear histogram of durations in microseconds
+//
+// The values below 8 µs have their own bucket, above that each power
+// of 2 is divided in 4 buckets - the relative error is at most 25%
+// recording is a few relaxed atomic increments and it never allocates
+//
+class MetricsHistogram {
+    public:
+  static const int subBuckets = 4;
+  // Up to 2^40 µs, about 12 days
+  static const int buckets = 40 * subBuckets;
+
+  MetricsHistogram();
+  void record(int64_t us);
+  void reset();
+  v8::Local<v8::Object> toObject() const;
+
+    private:
+  std::atomic<uint64_t> counts[buckets];
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> sum;
+  std::atomic<uint64_t> max;
+
+  static int bucketOf(uint64_t us);
+  static uint64_t upperBound(int bucket);
+  double percentile(double p) const;
+};
+
+// The metrics of one method, updated from any thread
+struct MethodMetrics {
+  // ie "RasterBandPixels.read"
+  const std::string name;
+  std::atomic<uint64_t> calls;
+  std::atomic<uint64_t> errors;
+  // Waiting in the queue of the Dataset for the lock
+  MetricsHistogram lockWait;
+  // Waiting in the thread pool queue for a thread
+  MetricsHistogram queueWait;
+  // Running in GDAL
+  MetricsHistogram execute;
+  // Producing the JS result on the main thread
+  MetricsHistogram rval;
+
+  MethodMetrics(const std::string &name) : name(name), calls(0), errors(0) {
+  }
+  void reset();
+};
+
+// The metrics of one Dataset, main thread only
+struct DatasetMetrics {
+  // Jobs scheduled and not completed yet
+  int64_t inFlight;
+  // Jobs waiting in the queue of the Dataset
+  int64_t waiting;
+  uint64_t jobs;
+  uint64_t lockWait;
+};
+
+//
+// The performance metrics of the async jobs, returned by gdal.metrics()
+//
+// The method entries are created on the main thread, the jobs keep a pointer to
+// theirs so that the worker threads never touch the registry
+//
+class Metrics {
+    public:
+  Metrics();
+  // main thread only
+  MethodMetrics *method(const char *name);
+  void scheduled(const std::vector<long> &uids);
+  void queued(const std::vector<long> &uids);
+  void dispatched(const std::vector<long> &uids, bool queued, int64_t lock_wait);
+  void completed(const std::vector<long> &uids);
+  v8::Local<v8::Object> toObject();
+  void reset();
+
+    private:
+  std::map<std::string, std::unique_ptr<MethodMetrics>> methods;
+  // The method names are string literals, this avoids building a string for every job
+  std::unordered_map<const char *, MethodMetrics *> byPointer;
+  std::map<long, DatasetMetrics> datasets;
+  // The size of the Dataset registry that triggers the next prune()
+  size_t pruneAt;
+
+  void prune();
+};
+
+// One per isolate
+extern thread_local Metrics metrics;
+
+// The raster data read by all the isolates, it is counted in the worker threads
+extern std::atomic<uint64_t> bytesRead;
+
+// The name of the method being called, set by the GDAL_ASYNCABLE macros (main thread only)
+extern thread_local const char *currentMethodName;
+
+class MethodNameScope {
+  const char *previous;
+
+    public:
+  inline MethodNameScope(const char *name) : previous(currentMethodName) {
+    currentMethodName = name;
+  }
+  inline ~MethodNameScope() {
+    currentMethodName = previous;
+  }
+};
+
+} // namespace node_gdal
+
+#endif
@@ -0,0 +1,106 @@
+#include "proj_cache.hpp"
+#include "../gdal_common.hpp"
+
+namespace node_gdal {
+
+ProjCache &proj_cache = *new ProjCache();
+
+ProjCache::ProjCache()
+  : capacity_(64),
+    srs(OGRSpatialReference::DestroySpatialReference),
+    transformations(OGRCoordinateTransformation::DestroyCT) {
+}
+
+OGRErr ProjCache::spatialReference(
+  const std::string &key, const std::function<OGRErr(OGRSpatialReference *)> &import, OGRSpatialReference *&result) {
+  result = srs.get(key);
+  if (result != nullptr) return OGRERR_NONE;
+
+  OGRSpatialReference *created = new OGRSpatialReference();
+  OGRErr err = import(created);
+  if (err) {
+    delete created;
+    return err;
+  }
+  srs.put(key, created, capacity_);
+  result = created;
+  return OGRERR_NONE;
+}
+
+#if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
+// An empty string when the spatial reference cannot be exported
+static std::string transformationKey(OGRSpatialReference *srs) {
+  char *wkt = nullptr;
+  const char *const options[] = {"FORMAT=WKT2_2019", nullptr};
+  if (srs->exportToWkt(&wkt, options) != OGRERR_NONE || wkt == nullptr) {
+    CPLFree(wkt);
+    return "";
+  }
+  std::string key(wkt);
+  CPLFree(wkt);
+  for (int axis : srs->GetDataAxisToSRSAxisMapping()) key += "," + std::to_string(axis);
+#if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 4)
+  key += "@" + std::to_string(srs->GetCoordinateEpoch());
+#endif
+  return key;
+}
+#endif
+
+OGRCoordinateTransformation *ProjCache::transformation(OGRSpatialReference *source, OGRSpatialReference *target) {
+#if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 1)
+  std::string source_key = transformationKey(source);
+  std::string target_key = transformationKey(target);
+  if (source_key.empty() || target_key.empty()) return OGRCreateCoordinateTransformation(source, target);
+
+  std::string key = source_key + "\n" + target_key;
+  OGRCoordinateTransformation *ct = transformations.get(key);
+  if (ct != nullptr) return ct;
+
+  ct = OGRCreateCoordinateTransformation(source, target);
+  if (ct != nullptr) transformations.put(key, ct, capacity_);
+  return ct;
+#else
+  // The transformations cannot be cloned
+  return OGRCreateCoordinateTransformation(source, target);
+#endif
+}
+
+size_t ProjCache::capacity() {
+  return capacity_;
+}
+
+void ProjCache::resize(size_t capacity) {
+  capacity_ = capacity;
+  srs.resize(capacity);
+  transformations.resize(capacity);
+}
+
+static v8::Local<v8::Object> cacheMetrics(uint64_t hits, uint64_t misses, size_t size) {
+  Nan::EscapableHandleScope scope;
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  Nan::Set(result, Nan::New("hits").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(hits)));
+  Nan::Set(result, Nan::New("misses").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(misses)));
+  Nan::Set(result, Nan::New("size").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(size)));
+  return scope.Escape(result);
+}
+
+v8::Local<v8::Object> ProjCache::toObject() {
+  Nan::EscapableHandleScope scope;
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  Nan::Set(result, Nan::New("srs").ToLocalChecked(), cacheMetrics(srs.hits, srs.misses, srs.size()));
+  Nan::Set(
+    result,
+    Nan::New("transformations").ToLocalChecked(),
+    cacheMetrics(transformations.hits, transformations.misses, transformations.size()));
+  return scope.Escape(result);
+}
+
+// The cached objects are kept
+void ProjCache::reset() {
+  srs.hits = 0;
+  srs.misses = 0;
+  transformations.hits = 0;
+  transformations.misses = 0;
+}
+
+} // namespace node_gdal
@@ -0,0 +1,128 @@
+#ifndef __NODE_GDAL_PROJ_CACHE_H__
+#define __NODE_GDAL_PROJ_CACHE_H__
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// ogr
+#include <ogr_spatialref.h>
+
+#include "../nan-wrapper.h"
+
+namespace node_gdal {
+
+//
+// A thread-safe LRU cache of immutable GDAL objects
+//
+// The cached objects are never handed out, the callers receive
+// clones that they own and that they are free to modify
+//
+template <typename T> class ProjCacheLRU {
+    public:
+  ProjCacheLRU(void (*destroy)(T *)) : hits(0), misses(0), destroy(destroy) {
+  }
+
+  // A clone of the cached object or nullptr if it is not in the cache
+  T *get(const std::string &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+      misses++;
+      return nullptr;
+    }
+    hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    // Cloning can refresh the internal state of the GDAL object, it is done with the lock held
+    return it->second->second->Clone();
+  }
+
+  // Caches a clone of obj, which remains owned by the caller
+  void put(const std::string &key, const T *obj, size_t capacity) {
+    if (capacity == 0) return;
+    T *clone = obj->Clone();
+    if (clone == nullptr) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index.count(key) > 0) {
+      // Another thread was faster
+      destroy(clone);
+      return;
+    }
+    entries.emplace_front(key, clone);
+    index[key] = entries.begin();
+    trim(capacity);
+  }
+
+  void resize(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    trim(capacity);
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+  }
+
+  std::atomic<uint64_t> hits, misses;
+
+    private:
+  std::mutex mutex;
+  std::list<std::pair<std::string, T *>> entries;
+  std::unordered_map<std::string, typename std::list<std::pair<std::string, T *>>::iterator> index;
+  void (*destroy)(T *);
+
+  void trim(size_t capacity) {
+    while (entries.size() > capacity) {
+      index.erase(entries.back().first);
+      destroy(entries.back().second);
+      entries.pop_back();
+    }
+  }
+};
+
+//
+// The process-wide cache of the spatial references and the coordinate transformations
+// shared by all the worker_threads
+//
+// Creating a spatial reference from an EPSG code or a definition requires
+// a lookup in the PROJ database and creating a transformation requires
+// building a PROJ pipeline - cloning an existing object is much cheaper
+//
+// The spatial references are keyed by the method and the definition that
+// created them, ie "EPSG:4326", the transformations by the WKT2 definitions
+// and the axis mappings of their source and target
+//
+// The cached objects are never freed at exit, PROJ may have been unloaded before
+//
+class ProjCache {
+    public:
+  ProjCache();
+
+  // Sets result to a new spatial reference owned by the caller,
+  // import is called only when the definition is not in the cache
+  OGRErr spatialReference(
+    const std::string &key, const std::function<OGRErr(OGRSpatialReference *)> &import, OGRSpatialReference *&result);
+  // A new transformation owned by the caller or nullptr if it cannot be created
+  OGRCoordinateTransformation *transformation(OGRSpatialReference *source, OGRSpatialReference *target);
+
+  size_t capacity();
+  void resize(size_t capacity);
+  v8::Local<v8::Object> toObject();
+  void reset();
+
+    private:
+  std::atomic<size_t> capacity_;
+  ProjCacheLRU<OGRSpatialReference> srs;
+  ProjCacheLRU<OGRCoordinateTransformation> transformations;
+};
+
+extern ProjCache &proj_cache;
+
+} // namespace node_gdal
+
+#endif
@@ -12,7 +12,8 @@
 
 // Here used to be dragons, but now there is a shopping mall
 //
-// This is the object store, a singleton
+// This is the object store, there is one per V8 isolate - the main thread
+// and each worker_thread that has loaded the module have their own
 //
 // It serves 2 purposes:
 //
@@ -32,22 +33,29 @@
 // Async lock semantics:
 //
 // * There is one global master lock, all operations on the ObjectStore structures
-//   must acquire it
+//   must acquire it, the registries are hash tables and the lookups are O(1)
 // * There is one async lock per dataset and it is a semaphore because it needs
 //   to support being acquired by the main thread and being unlocked in a worker
+// * The semaphore has more than one token if the Dataset supports parallel reads,
+//   read-only operations take one token (shared lock), all others take all of them
 // * Sync operations can sleep on the semaphore as only the main thread can
 //   delete a semaphore
-// * Async operations should sleep on the master_sleep condition as semaphores
-//   can be deleted by the main thread (but this would also mean that someone forgot
-//   to protect his object from the GC)
+// * Sync operations that wait for a Dataset sleep on the released condition of its
+//   lock (with the master lock) as semaphores can be deleted by the main thread
+//   (but this would also mean that someone forgot to protect his object from the GC)
 //   - Failing to protect an object from the GC means that GC could potentially sleep
 //   on a semaphore when disposing
 //   - GC that sleeps -> event loop that does run
 // * Acquiring a semaphore requires acquiring the master look otherwise the
 //   semaphore may disappear
-// * When waking from master_sleep, the presence of the semaphore (isAlive) must be
-//   checked again
-// * When unlocking a semaphore, the master_sleep condition is to be broadcasted
+// * When waking from the released condition, the presence of the semaphore (isAlive)
+//   must be checked again
+// * When unlocking a semaphore, its released condition is to be broadcasted
+//   and the async scheduler is to be notified - this wakes only the waiters of
+//   this Dataset
+// * Disposing a Dataset broadcasts its released condition so that its waiters fail
+// * Async jobs do not sleep at all - the scheduler acquires their locks on the
+//   main thread with tryLockDatasets before sending them to the thread pool
 // * Never acquire the master lock while holding a semaphore (deadlock avoidance)
 // * Multiple datasets are to be locked with .lockDataset which sorts locks (deadlock avoidance)
 // * Never sleep with the master lock held (performance)
@@ -62,15 +70,12 @@ namespace node_gdal {
 // these two must be here and must have file scope
 // MSVC throws an Internal Compiler Error when specializing templated variables
 // and the linker doesn't use the right address when processing exported symbols
-template <typename GDALPTR> using UidMap = map<long, shared_ptr<ObjectStoreItem<GDALPTR>>>;
-template <typename GDALPTR> using PtrMap = map<GDALPTR, shared_ptr<ObjectStoreItem<GDALPTR>>>;
-template <typename GDALPTR> static UidMap<GDALPTR> uidMap;
-template <typename GDALPTR> static PtrMap<GDALPTR> ptrMap;
-
-void uv_sem_deleter::operator()(uv_sem_t *p) {
-  uv_sem_destroy(p);
-  delete p;
-}
+// They are thread-local as each isolate has its own ObjectStore and they are accessed only
+// from the thread of the isolate - the worker threads touch only the async locks
+template <typename GDALPTR> using UidMap = unordered_map<long, shared_ptr<ObjectStoreItem<GDALPTR>>>;
+template <typename GDALPTR> using PtrMap = unordered_map<GDALPTR, shared_ptr<ObjectStoreItem<GDALPTR>>>;
+template <typename GDALPTR> static thread_local UidMap<GDALPTR> uidMap;
+template <typename GDALPTR> static thread_local PtrMap<GDALPTR> ptrMap;
 
 class uv_scoped_mutex {
     public:
@@ -85,7 +90,51 @@ class uv_scoped_mutex {
   uv_mutex_t *lock;
 };
 
-ObjectStore::ObjectStore() : uid(1) {
+AsyncLockState::AsyncLockState(unsigned max_readers) : max_readers(max_readers), primary(nullptr), pool() {
+  uv_sem_init(&sem, max_readers);
+  uv_cond_init(&released);
+  uv_mutex_init(&pool_lock);
+}
+
+AsyncLockState::~AsyncLockState() {
+  uv_sem_destroy(&sem);
+  uv_cond_destroy(&released);
+  uv_mutex_destroy(&pool_lock);
+}
+
+// Every shared lock holder can take one handle, there are as many handles as tokens
+GDALDataset *AsyncLockState::checkout() {
+  uv_scoped_mutex lock(&pool_lock);
+  GDALDataset *handle = pool.back();
+  pool.pop_back();
+  return handle;
+}
+
+void AsyncLockState::checkin(GDALDataset *handle) {
+  uv_scoped_mutex lock(&pool_lock);
+  pool.push_back(handle);
+}
+
+// Take one token for a shared lock or all the tokens for an exclusive lock
+// Never blocks, acquiring requires holding the master lock
+bool ObjectStore::tryAcquire(AsyncLockState *lock, bool shared) {
+  unsigned tokens = shared ? 1 : lock->max_readers;
+  for (unsigned i = 0; i < tokens; i++) {
+    if (uv_sem_trywait(&lock->sem) != 0) {
+      for (unsigned j = 0; j < i; j++) uv_sem_post(&lock->sem);
+      return false;
+    }
+  }
+  return true;
+}
+
+void ObjectStore::release(AsyncLockState *lock, bool shared) {
+  unsigned tokens = shared ? 1 : lock->max_readers;
+  for (unsigned i = 0; i < tokens; i++) uv_sem_post(&lock->sem);
+}
+
+
+ObjectStore::ObjectStore() : uid(1), release_notify(nullptr) {
 #ifdef PTHREAD_MUTEX_DEBUG
   pthread_mutexattr_t attr;
   pthread_mutexattr_init(&attr);
@@ -94,12 +143,10 @@ ObjectStore::ObjectStore() : uid(1) {
 #else
   uv_mutex_init(&master_lock);
 #endif
-  uv_cond_init(&master_sleep);
 }
 
 ObjectStore::~ObjectStore() {
   uv_mutex_destroy(&master_lock);
-  uv_cond_destroy(&master_sleep);
 }
 
 bool ObjectStore::isAlive(long uid) {
@@ -118,57 +165,57 @@ static inline void sortUnique(vector<long> &uids) {
   sort(uids.begin(), uids.end());
   // Eliminate dupes and 0s
   uids.erase(unique(uids.begin(), uids.end()), uids.end());
-  if (uids.front() == 0) uids.erase(uids.begin());
+  if (!uids.empty() && uids.front() == 0) uids.erase(uids.begin());
 }
 
 /*
  * Lock a Dataset by uid, throws when the Dataset has been destroyed.
- * There is a single global condition which allows to avoid active spinning.
- * Every time a Dataset releases a lock it must broadcast the condition.
+ * Every lock has its own condition which allows to avoid active spinning.
+ * Every time a Dataset releases a lock it must broadcast its condition.
  */
-AsyncLock ObjectStore::lockDataset(long uid) {
+AsyncLock ObjectStore::lockDataset(long uid, bool shared) {
   if (uid == 0) return nullptr;
   uv_scoped_mutex lock(&master_lock);
   while (true) {
     auto parent = uidMap<GDALDataset *>.find(uid);
     if (parent == uidMap<GDALDataset *>.end()) { throw "Parent Dataset object has already been destroyed"; }
-    int r = uv_sem_trywait(parent->second->async_lock.get());
-    if (r == 0) { return parent->second->async_lock; }
-    uv_cond_wait(&master_sleep, &master_lock);
+    // Keep the lock alive while sleeping, the Dataset can be destroyed in the meantime
+    AsyncLock async_lock = parent->second->async_lock;
+    if (tryAcquire(async_lock.get(), shared)) { return async_lock; }
+    uv_cond_wait(&async_lock->released, &master_lock);
   }
 }
 
 /*
  * Lock several Datasets by uid avoiding deadlocks, same semantics as the previous one.
  */
-vector<AsyncLock> ObjectStore::lockDatasets(vector<long> uids) {
+vector<AsyncLock> ObjectStore::lockDatasets(vector<long> uids, bool shared) {
   // There is lots of copying around here but these vectors are never longer than 3 elements
   sortUnique(uids);
   if (uids.size() == 0) return {};
   uv_scoped_mutex lock(&master_lock);
   while (true) {
-    try {
-      vector<AsyncLock> locks = _tryLockDatasets(uids);
-      if (locks.size() > 0) { return locks; }
-    } catch (const char *msg) { throw msg; }
-    uv_cond_wait(&master_sleep, &master_lock);
+    AsyncLock busy;
+    vector<AsyncLock> locks = _tryLockDatasets(uids, shared, &busy);
+    if (locks.size() > 0) { return locks; }
+    // Sleep until the Dataset that was busy is released
+    uv_cond_wait(&busy->released, &master_lock);
   }
 }
 
 /*
  * Acquire the lock only if it is free, do not block.
  */
-AsyncLock ObjectStore::tryLockDataset(long uid) {
+AsyncLock ObjectStore::tryLockDataset(long uid, bool shared) {
   if (uid == 0) return nullptr;
   uv_scoped_mutex lock(&master_lock);
   auto parent = uidMap<GDALDataset *>.find(uid);
   if (parent == uidMap<GDALDataset *>.end()) { throw "Parent Dataset object has already been destroyed"; }
-  int r = uv_sem_trywait(parent->second->async_lock.get());
-  if (r == 0) return parent->second->async_lock;
+  if (tryAcquire(parent->second->async_lock.get(), shared)) return parent->second->async_lock;
   return nullptr;
 }
 
-vector<AsyncLock> ObjectStore::_tryLockDatasets(vector<long> uids) {
+vector<AsyncLock> ObjectStore::_tryLockDatasets(vector<long> uids, bool shared, AsyncLock *busy) {
   vector<AsyncLock> locks;
   for (long uid : uids) {
     auto parent = uidMap<GDALDataset *>.find(uid);
@@ -176,32 +223,32 @@ vector<AsyncLock> ObjectStore::_tryLockDatasets(vector<long> uids) {
     locks.push_back(parent->second->async_lock);
   }
   vector<AsyncLock> locked;
-  int r = 0;
   for (AsyncLock &async_lock : locks) {
-    r = uv_sem_trywait(async_lock.get());
-    if (r == 0) {
+    if (tryAcquire(async_lock.get(), shared)) {
       locked.push_back(async_lock);
     } else {
       // We failed acquiring one of the locks =>
       // free all acquired locks and start a new cycle
-      for (AsyncLock &lock : locked) { uv_sem_post(lock.get()); }
-      uv_cond_broadcast(&master_sleep);
-      break;
+      for (AsyncLock &lock : locked) {
+        release(lock.get(), shared);
+        uv_cond_broadcast(&lock->released);
+      }
+      if (busy != nullptr) *busy = async_lock;
+      return {};
     }
   }
-  if (r == 0) return locks;
-  return {};
+  return locks;
 }
 
 /*
  * Try to acquire several locks avoiding deadlocks without blocking.
  */
-vector<AsyncLock> ObjectStore::tryLockDatasets(vector<long> uids) {
+vector<AsyncLock> ObjectStore::tryLockDatasets(vector<long> uids, bool shared) {
   // There is lots of copying around here but these vectors are never longer than 3 elements
   sortUnique(uids);
   if (uids.size() == 0) return {};
   uv_scoped_mutex lock(&master_lock);
-  return _tryLockDatasets(uids);
+  return _tryLockDatasets(uids, shared);
 }
 
 // The basic unit of the ObjectStore is the ObjectStoreItem<GDALPTR>
@@ -248,11 +295,22 @@ long ObjectStore::add(OGRLayer *ptr, Nan::Persistent<Object> &obj, long parent_u
 
 // Creating a Dataset object is a special case
 // It contains a lock (unless it is a dependant Dataset)
-long ObjectStore::add(GDALDataset *ptr, Nan::Persistent<Object> &obj, long parent_uid) {
+// Thread-safe Datasets and Datasets with a pool of handles can be locked by multiple readers
+long ObjectStore::add(GDALDataset *ptr, Nan::Persistent<Object> &obj, long parent_uid, const vector<GDALDataset *> &pool) {
   long uid = ObjectStore::add<GDALDataset *>(ptr, obj, parent_uid);
   if (parent_uid == 0) {
-    uidMap<GDALDataset *>[uid] -> async_lock = shared_ptr<uv_sem_t>(new uv_sem_t(), uv_sem_deleter());
-    uv_sem_init(uidMap<GDALDataset *>[uid] -> async_lock.get(), 1);
+    unsigned max_readers = 1;
+#if GDAL_VERSION_MAJOR > 3 || (GDAL_VERSION_MAJOR == 3 && GDAL_VERSION_MINOR >= 10)
+    if (ptr->IsThreadSafe(GDAL_OF_RASTER)) max_readers = maxConcurrentReaders;
+#endif
+    if (pool.size() > 0) max_readers = pool.size() + 1;
+    AsyncLock async_lock = make_shared<AsyncLockState>(max_readers);
+    if (pool.size() > 0) {
+      async_lock->primary = ptr;
+      async_lock->pool = pool;
+      async_lock->pool.push_back(ptr);
+    }
+    uidMap<GDALDataset *>[uid] -> async_lock = async_lock;
   } else {
     uidMap<GDALDataset *>[uid] -> async_lock = uidMap<GDALDataset *>[parent_uid] -> async_lock;
   }
@@ -313,8 +371,13 @@ const char warningGCBug[] =
   "Sleeping on semaphore in garbage collector, this is a bug in gdal-async, event loop blocked for ";
 const char warningManualClose[] =
   "Closing a dataset while background async operations are still running, event loop blocked for ";
-static inline void uv_sem_wait_with_warning(uv_sem_t *sem, const char *warning) {
-  if (uv_sem_trywait(sem) != 0) { MEASURE_EXECUTION_TIME(warning, uv_sem_wait(sem)); }
+// Acquire an exclusive lock, sleeping if needed (called with the master lock held)
+static inline void lock_wait_with_warning(AsyncLockState *lock, const char *warning) {
+  unsigned acquired = 0;
+  while (acquired < lock->max_readers && uv_sem_trywait(&lock->sem) == 0) acquired++;
+  if (acquired < lock->max_readers) {
+    MEASURE_EXECUTION_TIME(warning, for (; acquired < lock->max_readers; acquired++) uv_sem_wait(&lock->sem));
+  }
 }
 
 // dispose is called by the C++ destructor which is called by Nan::ObjectWrap
@@ -324,14 +387,15 @@ static inline void uv_sem_wait_with_warning(uv_sem_t *sem, const char *warning)
 
 // Disposing a Dataset is a special case - it has children (called with the master lock held)
 template <> void ObjectStore::dispose(shared_ptr<ObjectStoreItem<GDALDataset *>> item, bool manual) {
-  uv_sem_wait_with_warning(
+  lock_wait_with_warning(
     item->async_lock.get(), manual ? (eventLoopWarn ? warningManualClose : nullptr) : warningGCBug);
   uidMap<GDALDataset *>.erase(item->uid);
   ptrMap<GDALDataset *>.erase(item->ptr);
   if (item->parent != nullptr) item->parent->children.remove(item->uid);
 
-  uv_sem_post(item->async_lock.get());
-  uv_cond_broadcast(&master_sleep);
+  release(item->async_lock.get(), false);
+  uv_cond_broadcast(&item->async_lock->released);
+  notifyRelease();
   // Beyond this point the Dataset is not alive anymore ->
   // anyone who was waiting for this semaphore should fail
 
@@ -341,6 +405,14 @@ template <> void ObjectStore::dispose(shared_ptr<ObjectStoreItem<GDALDataset *>>
   // When this happens, they will skip this in do_dispose
   while (!item->children.empty()) { do_dispose(item->children.back()); }
 
+  if (item->parent == nullptr && item->async_lock->primary != nullptr) {
+    // The lock is not held anymore, all the pooled handles are back in the pool
+    for (GDALDataset *handle : item->async_lock->pool)
+      if (handle != item->async_lock->primary) GDALClose(handle);
+    item->async_lock->pool.clear();
+    item->async_lock->primary = nullptr;
+  }
+
   if (item->ptr) {
     LOG("Closing GDALDataset %ld [%p]", item->uid, item->ptr);
     GDALClose(item->ptr);
@@ -362,11 +434,12 @@ template <> void ObjectStore::dispose(shared_ptr<ObjectStoreItem<OGRLayer *>> it
   if (item->is_result_set) {
     LOG("Closing OGRLayer with SQL results [%ld] [%p]", uid, item->ptr);
     if (item->parent) {
-      uv_sem_wait_with_warning(item->parent->async_lock.get(), warningSQL);
+      lock_wait_with_warning(item->parent->async_lock.get(), warningSQL);
       GDALDataset *parent_ds = item->parent->ptr;
       parent_ds->ReleaseResultSet(item->ptr);
-      uv_sem_post(item->parent->async_lock.get());
-      uv_cond_broadcast(&object_store.master_sleep);
+      release(item->parent->async_lock.get(), false);
+      uv_cond_broadcast(&item->parent->async_lock->released);
+      notifyRelease();
     }
   }
 }
@@ -16,13 +16,41 @@
 
 #include <list>
 #include <map>
+#include <unordered_map>
 
 using namespace v8;
 using namespace std;
 
 namespace node_gdal {
 
-typedef shared_ptr<uv_sem_t> AsyncLock;
+// The async lock of a Dataset
+// It is a semaphore with one token per concurrent reader:
+// * an exclusive lock holds all the tokens
+// * a shared lock holds only one token
+// Datasets that cannot be read from multiple threads have only one token
+//
+// A Dataset opened with a pool of handles has one token per handle,
+// a read-only job takes a free handle from the pool
+struct AsyncLockState {
+  uv_sem_t sem;
+  const unsigned max_readers;
+  // Signaled (with the master lock held) when tokens are released
+  // or when the Dataset is destroyed, only the waiters of this Dataset wake up
+  uv_cond_t released;
+  // The primary handle is the one visible from JS, it is also in the pool
+  GDALDataset *primary;
+  vector<GDALDataset *> pool;
+  uv_mutex_t pool_lock;
+  AsyncLockState(unsigned max_readers);
+  ~AsyncLockState();
+  GDALDataset *checkout();
+  void checkin(GDALDataset *handle);
+};
+
+typedef shared_ptr<AsyncLockState> AsyncLock;
+
+// The maximum number of parallel readers on a Dataset that supports them
+static const unsigned maxConcurrentReaders = 64;
 
 template <typename GDALPTR> struct ObjectStoreItem {
   long uid;
@@ -51,37 +79,36 @@ template <> struct ObjectStoreItem<GDALDataset *> {
   ObjectStoreItem(Nan::Persistent<Object> &obj);
 };
 
-struct uv_sem_deleter {
-  void operator()(uv_sem_t *p);
-};
-
 class ObjectStore {
     public:
   template <typename GDALPTR> long add(GDALPTR ptr, Nan::Persistent<Object> &obj, long parent_uid);
   long add(OGRLayer *ptr, Nan::Persistent<Object> &obj, long parent_uid, bool is_result_set);
-  long add(GDALDataset *ptr, Nan::Persistent<Object> &obj, long parent_uid);
+  long add(GDALDataset *ptr, Nan::Persistent<Object> &obj, long parent_uid, const vector<GDALDataset *> &pool = {});
 
   void dispose(long uid, bool manual = false);
   bool isAlive(long uid);
-  inline void lockDataset(AsyncLock lock) {
-    uv_sem_wait(lock.get());
-  }
-  inline void unlockDataset(AsyncLock lock) {
-    uv_sem_post(lock.get());
+  inline void unlockDataset(const AsyncLock &lock, bool shared = false) {
+    release(lock.get(), shared);
     uv_mutex_lock(&master_lock);
-    uv_cond_broadcast(&master_sleep);
+    uv_cond_broadcast(&lock->released);
     uv_mutex_unlock(&master_lock);
+    notifyRelease();
   }
-  inline void unlockDatasets(vector<AsyncLock> locks) {
-    for (const AsyncLock &l : locks) uv_sem_post(l.get());
+  inline void unlockDatasets(const vector<AsyncLock> &locks, bool shared = false) {
+    for (const AsyncLock &l : locks) release(l.get(), shared);
     uv_mutex_lock(&master_lock);
-    uv_cond_broadcast(&master_sleep);
+    for (const AsyncLock &l : locks) uv_cond_broadcast(&l->released);
     uv_mutex_unlock(&master_lock);
+    notifyRelease();
   }
-  AsyncLock lockDataset(long uid);
-  vector<AsyncLock> lockDatasets(vector<long> uids);
-  AsyncLock tryLockDataset(long uid);
-  vector<AsyncLock> tryLockDatasets(vector<long> uids);
+  // The async scheduler is woken up every time a Dataset is unlocked or destroyed
+  inline void onRelease(uv_async_t *notify) {
+    release_notify = notify;
+  }
+  AsyncLock lockDataset(long uid, bool shared = false);
+  vector<AsyncLock> lockDatasets(vector<long> uids, bool shared = false);
+  AsyncLock tryLockDataset(long uid, bool shared = false);
+  vector<AsyncLock> tryLockDatasets(vector<long> uids, bool shared = false);
 
   template <typename GDALPTR> bool has(GDALPTR ptr);
   template <typename GDALPTR> Local<Object> get(GDALPTR ptr);
@@ -95,8 +122,13 @@ class ObjectStore {
     private:
   long uid;
   uv_mutex_t master_lock;
-  uv_cond_t master_sleep;
-  vector<AsyncLock> _tryLockDatasets(vector<long> uids);
+  uv_async_t *release_notify;
+  inline void notifyRelease() {
+    if (release_notify != nullptr) uv_async_send(release_notify);
+  }
+  vector<AsyncLock> _tryLockDatasets(vector<long> uids, bool shared, AsyncLock *busy = nullptr);
+  static bool tryAcquire(AsyncLockState *lock, bool shared);
+  static void release(AsyncLockState *lock, bool shared);
   template <typename GDALPTR> void dispose(shared_ptr<ObjectStoreItem<GDALPTR>> item, bool manual);
   void do_dispose(long uid, bool manual = false);
 };
@@ -0,0 +1,236 @@
+#include "raster_summary.hpp"
+#include "helper_threads.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace node_gdal {
+
+// Each strip is small enough to stay in the CPU cache while being accumulated
+static const int summaryChunkPixels = 1 << 16;
+
+// The partial results of one strip or of the whole band
+struct SummaryPartial {
+  uint64_t count, nodata_count;
+  double min, max, mean, m2;
+  std::vector<uint64_t> histogram;
+
+  void reset(size_t bins) {
+    count = nodata_count = 0;
+    min = std::numeric_limits<double>::infinity();
+    max = -std::numeric_limits<double>::infinity();
+    mean = m2 = 0;
+    histogram.assign(bins, 0);
+  }
+
+  // Chan's parallel algorithm for the variance
+  void merge(const SummaryPartial &other) {
+    nodata_count += other.nodata_count;
+    for (size_t i = 0; i < histogram.size() && i < other.histogram.size(); i++) histogram[i] += other.histogram[i];
+    if (other.count == 0) return;
+    uint64_t n = count + other.count;
+    double delta = other.mean - mean;
+    mean += delta * other.count / n;
+    m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / n);
+    count = n;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+  }
+};
+
+struct SummaryRange {
+  bool histogram;
+  double min, scale;
+  int bins;
+  bool has_nodata;
+  double nodata;
+};
+
+static inline bool isValid(double v, const SummaryRange &range) {
+  return !std::isnan(v) && !(range.has_nodata && v == range.nodata);
+}
+
+// Runs in a helper thread
+static void accumulate(const double *data, size_t n, const SummaryRange &range, SummaryPartial &r) {
+  uint64_t count = 0;
+  double sum = 0;
+  double min = r.min, max = r.max;
+  uint64_t *hist = r.histogram.data();
+  for (size_t i = 0; i < n; i++) {
+    double v = data[i];
+    if (!isValid(v, range)) continue;
+    count++;
+    sum += v;
+    min = v < min ? v : min;
+    max = v > max ? v : max;
+    if (range.histogram) {
+      double b = (v - range.min) * range.scale;
+      if (b >= 0 && b < range.bins)
+        hist[static_cast<size_t>(b)]++;
+      else if (b == range.bins)
+        // the upper bound belongs to the last bin
+        hist[range.bins - 1]++;
+    }
+  }
+  r.nodata_count = n - count;
+  if (count == 0) return;
+
+  double mean = sum / count;
+  double m2 = 0;
+  for (size_t i = 0; i < n; i++) {
+    double v = data[i];
+    if (isValid(v, range)) m2 += (v - mean) * (v - mean);
+  }
+  r.count = count;
+  r.min = min;
+  r.max = max;
+  r.mean = mean;
+  r.m2 = m2;
+}
+
+static SummaryPartial summaryPass(
+  GDALRasterBand *band,
+  const SummaryRange &range,
+  int threads,
+  const std::function<bool(double)> &progress,
+  double progress_start,
+  double progress_end) {
+  int w = band->GetXSize();
+  int h = band->GetYSize();
+  int block_w, block_h;
+  band->GetBlockSize(&block_w, &block_h);
+  // Whole lines, aligned on the blocks when possible
+  int rows = std::max(1, summaryChunkPixels / w);
+  if (rows > block_h) rows -= rows % block_h;
+  rows = std::min(rows, h);
+  int strips = (h + rows - 1) / rows;
+  size_t n = static_cast<size_t>(w) * rows;
+  size_t bins = range.histogram ? range.bins : 0;
+
+  // Two sets of buffers, one is being read while the other one is being accumulated
+  // (the workers are declared last as they must be joined before the buffers are freed)
+  std::vector<std::vector<double>> buffers;
+  std::vector<SummaryPartial> partials;
+  HelperThreads workers(threads);
+  int slots = std::max(1, workers.size());
+  buffers.assign(2 * slots, std::vector<double>(n));
+  partials.resize(2 * slots);
+  SummaryPartial total;
+  total.reset(bins);
+
+  int set = 0, prev_set = 1, pending = 0, done = 0;
+  auto collect = [&]() {
+    workers.wait();
+    for (int k = 0; k < pending; k++) total.merge(partials[prev_set * slots + k]);
+    done += pending;
+    pending = 0;
+    if (progress && !progress(progress_start + (progress_end - progress_start) * done / strips))
+      throw "Operation aborted";
+  };
+
+  for (int first = 0; first < strips; first += slots) {
+    int batch = std::min(slots, strips - first);
+    for (int k = 0; k < batch; k++) {
+      int y = (first + k) * rows;
+      int r = std::min(rows, h - y);
+      CPLErrorReset();
+      CPLErr err =
+        band->RasterIO(GF_Read, 0, y, w, r, buffers[set * slots + k].data(), w, r, GDT_Float64, 0, 0, nullptr);
+      if (err != CE_None) throw CPLGetLastErrorMsg();
+    }
+
+    // The previous batch must be finished before its buffers can be read into
+    collect();
+
+    for (int k = 0; k < batch; k++) {
+      int slot = set * slots + k;
+      size_t len = static_cast<size_t>(w) * std::min(rows, h - (first + k) * rows);
+      partials[slot].reset(bins);
+      const double *data = buffers[slot].data();
+      SummaryPartial *partial = &partials[slot];
+      workers.submit([data, len, &range, partial]() { accumulate(data, len, range, *partial); });
+    }
+    pending = batch;
+    prev_set = set;
+    set ^= 1;
+  }
+  collect();
+
+  return total;
+}
+
+// Nearest rank, interpolated within the bin unless the bin holds a single integer value
+static double percentile(const SummaryPartial &total, const RasterSummary &s, double p, bool exact) {
+  uint64_t n = 0;
+  for (uint64_t c : total.histogram) n += c;
+  if (n == 0) return NAN;
+
+  double width = (s.hist_max - s.hist_min) / total.histogram.size();
+  double rank = std::max(1.0, std::min(static_cast<double>(n), std::ceil(p / 100.0 * n)));
+  uint64_t cum = 0;
+  for (size_t i = 0; i < total.histogram.size(); i++) {
+    uint64_t c = total.histogram[i];
+    if (c > 0 && cum + c >= rank) {
+      double lo = s.hist_min + i * width;
+      double v = exact ? lo + width / 2 : lo + (rank - cum) / c * width;
+      return std::max(s.min, std::min(s.max, v));
+    }
+    cum += c;
+  }
+  return s.max;
+}
+
+RasterSummary
+computeRasterSummary(GDALRasterBand *band, const RasterSummaryOptions &opts, const std::function<bool(double)> &progress) {
+  if (opts.bins < 1) throw "bins must be positive";
+  GDALDataType type = band->GetRasterDataType();
+  if (GDALDataTypeIsComplex(type)) throw "Complex data types are not supported";
+  int has_nodata = 0;
+  double nodata = band->GetNoDataValue(&has_nodata);
+  int threads = std::max(1, std::min(opts.threads, static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))));
+
+  SummaryRange range = {false, 0, 0, 0, has_nodata != 0, nodata};
+  double hist_min, hist_max;
+  bool two_pass = false;
+  if (opts.has_range) {
+    if (!(opts.max > opts.min)) throw "Invalid histogram range";
+    hist_min = opts.min;
+    hist_max = opts.max;
+  } else if (type == GDT_Byte || type == GDT_Int16 || type == GDT_UInt16) {
+    // One bin per value with the default number of bins for Byte
+    hist_min = (type == GDT_Int16 ? -32768 : 0) - 0.5;
+    hist_max = (type == GDT_Byte ? 255 : type == GDT_Int16 ? 32767 : 65535) + 0.5;
+  } else {
+    two_pass = true;
+    SummaryPartial first = summaryPass(band, range, threads, progress, 0, 0.5);
+    hist_min = first.count > 0 ? first.min : 0;
+    hist_max = first.count > 0 ? first.max : 0;
+  }
+
+  range.histogram = true;
+  range.min = hist_min;
+  range.bins = opts.bins;
+  range.scale = hist_max > hist_min ? opts.bins / (hist_max - hist_min) : 0;
+  SummaryPartial total = summaryPass(band, range, threads, progress, two_pass ? 0.5 : 0, 1);
+
+  RasterSummary s;
+  s.count = total.count;
+  s.nodata_count = total.nodata_count;
+  s.min = total.count > 0 ? total.min : NAN;
+  s.max = total.count > 0 ? total.max : NAN;
+  s.mean = total.count > 0 ? total.mean : NAN;
+  s.std_dev = total.count > 0 ? std::sqrt(total.m2 / total.count) : NAN;
+  s.hist_min = hist_min;
+  s.hist_max = hist_max > hist_min ? hist_max : hist_min + 1;
+  s.histogram.assign(total.histogram.begin(), total.histogram.end());
+
+  bool exact = GDALDataTypeIsInteger(type) && std::fabs((s.hist_max - s.hist_min) / opts.bins - 1) < 1e-9 &&
+    std::fabs(s.hist_min - std::floor(s.hist_min) - 0.5) < 1e-9;
+  for (double p : opts.percentiles) s.percentiles.push_back(percentile(total, s, p, exact));
+
+  return s;
+}
+
+} // namespace node_gdal
@@ -0,0 +1,51 @@
+#ifndef __RASTER_SUMMARY_H__
+#define __RASTER_SUMMARY_H__
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// gdal
+#include <gdal_priv.h>
+
+namespace node_gdal {
+
+// A block-parallel statistics engine
+//
+// The band is read in strips of whole lines aligned on its blocks,
+// the strips are read by the calling thread (GDAL handles are not thread-safe)
+// while the previous ones are being accumulated by helper threads, at most one
+// helper thread per core is running at any time in the whole process
+//
+// The statistics, the valid pixel count and the histogram are computed in
+// a single pass when the range of the histogram is known in advance - either
+// given by the caller or implied by the data type (8 and 16-bit integers),
+// otherwise a first pass computes the range
+//
+// The percentiles are derived from the histogram, they are exact for integer
+// data with one bin per value and interpolated within the bins otherwise
+
+struct RasterSummaryOptions {
+  int bins;
+  bool has_range;
+  double min, max;
+  std::vector<double> percentiles;
+  int threads;
+};
+
+struct RasterSummary {
+  uint64_t count, nodata_count;
+  double min, max, mean, std_dev;
+  double hist_min, hist_max;
+  std::vector<double> histogram;
+  std::vector<double> percentiles;
+};
+
+// Throws const char * on error, progress is called on the calling thread
+// and the computation is aborted when it returns false
+RasterSummary
+computeRasterSummary(GDALRasterBand *band, const RasterSummaryOptions &opts, const std::function<bool(double)> &progress);
+
+} // namespace node_gdal
+
+#endif
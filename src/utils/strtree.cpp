@@ -0,0 +1,137 @@
+#include "strtree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+namespace node_gdal {
+
+// Sort-Tile-Recursive: the entries are sorted by x, cut into vertical slices
+// of about sqrt(number of nodes) nodes and each slice is sorted by y
+template <typename GetEnvelope> static void strSort(std::vector<size_t> &order, size_t node_size, GetEnvelope env) {
+  size_t n = order.size();
+  if (n <= node_size) return;
+  std::sort(order.begin(), order.end(), [&env](size_t a, size_t b) {
+    return env(a).MinX + env(a).MaxX < env(b).MinX + env(b).MaxX;
+  });
+  size_t parents = (n + node_size - 1) / node_size;
+  size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(parents))));
+  size_t per_slice = ((parents + slices - 1) / slices) * node_size;
+  for (size_t first = 0; first < n; first += per_slice) {
+    size_t last = std::min(n, first + per_slice);
+    std::sort(order.begin() + first, order.begin() + last, [&env](size_t a, size_t b) {
+      return env(a).MinY + env(a).MaxY < env(b).MinY + env(b).MaxY;
+    });
+  }
+}
+
+STRtree::STRtree(const std::vector<OGREnvelope> &envelopes, const std::vector<double> &item_ids, int node_size)
+  : nodes(), ids(), count(envelopes.size()) {
+  size_t fanout = static_cast<size_t>(std::max(2, node_size));
+
+  std::vector<size_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  strSort(order, fanout, [&envelopes](size_t i) -> const OGREnvelope & { return envelopes[i]; });
+  nodes.reserve(count + count / (fanout - 1) + 1);
+  ids.reserve(count);
+  for (size_t i : order) {
+    nodes.push_back({envelopes[i], 0, 0});
+    ids.push_back(item_ids[i]);
+  }
+
+  // Each level is built from the previous one until only the root remains
+  size_t begin = 0, end = nodes.size();
+  while (end - begin > 1) {
+    std::vector<Node> parents;
+    for (size_t first = begin; first < end; first += fanout) {
+      size_t last = std::min(end, first + fanout);
+      Node parent = {nodes[first].envelope, first, last};
+      for (size_t i = first + 1; i < last; i++) parent.envelope.Merge(nodes[i].envelope);
+      parents.push_back(parent);
+    }
+    order.resize(parents.size());
+    std::iota(order.begin(), order.end(), 0);
+    strSort(order, fanout, [&parents](size_t i) -> const OGREnvelope & { return parents[i].envelope; });
+    for (size_t i : order) nodes.push_back(parents[i]);
+    begin = end;
+    end = nodes.size();
+  }
+}
+
+size_t STRtree::size() const {
+  return count;
+}
+
+OGREnvelope STRtree::bounds() const {
+  if (nodes.empty()) return OGREnvelope();
+  return nodes.back().envelope;
+}
+
+void STRtree::search(const OGREnvelope &query, std::vector<double> &result) const {
+  if (nodes.empty()) return;
+  std::vector<size_t> stack = {nodes.size() - 1};
+  while (!stack.empty()) {
+    size_t node = stack.back();
+    stack.pop_back();
+    if (!nodes[node].envelope.Intersects(query)) continue;
+    if (isItem(node))
+      result.push_back(ids[node]);
+    else
+      for (size_t c = nodes[node].first; c < nodes[node].last; c++) stack.push_back(c);
+  }
+}
+
+static double squaredDistance(const OGREnvelope &envelope, double x, double y) {
+  double dx = std::max(std::max(envelope.MinX - x, 0.0), x - envelope.MaxX);
+  double dy = std::max(std::max(envelope.MinY - y, 0.0), y - envelope.MaxY);
+  return dx * dx + dy * dy;
+}
+
+// Best-first search, the distance to a node is never greater than the distance to its children
+void STRtree::nearest(double x, double y, size_t k, std::vector<double> &result, std::vector<double> &distances)
+  const {
+  if (nodes.empty()) return;
+  typedef std::pair<double, size_t> Candidate;
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+  queue.push({squaredDistance(nodes.back().envelope, x, y), nodes.size() - 1});
+  while (!queue.empty() && result.size() < k) {
+    Candidate next = queue.top();
+    queue.pop();
+    const Node &node = nodes[next.second];
+    if (isItem(next.second)) {
+      result.push_back(ids[next.second]);
+      distances.push_back(std::sqrt(next.first));
+    } else {
+      for (size_t c = node.first; c < node.last; c++) queue.push({squaredDistance(nodes[c].envelope, x, y), c});
+    }
+  }
+}
+
+static double area(const OGREnvelope &envelope) {
+  return (envelope.MaxX - envelope.MinX) * (envelope.MaxY - envelope.MinY);
+}
+
+// Both trees are traversed together, the larger node is expanded first
+void STRtree::join(const STRtree &other, std::vector<double> &left, std::vector<double> &right) const {
+  if (nodes.empty() || other.nodes.empty()) return;
+  std::vector<std::pair<size_t, size_t>> stack = {{nodes.size() - 1, other.nodes.size() - 1}};
+  while (!stack.empty()) {
+    size_t a = stack.back().first, b = stack.back().second;
+    stack.pop_back();
+    const Node &na = nodes[a], &nb = other.nodes[b];
+    if (!na.envelope.Intersects(nb.envelope)) continue;
+    bool item_a = isItem(a), item_b = other.isItem(b);
+    if (item_a && item_b) {
+      left.push_back(ids[a]);
+      right.push_back(other.ids[b]);
+    } else if (item_b || (!item_a && area(na.envelope) >= area(nb.envelope))) {
+      for (size_t c = na.first; c < na.last; c++) stack.push_back({c, b});
+    } else {
+      for (size_t c = nb.first; c < nb.last; c++) stack.push_back({a, c});
+    }
+  }
+}
+
+} // namespace node_gdal
@@ -0,0 +1,55 @@
+#ifndef __NODE_GDAL_STRTREE_H__
+#define __NODE_GDAL_STRTREE_H__
+
+#include <cstddef>
+#include <vector>
+
+// ogr
+#include <ogr_core.h>
+
+namespace node_gdal {
+
+// A static R-tree bulk-loaded with the Sort-Tile-Recursive algorithm
+//
+// All the nodes are packed level by level in a single array, the items
+// first, then their parents and so on up to the root which is the last
+// element - the same layout as flatbush
+//
+// The tree cannot be modified once built, the queries do not need
+// any locking and can run concurrently from any number of threads
+//
+// The items are identified by a double so that they can carry either an
+// index in an array or an OGR FID, the results are in no particular order
+class STRtree {
+    public:
+  STRtree(const std::vector<OGREnvelope> &envelopes, const std::vector<double> &ids, int node_size);
+
+  size_t size() const;
+  OGREnvelope bounds() const;
+
+  // The items whose envelopes intersect the query
+  void search(const OGREnvelope &query, std::vector<double> &result) const;
+  // The k items nearest to (x, y) by the distance to their envelopes, closest first
+  void nearest(double x, double y, size_t k, std::vector<double> &result, std::vector<double> &distances) const;
+  // The pairs of items of the two trees whose envelopes intersect
+  void join(const STRtree &other, std::vector<double> &left, std::vector<double> &right) const;
+
+    private:
+  struct Node {
+    OGREnvelope envelope;
+    // The children of the internal nodes, unused for the items
+    size_t first, last;
+  };
+
+  std::vector<Node> nodes;
+  std::vector<double> ids;
+  size_t count;
+
+  inline bool isItem(size_t node) const {
+    return node < count;
+  }
+};
+
+} // namespace node_gdal
+
+#endif
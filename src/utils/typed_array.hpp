@@ -1,6 +1,9 @@
 #ifndef __NODE_TYPEDARRAY_H__
 #define __NODE_TYPEDARRAY_H__
 
+#include <cstring>
+#include <vector>
+
 // node
 #include <node.h>
 #include <node_object_wrap.h>
@@ -50,6 +53,17 @@ Local<Value> New(GDALDataType type, void *data, unsigned int length);
 GDALDataType Identify(Local<Object> array);
 void *Validate(Local<Object> obj, GDALDataType type, int min_length);
 bool ValidateLength(int length, int min_length);
+
+// Copies the result of a job into a new TypedArray, throws a const char * if it cannot be created
+template <typename T> Local<Value> Copy(GDALDataType type, const std::vector<T> &src) {
+  Local<Value> array = New(type, src.size());
+  if (array.IsEmpty() || !array->IsObject()) throw "Failed creating TypedArray";
+  if (src.size() > 0) {
+    Nan::TypedArrayContents<T> contents(array);
+    memcpy(*contents, src.data(), src.size() * sizeof(T));
+  }
+  return array;
+}
 } // namespace TypedArray
 
 } // namespace node_gdal
@@ -514,6 +514,41 @@ describe('gdal', () => {
         /pixel function failed/)
     })
 
+    it('should support concurrent async operations', function () {
+      if (!semver.gte(gdal.version, '3.5.0-git')) this.skip()
+      const sum3 = (sources: gdal.TypedArray[], buffer: gdal.TypedArray) => {
+        for (let i = 0; i < buffer.length; i++) {
+          buffer[i] = sources[0][i] + sources[1][i] + 3
+        }
+      }
+      gdal.addPixelFunc('sum3', gdal.toPixelFunc(sum3))
+
+      const vrt = gdal.wrapVRT({
+        bands: [
+          {
+            sources: [ band1, band2 ],
+            pixelFunc: 'sum3'
+          }
+        ]
+      })
+      const size = band1.ds.rasterSize
+      const input1 = band1.pixels.read(0, 0, size.x, size.y)
+      const input2 = band2.pixels.read(0, 0, size.x, size.y)
+      const rows = 8
+      const height = Math.floor(size.y / rows)
+      // Each Dataset is a different VRT, so the reads run in parallel
+      const q = Array.from({ length: rows }, (_, row) =>
+        gdal.openAsync(vrt)
+          .then((ds) => ds.bands.get(1).pixels.readAsync(0, row * height, size.x, height))
+          .then((result) => {
+            for (let i = 0; i < size.x * height; i += 64) {
+              const src = row * height * size.x + i
+              assert.closeTo(result[i], input1[src] + input2[src] + 3, 1e-6)
+            }
+          }))
+      return assert.isFulfilled(Promise.all(q))
+    })
+
     it('should support being called synchronously', function () {
       if (!semver.gte(gdal.version, '3.5.0-git')) this.skip()
       const sync = (sources: gdal.TypedArray[], buffer: gdal.TypedArray) => {
@@ -1,8 +1,15 @@
 import * as gdal from 'gdal-async'
-import { assert } from 'chai'
+import * as chai from 'chai'
+import * as chaiAsPromised from 'chai-as-promised'
 import * as path from 'path'
 import * as fs from 'fs'
 import * as cp from 'child_process'
+import * as semver from 'semver'
+import * as dc from 'diagnostics_channel'
+import * as async_hooks from 'async_hooks'
+import { PerformanceObserver } from 'perf_hooks'
+const assert = chai.assert
+chai.use(chaiAsPromised)
 
 if (process.env.GDAL_DATA !== undefined) {
   throw new Error(
@@ -149,6 +156,223 @@ describe('gdal', () => {
     }, /sync progress callback exception/)
   })
 
+  describe('progress throttling', () => {
+    const setThrottle = (interval: number, delta: number) => {
+      // eslint-disable-next-line @typescript-eslint/no-explicit-any
+      const g = gdal as any
+      g.progressInterval = interval
+      g.progressDelta = delta
+    }
+    const countCalls = () => {
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const tmpFile = `/vsimem/${String(Math.random()).substring(2)}.tif`
+      let calls = 0
+      let last = 0
+      gdal.warp(tmpFile, null, [ ds ], [ '-t_srs', 'epsg:3857' ], { progress_cb: (complete) => {
+        calls++
+        last = complete
+      } }).close()
+      gdal.vsimem.release(tmpFile)
+      return { calls, last }
+    }
+    afterEach(() => setThrottle(100, 0.01))
+    it('should have default values', () => {
+      assert.equal(gdal.progressInterval, 100)
+      assert.equal(gdal.progressDelta, 0.01)
+    })
+    it('should coalesce the progress notifications', () => {
+      setThrottle(0, 0)
+      const all = countCalls()
+      setThrottle(1e6, 0.5)
+      const throttled = countCalls()
+      assert.isAbove(throttled.calls, 0)
+      assert.isAtMost(throttled.calls, 2)
+      assert.isAtLeast(all.calls, throttled.calls)
+      assert.equal(throttled.last, all.last)
+    })
+    it('should deliver the latest progress before an async operation completes', async () => {
+      setThrottle(0, 0)
+      const all = countCalls()
+      setThrottle(1e6, 0.99)
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const tmpFile = `/vsimem/${String(Math.random()).substring(2)}.tif`
+      let last = 0
+      const out = await gdal.warpAsync(tmpFile, null, [ ds ], [ '-t_srs', 'epsg:3857' ], { progress_cb: (complete) => {
+        last = complete
+      } })
+      out.close()
+      gdal.vsimem.release(tmpFile)
+      assert.equal(last, all.last)
+    })
+    it('should reject invalid values', () => {
+      assert.throws(() => setThrottle(-1, 0.01), /positive number/)
+      assert.throws(() => setThrottle(100, NaN), /positive number/)
+    })
+  })
+
+  describe('thread pool', () => {
+    it('should report the number of threads of each lane', () => {
+      assert.isAtLeast(gdal.ioThreads, 1)
+      assert.isAtLeast(gdal.cpuThreads, 1)
+    })
+    it('should run CPU-bound and I/O-bound operations in parallel', () => {
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const band = ds.bands.get(1)
+      const ring = new gdal.LinearRing()
+      ring.points.add([ { x: 0, y: 0 }, { x: 0, y: 10 }, { x: 10, y: 10 }, { x: 10, y: 0 }, { x: 0, y: 0 } ])
+      const polygon = new gdal.Polygon()
+      polygon.rings.add(ring)
+      return assert.isFulfilled(Promise.all([
+        polygon.bufferAsync(1, 64),
+        band.pixels.readAsync(0, 0, 16, 16),
+        band.computeStatisticsAsync(false)
+      ]))
+    })
+    it('should not allow resizing after the first async operation', () => {
+      return gdal.openAsync(`${__dirname}/data/sample.tif`).then(() => {
+        assert.throws(() => {
+          // eslint-disable-next-line @typescript-eslint/no-explicit-any
+          (gdal as any).ioThreads = 8
+        }, /cannot be changed/)
+        assert.throws(() => {
+          // eslint-disable-next-line @typescript-eslint/no-explicit-any
+          (gdal as any).cpuThreads = 8
+        }, /cannot be changed/)
+      })
+    })
+  })
+
+  describe('gdal.metrics()', () => {
+    it('should report the sync and async operations', () => {
+      gdal.metrics(true)
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const band = ds.bands.get(1)
+      band.pixels.read(0, 0, 16, 16)
+      const ops: Promise<unknown>[] = []
+      for (let i = 0; i < 8; i++) ops.push(band.pixels.readAsync(0, 0, 16, 16))
+      return Promise.all(ops).then(() => {
+        const m = gdal.metrics()
+        const read = m.methods['RasterBandPixels.read']
+        assert.isObject(read)
+        assert.equal(read.calls, 9)
+        assert.equal(read.errors, 0)
+        assert.equal(read.execute.count, 9)
+        assert.equal(read.queueWait.count, 8)
+        for (const h of [ read.lockWait, read.queueWait, read.execute, read.rval ]) {
+          assert.isAtLeast(h.max, h.p99)
+          assert.isAtLeast(h.p99, h.p50)
+          assert.isAtLeast(h.p50, 0)
+        }
+        assert.equal(m.bytesRead, 9 * 16 * 16)
+        const uid = (ds as unknown as { _uid: number })._uid
+        assert.include(m.datasets[uid], { inFlight: 0, waiting: 0, jobs: 8 })
+      })
+    })
+    it('should drop the closed Datasets', () => {
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const uid = (ds as unknown as { _uid: number })._uid
+      return ds.bands.get(1).pixels.readAsync(0, 0, 16, 16).then(() => {
+        assert.isObject(gdal.metrics().datasets[uid])
+        ds.close()
+        assert.isUndefined(gdal.metrics().datasets[uid])
+      })
+    })
+    it('should count the errors', () => {
+      gdal.metrics(true)
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      return assert.isRejected(ds.bands.get(1).pixels.readAsync(-1, -1, 16, 16)).then(() => {
+        assert.equal(gdal.metrics().methods['RasterBandPixels.read'].errors, 1)
+      })
+    })
+    it('should reset the counters', () => {
+      gdal.open(`${__dirname}/data/sample.tif`).bands.get(1).pixels.read(0, 0, 4, 4)
+      assert.isAbove(gdal.metrics(true).bytesRead, 0)
+      const m = gdal.metrics()
+      assert.equal(m.bytesRead, 0)
+      assert.isUndefined(m.methods['RasterBandPixels.read'])
+    })
+  })
+
+  describe('diagnostics', () => {
+    type JobMessage = { id: number, method: string, datasets: number[], lockWait?: number, execute?: number,
+      error?: string }
+
+    const listen = (fn: () => Promise<unknown>) => {
+      const events: Record<string, JobMessage[]> = { start: [], lock: [], end: [] }
+      const subscribers = Object.keys(events).map((ev) => {
+        const channel = dc.channel(`gdal:job:${ev}`)
+        const subscriber = (msg: unknown) => events[ev].push(msg as JobMessage)
+        channel.subscribe(subscriber)
+        return () => channel.unsubscribe(subscriber)
+      })
+      const done = () => subscribers.forEach((unsubscribe) => unsubscribe())
+      return fn().then(() => {
+        done()
+        return events
+      }, (e) => {
+        done()
+        throw e
+      })
+    }
+
+    it('should publish the events of the async operations on diagnostics_channel', () => {
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const uid = (ds as unknown as { _uid: number })._uid
+      return listen(() => ds.bands.get(1).pixels.readAsync(0, 0, 16, 16)).then((events) => {
+        for (const ev of [ 'start', 'lock', 'end' ]) {
+          assert.lengthOf(events[ev], 1)
+          assert.equal(events[ev][0].method, 'RasterBandPixels.read')
+          assert.deepEqual(events[ev][0].datasets, [ uid ])
+          assert.equal(events[ev][0].id, events.start[0].id)
+        }
+        assert.isAtLeast(events.lock[0].lockWait as number, 0)
+        assert.isAtLeast(events.end[0].execute as number, 0)
+        assert.isUndefined(events.end[0].error)
+      })
+    })
+    it('should include the error in the end event', () => {
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      return listen(() => ds.bands.get(1).pixels.readAsync(-1, -1, 16, 16).catch(() => undefined)).then((events) => {
+        assert.lengthOf(events.end, 1)
+        assert.isString(events.end[0].error)
+      })
+    })
+    it('should tag the async_hooks resources with the method name and the Datasets', () => {
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const uid = (ds as unknown as { _uid: number })._uid
+      const resources: { type: string, resource: { datasets: number[] } }[] = []
+      const hook = async_hooks.createHook({
+        init(_id, type, _trigger, resource) {
+          if (type.startsWith('node-gdal:')) resources.push({ type, resource: resource as { datasets: number[] } })
+        }
+      }).enable()
+      return ds.bands.get(1).pixels.readAsync(0, 0, 16, 16).then(() => {
+        hook.disable()
+        assert.lengthOf(resources, 1)
+        assert.equal(resources[0].type, 'node-gdal:RasterBandPixels.read')
+        assert.deepEqual(resources[0].resource.datasets, [ uid ])
+      })
+    })
+    if (semver.gte(process.versions.node, '16.0.0')) {
+      it('should emit PerformanceEntries', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`)
+        const entries: string[] = []
+        const observer = new PerformanceObserver((list) => {
+          for (const e of list.getEntries()) entries.push(e.name)
+        })
+        observer.observe({ entryTypes: [ 'measure' ] })
+        gdal.recordPerformanceEntries(true)
+        return ds.bands.get(1).pixels.readAsync(0, 0, 16, 16)
+          .then(() => new Promise((resolve) => setTimeout(resolve, 10)))
+          .then(() => {
+            gdal.recordPerformanceEntries(false)
+            observer.disconnect()
+            assert.include(entries, 'gdal:RasterBandPixels.read')
+          })
+      })
+    }
+  })
+
   describe('fromDataType()', () => {
     it('fromDataType() should return a constructor', () => {
       const ds = gdal.open(
@@ -63,4 +63,89 @@ describe('gdal.CoordinateTransformation', () => {
       }, /point must contain numerical properties x and y/)
     })
   })
+  describe('transformPoints()', () => {
+    let ct: gdal.CoordinateTransformation
+    beforeEach(() => {
+      const srs0 = gdal.SpatialReference.fromProj4('+init=epsg:4326')
+      const srs1 = gdal.SpatialReference.fromProj4('+init=epsg:32632')
+      ct = new gdal.CoordinateTransformation(srs0, srs1)
+    })
+    it('should transform separate arrays in place', () => {
+      const xs = Float64Array.from([ 20, 10 ])
+      const ys = Float64Array.from([ 30, 45 ])
+      const success = ct.transformPoints(xs, ys)
+
+      assert.instanceOf(success, Uint8Array)
+      assert.deepEqual(Array.from(success), [ 1, 1 ])
+      assert.closeTo(xs[0], 1564201.4044502454, 0.1)
+      assert.closeTo(ys[0], 3370263.469590679, 0.1)
+      const pt = ct.transformPoint(10, 45)
+      assert.closeTo(xs[1], pt.x, 1e-6)
+      assert.closeTo(ys[1], pt.y, 1e-6)
+    })
+    it('should transform interleaved coordinates', () => {
+      const xyz = Float64Array.from([ 20, 30, 0, 10, 45, 100 ])
+      ct.transformPoints(xyz, { interleaved: true, stride: 3 })
+
+      assert.closeTo(xyz[0], 1564201.4044502454, 0.1)
+      assert.closeTo(xyz[1], 3370263.469590679, 0.1)
+      const pt = ct.transformPoint(10, 45, 100)
+      assert.closeTo(xyz[3], pt.x, 1e-6)
+      assert.closeTo(xyz[4], pt.y, 1e-6)
+      assert.closeTo(xyz[5], pt.z, 1e-6)
+    })
+    it('should report the points that cannot be transformed', () => {
+      const xy = Float64Array.from([ 20, 30, 400, 120 ])
+      const success = ct.transformPoints(xy, { interleaved: true })
+      assert.deepEqual(Array.from(success), [ 1, 0 ])
+      assert.closeTo(xy[0], 1564201.4044502454, 0.1)
+    })
+    it('should throw on invalid arguments', () => {
+      assert.throws(() => {
+        ct.transformPoints(new Float64Array(2), new Float64Array(3))
+      }, /same length/)
+      assert.throws(() => {
+        ct.transformPoints(new Float64Array(5), { interleaved: true })
+      }, /multiple of stride/)
+      assert.throws(() => {
+        // eslint-disable-next-line @typescript-eslint/no-explicit-any
+        ct.transformPoints([ 20, 30 ] as any, new Float64Array(2))
+      }, /xs must be a Float64Array/)
+    })
+    it('should transform large arrays with several threads', () => {
+      const length = 100000
+      const xs = new Float64Array(length)
+      const ys = new Float64Array(length)
+      for (let i = 0; i < length; i++) {
+        xs[i] = 6 + (i % 600) / 100
+        ys[i] = 30 + Math.floor(i / 600) / 10
+      }
+      const samples = [ 0, 12345, length - 1 ]
+      const expected = samples.map((i) => ct.transformPoint(xs[i], ys[i]))
+      return ct.transformPointsAsync(xs, ys, null, { threads: 4 }).then((success) => {
+        assert.equal(success.length, length)
+        assert.isTrue(success.every((s) => s === 1))
+        samples.forEach((i, n) => {
+          assert.closeTo(xs[i], expected[n].x, 1e-6)
+          assert.closeTo(ys[i], expected[n].y, 1e-6)
+        })
+      })
+    })
+    it('should transform to pixel coordinates', () => {
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const srs = ds.srs
+      const gt = ds.geoTransform
+      if (srs === null || gt === null) throw new TypeError('No georeferencing')
+      const tx = new gdal.CoordinateTransformation(srs, ds)
+      const xy = Float64Array.from([ gt[0], gt[3], gt[0] + gt[1] * 10, gt[3] + gt[5] * 20 ])
+      return tx.transformPointsAsync(xy, { interleaved: true }).then((success) => {
+        assert.deepEqual(Array.from(success), [ 1, 1 ])
+        assert.closeTo(xy[0], 0, 1e-6)
+        assert.closeTo(xy[1], 0, 1e-6)
+        assert.closeTo(xy[2], 10, 1e-6)
+        assert.closeTo(xy[3], 20, 1e-6)
+        ds.close()
+      })
+    })
+  })
 })
@@ -1173,6 +1173,89 @@ describe('gdal.Dataset', () => {
         return assert.isRejected(ds.buildOverviewsAsync('NEAREST', [ 2, 4, 8 ]))
       })
     })
+    describe('read()', () => {
+      it('should read all the bands one after another by default', () => {
+        const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+        const n = ds.bands.count()
+        const data = ds.read(10, 20, 16, 8)
+        assert.instanceOf(data, Uint8Array)
+        assert.equal(data.length, 16 * 8 * n)
+        for (let b = 1; b <= n; b++) {
+          assert.deepEqual(data.subarray((b - 1) * 16 * 8, b * 16 * 8), ds.bands.get(b).pixels.read(10, 20, 16, 8))
+        }
+      })
+      it('should interleave the bands by pixel', () => {
+        const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+        const data = ds.read(10, 20, 16, 8, { bands: [ 3, 1 ], interleave: 'pixel' })
+        const b3 = ds.bands.get(3).pixels.read(10, 20, 16, 8)
+        const b1 = ds.bands.get(1).pixels.read(10, 20, 16, 8)
+        assert.equal(data.length, 16 * 8 * 2)
+        for (let i = 0; i < 16 * 8; i++) {
+          assert.equal(data[i * 2], b3[i])
+          assert.equal(data[i * 2 + 1], b1[i])
+        }
+      })
+      it('should write into the given Buffer', () => {
+        const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+        const n = ds.bands.count()
+        const buffer = Buffer.alloc(16 * 8 * n)
+        const data = ds.read(10, 20, 16, 8, { data: buffer, interleave: 'pixel' })
+        assert.strictEqual(data, buffer)
+        assert.equal(buffer[n], ds.bands.get(1).pixels.get(11, 20))
+      })
+      it('should throw if the array is too small', () => {
+        const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+        assert.throws(() => {
+          ds.read(0, 0, 16, 8, { data: new Uint8Array(16 * 8) })
+        })
+      })
+      it('should throw on an invalid band', () => {
+        const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+        assert.throws(() => {
+          ds.read(0, 0, 16, 8, { bands: [ 0 ] })
+        }, /invalid band/)
+      })
+      it('should throw on a zero or negative spacing', () => {
+        const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+        assert.throws(() => {
+          ds.read(0, 0, 16, 8, { data: new Uint8Array(1), pixel_space: 0, line_space: 0, band_space: 0 })
+        }, /must be positive/)
+        assert.throws(() => {
+          ds.read(0, 0, 16, 8, { line_space: -1 })
+        }, /must be positive/)
+      })
+      it('should throw on an invalid data type', () => {
+        const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+        assert.throws(() => {
+          ds.read(0, 0, 16, 8, { type: 'Float65' })
+        }, /Invalid data type/)
+      })
+      it('should throw on invalid buffer dimensions', () => {
+        const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+        assert.throws(() => {
+          ds.read(0, 0, 16, 8, { buffer_width: 0 })
+        }, /must be positive/)
+        assert.throws(() => {
+          ds.read(0, 0, 16, 8, { buffer_height: -8 })
+        }, /must be positive/)
+      })
+    })
+    describe('readAsync()', () => {
+      it('should read the bands interleaved by pixel', () => {
+        const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+        const n = ds.bands.count()
+        const b2 = ds.bands.get(2).pixels.read(10, 20, 16, 8)
+        return assert.isFulfilled(ds.readAsync(10, 20, 16, 8, { interleave: 'pixel' }).then((data) => {
+          assert.equal(data.length, 16 * 8 * n)
+          for (let i = 0; i < 16 * 8; i++) assert.equal(data[i * n + 1], b2[i])
+        }))
+      })
+      it('should reject if dataset already closed', () => {
+        const ds = gdal.open(`${__dirname}/data/multiband.tif`)
+        ds.close()
+        return assert.isRejected(ds.readAsync(0, 0, 16, 8))
+      })
+    })
   })
   describe('setGCPs()', () => {
     it('should update gcps', () => {
@@ -1266,4 +1349,151 @@ describe('gdal.Dataset', () => {
       }, /already been destroyed/)
     })
   })
+  describe('asynchronous operations', () => {
+    it('should complete the operations on one Dataset in FIFO order', () => {
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const band = ds.bands.get(1)
+      const order: number[] = []
+      const ops: Promise<void>[] = []
+      for (let i = 0; i < 32; i++) {
+        ops.push(band.pixels.readAsync(0, i * 8, 128, 8).then(() => {
+          order.push(i)
+        }))
+      }
+      return Promise.all(ops).then(() => {
+        assert.deepEqual(order, Array.from({ length: 32 }, (_, i) => i))
+      })
+    })
+
+    it('should not starve other Datasets when one Dataset has many waiting operations', () => {
+      const busy = gdal.open(`${__dirname}/data/sample.tif`)
+      const other = gdal.open(`${__dirname}/data/dem_azimuth50_pa.img`)
+      const busyBand = busy.bands.get(1)
+      const size = busy.rasterSize
+      const ops: Promise<unknown>[] = []
+      for (let i = 0; i < 64; i++) ops.push(busyBand.pixels.readAsync(0, 0, size.x, size.y))
+      const read = other.bands.get(1).pixels.readAsync(0, 0, 16, 16)
+      const datasets = gdal.metrics().datasets
+      assert.isAbove(datasets[(busy as unknown as { _uid: number })._uid].waiting, 0)
+      assert.include(datasets[(other as unknown as { _uid: number })._uid], { inFlight: 1, waiting: 0 })
+      return assert.isFulfilled(read.then((data) => {
+        assert.instanceOf(data, Uint8Array)
+        return Promise.all(ops)
+      }))
+    })
+
+    it('should handle operations spanning several Datasets', () => {
+      const ds1 = gdal.open(`${__dirname}/data/sample.tif`)
+      const ds2 = gdal.open('temp', 'w', 'MEM', ds1.rasterSize.x, ds1.rasterSize.y, 1, gdal.GDT_Byte)
+      const srs = ds1.srs as gdal.SpatialReference
+      ds2.srs = srs
+      ds2.geoTransform = ds1.geoTransform
+      const band1 = ds1.bands.get(1)
+      const band2 = ds2.bands.get(1)
+      const ops: Promise<unknown>[] = []
+      for (let i = 0; i < 8; i++) {
+        ops.push(band1.pixels.readAsync(0, 0, 16, 16))
+        ops.push(gdal.reprojectImageAsync({ src: ds1, dst: ds2, s_srs: srs, t_srs: srs }))
+        ops.push(band2.pixels.readAsync(0, 0, 16, 16))
+      }
+      return assert.isFulfilled(Promise.all(ops))
+    })
+
+    it('should reject the waiting operations of a closed Dataset', () => {
+      const ds = gdal.open(`${__dirname}/data/sample.tif`)
+      const band = ds.bands.get(1)
+      const size = ds.rasterSize
+      const errors: Error[] = []
+      const ops: Promise<unknown>[] = []
+      for (let i = 0; i < 8; i++) {
+        ops.push(band.pixels.readAsync(0, 0, size.x, size.y).catch((e) => {
+          errors.push(e)
+        }))
+      }
+      ds.close()
+      return Promise.all(ops).then(() => {
+        // The first one has already started when the Dataset is closed
+        assert.lengthOf(errors, 7)
+        for (const e of errors) assert.match(e.message, /already been destroyed/)
+      })
+    })
+
+    it('should keep the order of read-only and write operations on the same Dataset', () => {
+      const ds = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte)
+      const band = ds.bands.get(1)
+      const results: Promise<number>[] = []
+      for (let i = 1; i <= 8; i++) {
+        band.pixels.setAsync(0, 0, i)
+        results.push(band.pixels.getAsync(0, 0))
+        results.push(band.pixels.getAsync(0, 0))
+      }
+      return assert.eventually.deepEqual(Promise.all(results), [ 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8 ])
+    })
+
+    if (semver.gte(gdal.version, '3.10.0')) {
+      it('should run read-only operations in parallel on a Dataset opened in thread-safe mode', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`, 'rt')
+        const band = ds.bands.get(1)
+        const size = ds.rasterSize
+        const ops: Promise<unknown>[] = []
+        for (let i = 0; i < 16; i++) ops.push(band.pixels.readAsync(0, 0, size.x, size.y))
+        // None of them waits for the others to release the Dataset
+        const uid = (ds as unknown as { _uid: number })._uid
+        assert.include(gdal.metrics().datasets[uid], { inFlight: 16, waiting: 0 })
+        return assert.isFulfilled(Promise.all(ops))
+      })
+    }
+
+    describe('pool of handles', () => {
+      it('should open a Dataset with a pool of handles', () =>
+        assert.isFulfilled(gdal.openAsync(`${__dirname}/data/sample.tif`, 'r', { pool: 4 }).then((ds) => {
+          assert.instanceOf(ds, gdal.Dataset)
+          assert.equal(ds.bands.count(), 1)
+          ds.close()
+        }))
+      )
+      it('should return the same data from all the handles', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`, 'r', { pool: 4 })
+        const band = ds.bands.get(1)
+        const size = ds.rasterSize
+        const expected = band.pixels.read(0, 0, size.x, size.y)
+        const ops: Promise<gdal.TypedArray>[] = []
+        for (let i = 0; i < 16; i++) ops.push(band.pixels.readAsync(0, 0, size.x, size.y))
+        return Promise.all(ops).then((results) => {
+          for (const r of results) assert.deepEqual(r, expected)
+        })
+      })
+      it('should keep the identity of the overviews', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`, 'r', { pool: 2 })
+        const band = ds.bands.get(1)
+        return assert.isFulfilled(Promise.all([ band.overviews.countAsync(), band.pixels.readAsync(0, 0, 16, 16) ]))
+      })
+      it('should reject a pool in update mode', () => {
+        assert.throws(() => {
+          gdal.open(`${__dirname}/data/sample.tif`, 'r+', { pool: 2 })
+        }, /read-only/)
+      })
+      it('should reject an invalid pool size', () => {
+        assert.throws(() => {
+          gdal.open(`${__dirname}/data/sample.tif`, 'r', { pool: 0 })
+        }, /pool must be between/)
+      })
+      it('should reject the waiting operations when the Dataset is closed', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`, 'r', { pool: 2 })
+        const band = ds.bands.get(1)
+        const size = ds.rasterSize
+        const errors: Error[] = []
+        const ops: Promise<unknown>[] = []
+        for (let i = 0; i < 8; i++) {
+          ops.push(band.pixels.readAsync(0, 0, size.x, size.y).catch((e) => {
+            errors.push(e)
+          }))
+        }
+        ds.close()
+        return Promise.all(ops).then(() => {
+          for (const e of errors) assert.match(e.message, /already been destroyed/)
+        })
+      })
+    })
+  })
 })
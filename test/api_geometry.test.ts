@@ -191,7 +191,67 @@ describe('gdal.Geometry', () => {
       ]))
     })
   })
+  describe('toWKBBatch()', () => {
+    it('should encode the geometries in a single buffer', () => {
+      const point = new gdal.Point(1, 2)
+      const line = gdal.Geometry.fromWKT('LINESTRING (0 0, 1 1)')
+      const batch = gdal.Geometry.toWKBBatch([ point, null, line ], 'LSB', 'ISO')
+      assert.instanceOf(batch.values, Buffer)
+      assert.instanceOf(batch.offsets, Int32Array)
+      const wkb = [ point.toWKB('LSB', 'ISO'), line.toWKB('LSB', 'ISO') ]
+      assert.deepEqual(Array.from(batch.offsets),
+        [ 0, wkb[0].length, wkb[0].length, wkb[0].length + wkb[1].length ])
+      assert.isTrue(batch.values.equals(Buffer.concat(wkb)))
+    })
+    it('should throw on invalid geometries', () => {
+      assert.throws(() => {
+        gdal.Geometry.toWKBBatch([ {} ] as gdal.Geometry[])
+      }, /must be an array of Geometry objects/)
+    })
+  })
+  describe('fromWKBBatch()', () => {
+    it('should decode the output of toWKBBatch()', () => {
+      const wkt = [ 'POINT (1 2)', 'LINESTRING (0 0,1 1)', 'POLYGON ((0 0,1 0,1 1,0 0))' ]
+      const batch = gdal.Geometry.toWKBBatch([ ...wkt.map((w) => gdal.Geometry.fromWKT(w)), null ])
+      const geoms = gdal.Geometry.fromWKBBatch(batch.values, batch.offsets)
+      assert.lengthOf(geoms, 4)
+      assert.deepEqual(geoms.slice(0, 3).map((g) => g?.toWKT()), wkt)
+      assert.isNull(geoms[3])
+    })
+    it('should throw on invalid offsets', () => {
+      const batch = gdal.Geometry.toWKBBatch([ new gdal.Point(1, 2) ])
+      assert.throws(() => {
+        gdal.Geometry.fromWKBBatch(batch.values, Int32Array.from([ 0, batch.values.length + 1 ]))
+      }, /offsets/)
+      assert.throws(() => {
+        gdal.Geometry.fromWKBBatch(batch.values, Array.from(batch.offsets) as unknown as Int32Array)
+      }, /Int32Array/)
+    })
+  })
+  describe('fromWKBBatchAsync()', () => {
+    it('should round-trip many geometries', async () => {
+      const points = []
+      for (let i = 0; i < 1000; i++) points.push(new gdal.Point(i, -i))
+      const batch = await gdal.Geometry.toWKBBatchAsync(points)
+      assert.lengthOf(batch.offsets, 1001)
+      const geoms = await gdal.Geometry.fromWKBBatchAsync(batch.values, batch.offsets) as gdal.Point[]
+      assert.lengthOf(geoms, 1000)
+      geoms.forEach((p, i) => assert.deepEqual([ p.x, p.y ], [ i, -i ]))
+    })
+  })
   if (semver.gte(gdal.version, '2.3.0')) {
+    describe('fromGeoJsonBufferBatch()', () => {
+      it('should decode the fragments of a single buffer', () => {
+        const fragments = [ '{"type":"Point","coordinates":[2,1]}', '', '{"type":"Point","coordinates":[3,4]}' ]
+        const values = Buffer.from(fragments.join(''))
+        const offsets = Int32Array.from([ 0, 1, 2, 3 ].map((i) => fragments.slice(0, i).join('').length))
+        const geoms = gdal.Geometry.fromGeoJsonBufferBatch(values, offsets) as (gdal.Point | null)[]
+        assert.deepEqual(geoms.map((p) => p && [ p.x, p.y ]), [ [ 2, 1 ], null, [ 3, 4 ] ])
+      })
+      it('should reject on error', () =>
+        assert.isRejected(gdal.Geometry.fromGeoJsonBufferBatchAsync(Buffer.from('Garga'), Int32Array.from([ 0, 5 ])))
+      )
+    })
     describe('fromGeoJson()', () => {
       it('should return valid result', () => {
         const point2d = gdal.Geometry.fromGeoJson({ type: 'Point', coordinates: [ 2, 1 ] }) as gdal.Point
@@ -1014,5 +1074,53 @@ describe('gdal.Geometry', () => {
       const valid = invalid.makeValidAsync()
       return assert.eventually.instanceOf(valid, gdal.GeometryCollection)
     })
+    describe('prepare()', () => {
+      const fence = gdal.Geometry.fromWKT('POLYGON ((0 0, 10 0, 10 10, 0 10, 0 0))')
+      const candidates = [
+        gdal.Geometry.fromWKT('POINT (5 5)'),
+        gdal.Geometry.fromWKT('POINT (15 5)'),
+        gdal.Geometry.fromWKT('LINESTRING (5 5, 15 5)').toWKB(),
+        gdal.Geometry.fromWKT('POINT (10 5)').toWKB()
+      ]
+      it('should return a PreparedGeometry', () => {
+        assert.instanceOf(fence.prepare(), gdal.PreparedGeometry)
+      })
+      it('should evaluate intersects for all the candidates', () => {
+        const result = fence.prepare().intersectsMany(candidates)
+        assert.instanceOf(result, Uint8Array)
+        assert.deepEqual(Array.from(result), [ 1, 0, 1, 1 ])
+      })
+      it('should evaluate contains for all the candidates', () => {
+        const result = fence.prepare().containsMany(candidates)
+        assert.deepEqual(Array.from(result), [ 1, 0, 0, 0 ])
+      })
+      it('should not be affected by later changes to the geometry', () => {
+        const square = fence.clone()
+        const prepared = square.prepare()
+        square.swapXY()
+        square.empty()
+        assert.deepEqual(Array.from(prepared.containsMany(candidates)), [ 1, 0, 0, 0 ])
+      })
+      it('should throw on invalid candidates', () => {
+        const prepared = fence.prepare()
+        assert.throws(() => {
+          prepared.intersectsMany([ {} ] as gdal.Geometry[])
+        }, /must be an array of Geometry objects or WKB Buffers/)
+        assert.throws(() => {
+          prepared.intersectsMany([ Buffer.from([ 1, 2, 3 ]) ])
+        })
+      })
+    })
+    describe('prepareAsync()', () => {
+      it('should evaluate the predicates in a single job', async () => {
+        const fence = await gdal.Geometry.fromWKT('POLYGON ((0 0, 10 0, 10 10, 0 10, 0 0))').prepareAsync()
+        const candidates = []
+        for (let i = 0; i < 1000; i++) candidates.push(new gdal.Point(i % 20, 5).toWKB())
+        const inside = await fence.containsManyAsync(candidates)
+        const intersecting = await fence.intersectsManyAsync(candidates)
+        assert.equal(inside.reduce((a, x) => a + x, 0), 450)
+        assert.equal(intersecting.reduce((a, x) => a + x, 0), 550)
+      })
+    })
   })
 })
@@ -493,6 +493,76 @@ describe('gdal.Layer', () => {
           })
         })
       })
+      describe('readBatch()', () => {
+        it('should return the features in columns', () => {
+          prepare_dataset_layer_test('r', (dataset, layer) => {
+            const batch = layer.features.readBatch() as gdal.FeatureBatch
+            assert.equal(batch.count, 23)
+            assert.instanceOf(batch.fid, Float64Array)
+            assert.equal(batch.fid.length, 23)
+            assert.sameMembers(Object.keys(batch.fields), layer.fields.getNames())
+
+            const name = batch.fields.name
+            assert.equal(name.type, 'Utf8')
+            assert.instanceOf(name.values, Uint8Array)
+            assert.instanceOf(name.offsets, Int32Array)
+            assert.equal(name.validity.length, 3)
+            const offsets = name.offsets as Int32Array
+            for (let i = 0; i < batch.count; i++) {
+              const feature = layer.features.get(batch.fid[i])
+              assert.equal(Buffer.from(name.values.subarray(offsets[i], offsets[i + 1])).toString(), feature.fields.get('name'))
+            }
+
+            const geometry = batch.geometry as gdal.FeatureBatchColumn
+            assert.equal(geometry.type, 'Binary')
+            const offsetsGeom = geometry.offsets as Int32Array
+            const wkb = Buffer.from(geometry.values.subarray(offsetsGeom[0], offsetsGeom[1]))
+            assert.isTrue(gdal.Geometry.fromWKB(wkb).equals(layer.features.get(batch.fid[0]).getGeometry()))
+          })
+        })
+        it('should continue from the current position and return null at the end', () => {
+          prepare_dataset_layer_test('r', (dataset, layer) => {
+            const fids: number[] = []
+            let batch: gdal.FeatureBatch | null
+            while ((batch = layer.features.readBatch({ batchSize: 10, fields: [ 'name' ], geometry: 'none' }))) {
+              assert.isAtMost(batch.count, 10)
+              assert.deepEqual(Object.keys(batch.fields), [ 'name' ])
+              assert.isUndefined(batch.geometry)
+              fids.push(...batch.fid)
+            }
+            assert.lengthOf(fids, 23)
+            assert.lengthOf(new Set(fids), 23)
+          })
+        })
+        it('should read the Integer64 fields into a BigInt64Array', () => {
+          const ds = gdal.open('batch_int64', 'w', 'Memory')
+          const layer = ds.layers.create('ids', null, gdal.Point)
+          layer.fields.add(new gdal.FieldDefn('id', gdal.OFTInteger64))
+          const feature = new gdal.Feature(layer)
+          feature.fields.set('id', '9007199254740993')
+          layer.features.add(feature)
+          const batch = layer.features.readBatch() as gdal.FeatureBatch
+          assert.equal(batch.fields.id.type, 'Int64')
+          assert.instanceOf(batch.fields.id.values, BigInt64Array)
+          assert.equal(batch.fields.id.values[0], BigInt('9007199254740993'))
+          ds.close()
+        })
+        it('should throw on an invalid field name', () => {
+          prepare_dataset_layer_test('r', (dataset, layer) => {
+            assert.throws(() => {
+              layer.features.readBatch({ fields: [ 'nonexistent' ] })
+            }, /does not exist/)
+          })
+        })
+        it('should throw error if dataset is destroyed', () => {
+          prepare_dataset_layer_test('r', (dataset, layer) => {
+            dataset.close()
+            assert.throws(() => {
+              layer.features.readBatch()
+            }, /already destroyed/)
+          })
+        })
+      })
       describe('first()', () => {
         it('should return a Feature and reset the iterator', () => {
           prepare_dataset_layer_test('r', (dataset, layer) => {
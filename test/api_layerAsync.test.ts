@@ -549,6 +549,32 @@ describe('gdal.LayerAsync', () => {
           })
         )
       })
+      describe('readBatchAsync()', () => {
+        it('should return the features in columns', () =>
+          prepare_dataset_layer_test('r', { autoclose: false }, (dataset, layer, file) => {
+            const expected = layer.features.map((f) => f.fields.get('state_abbr'))
+            // first() consumes the first feature
+            layer.features.first()
+            return assert.isFulfilled(layer.features.readBatchAsync({ fields: [ 'state_abbr' ] }).then((batch) => {
+              if (batch === null) throw new Error('no features')
+              const col = batch.fields.state_abbr
+              const offsets = col.offsets as Int32Array
+                const actual = Array.from({ length: batch.count },
+                (_, i) => Buffer.from(col.values.subarray(offsets[i], offsets[i + 1])).toString())
+              assert.deepEqual(actual, expected.slice(1))
+              return layer.features.readBatchAsync()
+            }).then((batch) => assert.isNull(batch)))
+              .then(() => cleanupWrite(dataset, file))
+          })
+        )
+        it('should throw error if dataset is destroyed', () =>
+          prepare_dataset_layer_test('r', { autoclose: false }, (dataset, layer, file) => {
+            dataset.close()
+            return assert.isRejected(layer.features.readBatchAsync(), /already destroyed/)
+              .then(() => cleanupWrite(dataset, file))
+          })
+        )
+      })
       describe('firstAsync()', () => {
         it('should return a Feature and reset the iterator', () =>
           prepare_dataset_layer_test('r', { autoclose: false }, (dataset, layer, file) => {
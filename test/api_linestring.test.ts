@@ -292,6 +292,47 @@ describe('gdal.LineString', () => {
           assert.equal(points[2].x, 3)
         })
       })
+      describe('toFloat64Array()', () => {
+        it('should return the interleaved coordinates', () => {
+          const line = new gdal.LineString()
+          line.points.add(1, 2, 3)
+          line.points.add(2, 3, 4)
+          assert.deepEqual(Array.from(line.points.toFloat64Array()), [ 1, 2, 3, 2, 3, 4 ])
+          assert.deepEqual(Array.from(line.points.toFloat64Array({ dims: 2 })), [ 1, 2, 2, 3 ])
+          assert.deepEqual(Array.from(line.points.toFloat64Array({ dims: 4 })), [ 1, 2, 3, 0, 2, 3, 4, 0 ])
+        })
+        it('should throw on invalid dims', () => {
+          assert.throws(() => {
+            new gdal.LineString().points.toFloat64Array({ dims: 5 })
+          }, /dims must be 2, 3 or 4/)
+        })
+      })
+      describe('setFromFloat64Array()', () => {
+        it('should replace the points', () => {
+          const line = new gdal.LineString()
+          line.points.add(9, 9)
+          line.points.setFromFloat64Array(Float64Array.from([ 0, 0, 1, 10, 0, 2, 10, 10, 3 ]), { dims: 3 })
+          assert.equal(line.points.count(), 3)
+          assert.equal(line.points.get(1).x, 10)
+          assert.equal(line.points.get(2).z, 3)
+          assert.deepEqual(Array.from(line.points.toFloat64Array()), [ 0, 0, 1, 10, 0, 2, 10, 10, 3 ])
+        })
+        it('should drop the M values unless dims is 4', () => {
+          const line = gdal.Geometry.fromWKT('LINESTRING ZM (0 0 0 1, 1 1 1 2)') as gdal.LineString
+          line.points.setFromFloat64Array(Float64Array.from([ 0, 0, 1, 10, 0, 2 ]), { dims: 3 })
+          assert.equal(line.wkbType, gdal.wkbLineString25D)
+          assert.deepEqual(Array.from(line.points.toFloat64Array()), [ 0, 0, 1, 10, 0, 2 ])
+          line.points.setFromFloat64Array(Float64Array.from([ 0, 0, 10, 0 ]), { dims: 2 })
+          assert.equal(line.wkbType, gdal.wkbLineString)
+          line.points.setFromFloat64Array(Float64Array.from([ 0, 0, 1, 5, 10, 0, 2, 6 ]), { dims: 4 })
+          assert.deepEqual(Array.from(line.points.toFloat64Array()), [ 0, 0, 1, 5, 10, 0, 2, 6 ])
+        })
+        it('should throw on a truncated array', () => {
+          assert.throws(() => {
+            new gdal.LineString().points.setFromFloat64Array(new Float64Array(5), { dims: 2 })
+          }, /multiple of dims/)
+        })
+      })
     })
   })
 })
@@ -77,6 +77,13 @@ describe('gdal', () => {
       it('should have "getAsync()" method', () =>
         assert.eventually.instanceOf(ds.root.arrays.getAsync('time'), gdal.MDArray)
       )
+      it('should be labelled with its class in gdal.metrics()', () => {
+        gdal.metrics(true)
+        return ds.root.arrays.countAsync().then(() => {
+          assert.equal(gdal.metrics().methods['GroupArrays.count'].calls, 1)
+          assert.isUndefined(gdal.metrics().methods['unknown'])
+        })
+      })
 
       it('@@iterator()', () => {
         let called = 0
@@ -202,6 +202,21 @@ describe('gdal.Polygon', () => {
           assert.equal(array[0].points.get(3).y, 11)
         })
       })
+      describe('toFloat64Array()', () => {
+        it('should return the coordinates and the offsets of the rings', () => {
+          const polygon = new gdal.Polygon()
+          const exterior = new gdal.LinearRing()
+          exterior.points.add([ { x: 0, y: 0 }, { x: 10, y: 0 }, { x: 10, y: 10 }, { x: 0, y: 0 } ])
+          const interior = new gdal.LinearRing()
+          interior.points.add([ { x: 1, y: 1 }, { x: 2, y: 1 }, { x: 2, y: 2 }, { x: 1, y: 2 }, { x: 1, y: 1 } ])
+          polygon.rings.add([ exterior, interior ])
+          const { coordinates, offsets } = polygon.rings.toFloat64Array()
+          assert.instanceOf(coordinates, Float64Array)
+          assert.deepEqual(Array.from(offsets), [ 0, 4, 9 ])
+          assert.lengthOf(coordinates, 9 * 2)
+          assert.deepEqual(Array.from(coordinates.subarray(offsets[1] * 2, offsets[1] * 2 + 4)), [ 1, 1, 2, 1 ])
+        })
+      })
     })
     describe('getArea()', () => {
       it('should return area', () => {
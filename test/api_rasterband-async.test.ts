@@ -527,6 +527,52 @@ describe('gdal.RasterBandAsync', () => {
           }))
         })
       })
+      describe('readvAsync()', () => {
+        it('should read several windows in one operation', () => {
+          const band = gdal.open(`${__dirname}/data/sample.tif`).bands.get(1)
+          const windows = [
+            { x: 190, y: 290, width: 20, height: 30 },
+            { x: 0, y: 0, width: 16, height: 16 },
+            { x: 500, y: 10, width: 8, height: 4, type: gdal.GDT_Float32 }
+          ]
+          return assert.isFulfilled(band.pixels.readvAsync(windows).then((arrays) => {
+            assert.lengthOf(arrays, 3)
+            windows.forEach((w, i) => {
+              assert.deepEqual(arrays[i], band.pixels.read(w.x, w.y, w.width, w.height, undefined, { type: w.type }))
+            })
+            assert.instanceOf(arrays[2], Float32Array)
+            assert.equal(arrays[0][10 * 20 + 10], 10)
+          }))
+        })
+        it('should use the given arrays', () => {
+          const band = gdal.open(`${__dirname}/data/sample.tif`).bands.get(1)
+          const data = new Uint8Array(20 * 30)
+          return assert.isFulfilled(band.pixels.readvAsync([ { x: 190, y: 290, width: 20, height: 30, data } ])
+            .then((arrays) => {
+              assert.strictEqual(arrays[0], data)
+              assert.equal(data[10 * 20 + 10], 10)
+            }))
+        })
+        it('should reject if a window is out of bounds', () => {
+          const band = gdal.open(`${__dirname}/data/sample.tif`).bands.get(1)
+          return assert.isRejected(band.pixels.readvAsync([
+            { x: 0, y: 0, width: 16, height: 16 },
+            { x: 0, y: 0, width: 100000, height: 16 }
+          ]))
+        })
+        it('should throw on an invalid window', () => {
+          const band = gdal.open(`${__dirname}/data/sample.tif`).bands.get(1)
+          assert.throws(() => {
+            band.pixels.readv([ { x: 0, y: 0, width: 16 } as gdal.ReadWindow ])
+          }, /height/)
+        })
+        it('should throw on an invalid data type', () => {
+          const band = gdal.open(`${__dirname}/data/sample.tif`).bands.get(1)
+          assert.throws(() => {
+            band.pixels.readv([ { x: 0, y: 0, width: 16, height: 16, type: 'Float42' } ])
+          }, /Invalid data type/)
+        })
+      })
     })
     describe('flushAsync()', () => {
       it('should flush the written data', () => {
@@ -768,6 +814,30 @@ describe('gdal.RasterBandAsync', () => {
           return assert.isRejected(band.computeStatisticsAsync(false))
         })
       })
+      describe('computeSummaryAsync()', () => {
+        it('should compute statistics, histogram and percentiles', () => {
+          const band = statsBand()
+          return assert.isFulfilled(band.computeSummaryAsync().then((summary) => {
+            assert.equal(summary.count, 256)
+            assert.equal(summary.min, 0)
+            assert.equal(summary.max, 20)
+            assert.equal(summary.histogram.bins[5], 254)
+            assert.deepEqual(Array.from(summary.percentiles), [ 5, 5, 5 ])
+          }))
+        })
+        it('should run in parallel on different Datasets', () => {
+          const bands = Array.from({ length: 8 }, () => statsBand())
+          return assert.isFulfilled(Promise.all(bands.map((band) => band.computeSummaryAsync())).then((results) => {
+            for (const summary of results) assert.equal(summary.count, 256)
+          }))
+        })
+        it('should reject if dataset already closed', () => {
+          const ds = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte)
+          const band = ds.bands.get(1)
+          ds.close()
+          return assert.isRejected(band.computeSummaryAsync())
+        })
+      })
     })
     describe('getMetadataAsync()', () => {
       it('should return object', () => {
@@ -839,4 +909,37 @@ describe('gdal.RasterBandAsync', () => {
       })
     })
   })
+  if (typeof AbortController !== 'undefined') {
+    describe('AbortSignal', () => {
+      it('should reject an operation with an already aborted signal', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`)
+        const ac = new AbortController()
+        ac.abort()
+        return ds.bands.get(1).pixels.readAsync(0, 0, 16, 16, undefined, { signal: ac.signal }).then(() => {
+          assert.fail('should have been rejected')
+        }, (e) => {
+          assert.match(e.message, /aborted/)
+          assert.equal(e.code, gdal.CPLE_UserInterrupt)
+        })
+      })
+      it('should cancel the waiting operations', () => {
+        const ds = gdal.open(`${__dirname}/data/sample.tif`)
+        const band = ds.bands.get(1)
+        const size = ds.rasterSize
+        const ac = new AbortController()
+        const first = band.pixels.readAsync(0, 0, size.x, size.y)
+        const ops: Promise<unknown>[] = []
+        for (let i = 0; i < 32; i++) {
+          ops.push(band.pixels.readAsync(0, 0, size.x, size.y, undefined, { signal: ac.signal })
+            .then(() => undefined, (e) => e.code))
+        }
+        ac.abort()
+        return Promise.all([ first, ...ops ]).then(([ data, ...codes ]) => {
+          assert.instanceOf(data, Uint8Array)
+          // They are all still waiting for the first one when the signal is aborted
+          for (const c of codes) assert.equal(c, gdal.CPLE_UserInterrupt)
+        })
+      })
+    })
+  }
 })
@@ -1590,6 +1590,64 @@ describe('gdal.RasterBand', () => {
           })
         })
       })
+      describe('computeSummary()', () => {
+        it('should compute statistics, histogram and percentiles in one call', () => {
+          const band = statsBand()
+          const summary = band.computeSummary({ percentiles: [ 0, 50, 100 ], threads: 3 })
+          const stats = band.computeStatistics(false)
+          assert.equal(summary.count, 256)
+          assert.equal(summary.nodata_count, 0)
+          assert.equal(summary.min, stats.min)
+          assert.equal(summary.max, stats.max)
+          assert.closeTo(summary.mean, stats.mean, 1e-9)
+          assert.closeTo(summary.std_dev, stats.std_dev, 1e-9)
+          assert.instanceOf(summary.histogram.bins, Float64Array)
+          assert.lengthOf(summary.histogram.bins, 256)
+          assert.equal(summary.histogram.bins[0], 1)
+          assert.equal(summary.histogram.bins[5], 254)
+          assert.equal(summary.histogram.bins[20], 1)
+          assert.deepEqual(Array.from(summary.percentiles), [ 0, 5, 20 ])
+        })
+        it('should exclude NoData and use the given histogram range', () => {
+          const band = statsBand()
+          band.noDataValue = 0
+          const summary = band.computeSummary({ bins: 4, min: 0, max: 20 })
+          assert.equal(summary.count, 255)
+          assert.equal(summary.nodata_count, 1)
+          assert.equal(summary.min, 5)
+          assert.deepEqual(Array.from(summary.histogram.bins), [ 0, 254, 0, 1 ])
+        })
+        it('should compute the histogram range of floating point data', () => {
+          const ds = gdal.open('temp', 'w', 'MEM', 64, 64, 1, gdal.GDT_Float32)
+          const band = ds.bands.get(1)
+          const data = new Float32Array(64 * 64).map((_, i) => i / 16)
+          band.pixels.write(0, 0, 64, 64, data)
+          let calls = 0
+          const summary = band.computeSummary({ bins: 16, progress_cb: () => calls++ })
+          assert.equal(summary.histogram.min, 0)
+          assert.equal(summary.histogram.max, 255.9375)
+          assert.isTrue(Array.from(summary.histogram.bins).every((v) => v === 256))
+          assert.closeTo(summary.percentiles[1], 128, 0.1)
+          assert.isAbove(calls, 0)
+        })
+        it('should throw on invalid options', () => {
+          const band = statsBand()
+          assert.throws(() => {
+            band.computeSummary({ min: 10 })
+          }, /max must be greater than min/)
+          assert.throws(() => {
+            band.computeSummary({ percentiles: [ 101 ] })
+          }, /between 0 and 100/)
+        })
+        it('should throw error if dataset already closed', () => {
+          const ds = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte)
+          const band = ds.bands.get(1)
+          ds.close()
+          assert.throws(() => {
+            band.computeSummary()
+          })
+        })
+      })
       describe('setStatistics()', () => {
         it('should allow to manually set (false) statistics', () => {
           const band = statsBand()
@@ -0,0 +1,134 @@
+import * as gdal from 'gdal-async'
+import * as chai from 'chai'
+const assert = chai.assert
+import * as chaiAsPromised from 'chai-as-promised'
+chai.use(chaiAsPromised)
+
+describe('gdal.SpatialIndex', () => {
+  // eslint-disable-next-line @typescript-eslint/no-non-null-assertion
+  afterEach(global.gc!)
+
+  // A 10x10 grid of 1x1 squares, the square at (x, y) has the index 10 * y + x
+  const squares: gdal.Geometry[] = []
+  for (let y = 0; y < 10; y++) {
+    for (let x = 0; x < 10; x++) {
+      squares.push(gdal.Geometry.fromWKT(
+        `POLYGON ((${x} ${y}, ${x + 1} ${y}, ${x + 1} ${y + 1}, ${x} ${y + 1}, ${x} ${y}))`))
+    }
+  }
+  const sorted = (a: Float64Array) => Array.from(a).sort((a, b) => a - b)
+
+  it('should be exposed', () => {
+    assert.ok(gdal.SpatialIndex)
+  })
+
+  it('should not be constructed directly', () => {
+    assert.throws(() => new gdal.SpatialIndex())
+  })
+
+  describe('fromGeometries()', () => {
+    it('should index geometries and WKB buffers', () => {
+      const index = gdal.SpatialIndex.fromGeometries(squares.map((g, i) => i % 2 ? g.toWKB() : g))
+      assert.instanceOf(index, gdal.SpatialIndex)
+      assert.equal(index.count, 100)
+    })
+    it('should skip null and empty geometries', () => {
+      const index = gdal.SpatialIndex.fromGeometries([ null, new gdal.Polygon(), squares[5] ])
+      assert.equal(index.count, 1)
+      assert.deepEqual(sorted(index.search({ minX: 0, minY: 0, maxX: 100, maxY: 100 })), [ 2 ])
+    })
+    it('should throw on invalid geometries', () => {
+      assert.throws(() => {
+        gdal.SpatialIndex.fromGeometries([ {} ] as gdal.Geometry[])
+      }, /must be an array of Geometry objects or WKB Buffers/)
+      assert.throws(() => {
+        gdal.SpatialIndex.fromGeometries(squares, { nodeSize: 1 })
+      }, /nodeSize/)
+    })
+  })
+
+  describe('search()', () => {
+    const index = gdal.SpatialIndex.fromGeometries(squares, { nodeSize: 4 })
+    it('should find the items intersecting an envelope', () => {
+      const result = index.search({ minX: 2.5, minY: 3.5, maxX: 3.5, maxY: 3.6 })
+      assert.instanceOf(result, Float64Array)
+      assert.deepEqual(sorted(result), [ 32, 33 ])
+    })
+    it('should find the items intersecting the envelope of a geometry', () => {
+      assert.deepEqual(sorted(index.search(gdal.Geometry.fromWKT('POINT (0.5 9.5)'))), [ 90 ])
+    })
+    it('should return an empty array when nothing intersects', () => {
+      assert.lengthOf(index.search({ minX: 20, minY: 20, maxX: 30, maxY: 30 }), 0)
+    })
+    it('should run concurrently in async mode', () =>
+      Promise.all(squares.map((g) => index.searchAsync(g))).then((results) => {
+        results.forEach((r, i) => assert.include(Array.from(r), i))
+      })
+    )
+  })
+
+  describe('nearest()', () => {
+    const index = gdal.SpatialIndex.fromGeometries(squares)
+    it('should find the nearest items', () => {
+      const result = index.nearest({ x: 12, y: 0.5 }, 2)
+      assert.deepEqual(Array.from(result.ids), [ 9, 19 ])
+      assert.closeTo(result.distances[0], 2, 1e-9)
+      assert.closeTo(result.distances[1], Math.sqrt(4.25), 1e-9)
+    })
+    it('should accept a Point', () => {
+      assert.deepEqual(Array.from(index.nearest(new gdal.Point(-1, 5.5)).ids), [ 50 ])
+    })
+    it('nearestAsync', () =>
+      assert.eventually.deepEqual(index.nearestAsync({ x: 5.5, y: 20 }, 1).then((r) => Array.from(r.ids)), [ 95 ])
+    )
+  })
+
+  describe('join()', () => {
+    it('should find the intersecting pairs of two indexes', () => {
+      const grid = gdal.SpatialIndex.fromGeometries(squares)
+      const points = gdal.SpatialIndex.fromGeometries([ new gdal.Point(0.5, 0.5), new gdal.Point(4.5, 7.5) ])
+      const result = grid.join(points)
+      const pairs = Array.from(result.left).map((l, i) => [ l, result.right[i] ]).sort((a, b) => a[0] - b[0])
+      assert.deepEqual(pairs, [ [ 0, 0 ], [ 74, 1 ] ])
+    })
+    it('joinAsync', () => {
+      const grid = gdal.SpatialIndex.fromGeometries(squares)
+      return grid.joinAsync(grid).then((result) => {
+        // every square touches itself and its neighbours, including the diagonal ones
+        assert.equal(result.left.length, 100 + 2 * (2 * 9 * 10 + 2 * 9 * 9))
+      })
+    })
+  })
+
+  describe('fromLayerAsync()', () => {
+    it('should index the features of a layer by FID', async () => {
+      const ds = gdal.open('spatial_index', 'w', 'Memory')
+      const layer = ds.layers.create('squares', null, gdal.Polygon)
+      for (const square of squares) {
+        const feature = new gdal.Feature(layer)
+        feature.setGeometry(square)
+        layer.features.add(feature)
+      }
+      const index = await gdal.SpatialIndex.fromLayerAsync(layer)
+      assert.equal(index.count, 100)
+      const fids = index.search({ minX: 0.2, minY: 0.2, maxX: 0.8, maxY: 0.8 })
+      assert.lengthOf(fids, 1)
+      assert.equal(layer.features.get(fids[0]).getGeometry().toWKT(), squares[0].toWKT())
+      ds.close()
+    })
+    it('should reset the reading position of the layer', () => {
+      const ds = gdal.open('spatial_index', 'w', 'Memory')
+      const layer = ds.layers.create('squares', null, gdal.Polygon)
+      for (const square of squares.slice(0, 3)) {
+        const feature = new gdal.Feature(layer)
+        feature.setGeometry(square)
+        layer.features.add(feature)
+      }
+      const first = layer.features.next().fid
+      layer.features.next()
+      gdal.SpatialIndex.fromLayer(layer)
+      assert.equal(layer.features.next().fid, first)
+      ds.close()
+    })
+  })
+})
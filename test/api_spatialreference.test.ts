@@ -435,4 +435,45 @@ describe('gdal.SpatialReference', () => {
         .isSame(gdal.SpatialReference.fromCRSURL('http://www.opengis.net/def/crs/EPSG/0/3857')), false)
     })
   })
+  describe('cache', () => {
+    afterEach(() => {
+      gdal.projCacheSize = 64
+    })
+    it('should return independent copies of the cached spatial references', () => {
+      gdal.metrics(true)
+      const ref1 = gdal.SpatialReference.fromEPSG(32633)
+      const ref2 = gdal.SpatialReference.fromEPSG(32633)
+      assert.notStrictEqual(ref1, ref2)
+      assert.isTrue(ref1.isSame(ref2))
+      ref1.morphToESRI()
+      const ref3 = gdal.SpatialReference.fromEPSG(32633)
+      assert.isTrue(ref3.isSame(ref2))
+      assert.notEqual(ref3.toWKT(), ref1.toWKT())
+      assert.isAtLeast(gdal.metrics().projCache.srs.hits, 2)
+    })
+    it('should share the transformations with Geometry.transformTo()', () => {
+      const wgs84 = gdal.SpatialReference.fromEPSG(4326)
+      const utm = gdal.SpatialReference.fromEPSG(32633)
+      gdal.metrics(true)
+      const ct = new gdal.CoordinateTransformation(wgs84, utm)
+      const expected = ct.transformPoint(15, 45)
+      const pt = new gdal.Point(15, 45)
+      pt.srs = wgs84
+      pt.transformTo(utm)
+      assert.closeTo(pt.x, expected.x, 1e-6)
+      assert.closeTo(pt.y, expected.y, 1e-6)
+      const stats = gdal.metrics().projCache.transformations
+      assert.equal(stats.hits + stats.misses, 2)
+      assert.isAtLeast(stats.hits, 1)
+    })
+    it('should be disabled by projCacheSize = 0', () => {
+      gdal.projCacheSize = 0
+      assert.equal(gdal.projCacheSize, 0)
+      gdal.metrics(true)
+      gdal.SpatialReference.fromEPSG(32633)
+      gdal.SpatialReference.fromEPSG(32633)
+      const stats = gdal.metrics().projCache.srs
+      assert.deepEqual(stats, { hits: 0, misses: 2, size: 0 })
+    })
+  })
 })
@@ -32,14 +32,14 @@ describe('gdal.RasterReadStream', () => {
     })
   }
 
-  function readTest(done: doneCb, file: string, blockOptimize: boolean) {
+  function readTest(done: doneCb, file: string, blockOptimize: boolean, prefetch?: number) {
     const ds = gdal.open(path.resolve(__dirname, 'data', file))
     const band = ds.bands.get(1)
     const expected = band.pixels.read(0, 0, band.size.x, band.size.y)
     const type = gdal.fromDataType(band.dataType)
     const actual = new type(band.size.x * band.size.y)
 
-    const rs = band.pixels.createReadStream({ blockOptimize })
+    const rs = band.pixels.createReadStream({ blockOptimize, prefetch })
     assert.instanceOf(rs, gdal.RasterReadStream)
     let length = 0
     rs.on('data', (chunk) => {
@@ -84,6 +84,30 @@ describe('gdal.RasterReadStream', () => {
   for (const file of inputFiles) {
     it(`should accept various formats (${file})`, (done) => readTest(done, file, true))
   }
+
+  describe('w/tiled raster', () => {
+    const tiled = `/vsimem/rs_tiled_test.${String(Math.random()).substring(2)}.tmp.tiff`
+    before(() => {
+      const ds = gdal.open(tiled, 'w', 'GTiff', 300, 200, 1, gdal.GDT_Int16,
+        { TILED: 'YES', BLOCKXSIZE: 64, BLOCKYSIZE: 64 })
+      const data = new Int16Array(300 * 200).map((_, i) => i % 32000)
+      ds.bands.get(1).pixels.write(0, 0, 300, 200, data)
+      ds.close()
+    })
+    after(() => gdal.vsimem.release(tiled))
+
+    it('should read by rows of blocks', (done) => readTest(done, tiled, true))
+    it('should read by rows of blocks w/prefetch', (done) => readTest(done, tiled, true, 8))
+    it('should read line by line w/o blockOptimize', (done) => readTest(done, tiled, false, 1))
+  })
+
+  it('should support prefetching', (done) => readTest(done, 'sample.tif', true, 4))
+  it('should reject an invalid prefetch', () => {
+    const band = gdal.open(path.resolve(__dirname, 'data', 'sample.tif')).bands.get(1)
+    assert.throws(() => {
+      band.pixels.createReadStream({ prefetch: 0 })
+    }, /prefetch/)
+  })
 })
 
 describe('gdal.RasterWriteStream', () => {
@@ -284,8 +308,85 @@ describe('gdal.RasterReadStream + gdal.RasterWriteStream', () => {
   })
 })
 
+describe('tiles mode', () => {
+  const tiledFile = (w: number, h: number, fill: (i: number) => number) => {
+    const filename = `/vsimem/ds_tiles_test.${String(Math.random()).substring(2)}.tmp.tiff`
+    const ds = gdal.open(filename, 'w', 'GTiff', w, h, 1, gdal.GDT_Float64,
+      { TILED: 'YES', BLOCKXSIZE: 64, BLOCKYSIZE: 32 })
+    ds.bands.get(1).pixels.write(0, 0, w, h, new Float64Array(w * h).map((_, i) => fill(i)))
+    return { filename, ds }
+  }
+
+  it('should stream the blocks of a raster', () => {
+    const { filename, ds } = tiledFile(200, 100, (i) => i)
+    const band = ds.bands.get(1)
+    const rs = band.pixels.createReadStream({ mode: 'tiles', prefetch: 4 })
+    const tiles: gdal.RasterTile[] = []
+    rs.on('data', (tile) => tiles.push(tile))
+    return assert.isFulfilled(finished(rs).then(() => {
+      // 4 x 4 blocks, the edge blocks are clamped
+      assert.lengthOf(tiles, 16)
+      assert.deepInclude(tiles.map((t) => [ t.x, t.y, t.w, t.h ]), [ 192, 96, 8, 4 ])
+      for (const t of tiles) {
+        assert.lengthOf(t.data, t.w * t.h)
+        assert.deepEqual(t.data, band.pixels.read(t.x, t.y, t.w, t.h))
+      }
+      ds.close()
+      gdal.vsimem.release(filename)
+    }))
+  })
+
+  it('should support piping tiles', () => {
+    const input = tiledFile(200, 100, (i) => i)
+    const output = tiledFile(200, 100, () => 0)
+    const rs = input.ds.bands.get(1).pixels.createReadStream({ mode: 'tiles' })
+    const ws = output.ds.bands.get(1).pixels.createWriteStream({ mode: 'tiles' })
+    rs.pipe(ws)
+    return assert.isFulfilled(finished(ws).then(() => {
+      assert.deepEqual(output.ds.bands.get(1).pixels.read(0, 0, 200, 100),
+        input.ds.bands.get(1).pixels.read(0, 0, 200, 100))
+      input.ds.close()
+      output.ds.close()
+      gdal.vsimem.release(input.filename)
+      gdal.vsimem.release(output.filename)
+    }))
+  })
+
+  it('should support RasterMuxStream and RasterTransform', () => {
+    const a = tiledFile(200, 100, (i) => i)
+    const b = tiledFile(200, 100, (i) => 2 * i)
+    const output = tiledFile(200, 100, () => 0)
+    const mux = new gdal.RasterMuxStream({
+      A: a.ds.bands.get(1).pixels.createReadStream({ mode: 'tiles' }),
+      B: b.ds.bands.get(1).pixels.createReadStream({ mode: 'tiles' })
+    })
+    const sum = new gdal.RasterTransform({ type: Float64Array, fn: (a: number, b: number) => a + b })
+    const ws = output.ds.bands.get(1).pixels.createWriteStream({ mode: 'tiles' })
+    mux.pipe(sum).pipe(ws)
+    return assert.isFulfilled(finished(ws).then(() => {
+      const result = output.ds.bands.get(1).pixels.read(0, 0, 200, 100)
+      for (let i = 0; i < result.length; i += 97) assert.equal(result[i], 3 * i)
+      for (const f of [ a, b, output ]) {
+        f.ds.close()
+        gdal.vsimem.release(f.filename)
+      }
+    }))
+  })
+
+  it('should reject invalid tiles', () => {
+    const output = tiledFile(200, 100, () => 0)
+    const ws = output.ds.bands.get(1).pixels.createWriteStream({ mode: 'tiles' })
+    const q = finished(ws)
+    ws.write({ x: 190, y: 0, w: 64, h: 32, data: new Float64Array(64 * 32) })
+    return assert.isRejected(q, /outside the raster/).then(() => {
+      output.ds.close()
+      gdal.vsimem.release(output.filename)
+    })
+  })
+})
+
 describe('gdal.RasterMuxStream', () => {
-  function testMux(blockOptimize?: boolean) {
+  function testMux(blockOptimize?: boolean, pool?: gdal.RasterBufferPool) {
     const dsT2m = gdal.open(path.resolve(__dirname, 'data', 'AROME_T2m_10.tiff'))
     const dsD2m = gdal.open(path.resolve(__dirname, 'data', 'AROME_D2m_10.tiff'))
 
@@ -295,17 +396,17 @@ describe('gdal.RasterMuxStream', () => {
     const dsCloudBase = gdal.open(filename, 'w', 'GTiff', dsT2m.rasterSize.x, dsD2m.rasterSize.y, 1, gdal.GDT_Float64)
 
     const mux = new gdal.RasterMuxStream({
-      T2m: dsT2m.bands.get(1).pixels.createReadStream(),
-      D2m: dsD2m.bands.get(1).pixels.createReadStream()
-    }, { blockOptimize })
+      T2m: dsT2m.bands.get(1).pixels.createReadStream({ pool }),
+      D2m: dsD2m.bands.get(1).pixels.createReadStream({ pool })
+    }, { blockOptimize, pool })
 
-    const ws = dsCloudBase.bands.get(1).pixels.createWriteStream()
+    const ws = dsCloudBase.bands.get(1).pixels.createWriteStream({ pool })
 
     // Espy's estimation for cloud base height (lifted condensation level)
     // LCL = 125 * (T2m - Td2m)
     // where T2m is the temperature at 2m and Td2m is the dew point at 2m
     const fn = (t: number, td: number) => 125 * (t - td)
-    const espyEstimation = new gdal.RasterTransform({ type: Float64Array, fn })
+    const espyEstimation = new gdal.RasterTransform({ type: Float64Array, fn, pool })
 
     mux.pipe(espyEstimation).pipe(ws)
     return assert.isFulfilled(finished(ws).then(() => {
@@ -328,4 +429,54 @@ describe('gdal.RasterMuxStream', () => {
 
   it('should accept multiple inputs', () => testMux(undefined))
   it('should support different block sizes', () => testMux(false))
+  it('should support a buffer pool', () => {
+    const pool = new gdal.RasterBufferPool()
+    return testMux(undefined, pool).then(() => {
+      assert.isAbove(pool.reused, 0)
+    })
+  })
+  it('should support a buffer pool w/ different block sizes', () => {
+    const pool = new gdal.RasterBufferPool()
+    return testMux(false, pool).then(() => {
+      assert.isAbove(pool.reused, 0)
+    })
+  })
+})
+
+describe('gdal.RasterBufferPool', () => {
+  it('should reuse the released buffers', () => {
+    const pool = new gdal.RasterBufferPool()
+    const a = pool.acquire(Float64Array, 16)
+    assert.instanceOf(a, Float64Array)
+    assert.equal(a.length, 16)
+    pool.release(a)
+    const b = pool.acquire(Uint8Array, 128)
+    assert.strictEqual(b.buffer, a.buffer)
+    assert.equal(pool.allocated, 1)
+    assert.equal(pool.reused, 1)
+  })
+  it('should ignore foreign and already released buffers', () => {
+    const pool = new gdal.RasterBufferPool()
+    pool.release(new Float32Array(8))
+    const a = pool.acquire(Float32Array, 8)
+    pool.release(a)
+    pool.release(a.subarray(4))
+    const b = pool.acquire(Float32Array, 8)
+    const c = pool.acquire(Float32Array, 8)
+    assert.notStrictEqual(b.buffer, c.buffer)
+    assert.equal(pool.allocated, 2)
+  })
+  it('should keep at most maxFree buffers', () => {
+    const pool = new gdal.RasterBufferPool({ maxFree: 1 })
+    const a = pool.acquire(Int16Array, 4)
+    const b = pool.acquire(Int16Array, 4)
+    pool.release(a)
+    pool.release(b)
+    pool.acquire(Int16Array, 4)
+    pool.acquire(Int16Array, 4)
+    assert.equal(pool.allocated, 3)
+  })
+  it('should reject an invalid maxFree', () => {
+    assert.throws(() => new gdal.RasterBufferPool({ maxFree: -1 }), /maxFree/)
+  })
 })
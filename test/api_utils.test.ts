@@ -93,6 +93,17 @@ describe('gdal_utils', () => {
       const tmpFile = `/vsimem/${String(Math.random()).substring(2)}.tif`
       return assert.isRejected(gdal.translateAsync(tmpFile, ds, [ '-of', 'nosuchformat' ]), /not recognised/)
     })
+    it('should not be affected by an AbortSignal that is not aborted', function () {
+      if (typeof AbortController === 'undefined') this.skip()
+      const ds = gdal.open(path.resolve(__dirname, 'data', 'multiband.tif'))
+      const tmpFile = `/vsimem/${String(Math.random()).substring(2)}.tif`
+      const ac = new AbortController()
+      return assert.isFulfilled(gdal.translateAsync(tmpFile, ds, [ '-b', '1' ], { signal: ac.signal })
+        .then((out) => {
+          out.close()
+          gdal.vsimem.release(tmpFile)
+        }))
+    })
   })
 
   describe('vectorTranslate', () => {
@@ -813,5 +824,91 @@ describe('gdal_utils', () => {
       output.close()
       gdal.vsimem.release(tempFile)
     })
+
+    it('should be aborted by an AbortSignal', function () {
+      if (typeof AbortController === 'undefined') this.skip()
+      const ds = gdal.open(path.resolve(__dirname, 'data', 'AROME_T2m_10.tiff'))
+      const out = gdal.open('temp', 'w', 'MEM', ds.rasterSize.x, ds.rasterSize.y, 1, gdal.GDT_Float64)
+      const ac = new AbortController()
+      return assert.isRejected(gdal.calcAsync({ t: ds.bands.get(1) }, out.bands.get(1), (t: number) => {
+        ac.abort()
+        return t
+      }, { signal: ac.signal }), /aborted/)
+    })
+
+    describe('w/expression', () => {
+      it('should perform the given calculation', async () => {
+        const tempFile = `/vsimem/cloudbase_expr_${String(Math.random()).substring(2)}.tiff`
+        const T2m = await gdal.openAsync(path.resolve(__dirname, 'data','AROME_T2m_10.tiff'))
+        const D2m = await gdal.openAsync(path.resolve(__dirname, 'data','AROME_D2m_10.tiff'))
+        const size = await T2m.rasterSizeAsync
+        const cloudBase = await gdal.openAsync(tempFile,
+          'w', 'GTiff', size.x, size.y, 1, gdal.GDT_Float64)
+
+        let done = 0
+        await gdal.calcAsync({
+          t: await T2m.bands.getAsync(1),
+          td: await D2m.bands.getAsync(1)
+        }, await cloudBase.bands.getAsync(1), 't > td ? 125 * (t - td) : -sqrt(abs(t - td)) ** 2', {
+          progress_cb: (complete) => {
+            assert.isAbove(complete, done)
+            done = complete
+          }
+        })
+        assert.closeTo(done, 1, 1e-6)
+
+        const t2mData = await (await T2m.bands.getAsync(1)).pixels.readAsync(0, 0, size.x, size.y)
+        const d2mData = await (await D2m.bands.getAsync(1)).pixels.readAsync(0, 0, size.x, size.y)
+        const cbData = await (await cloudBase.bands.getAsync(1)).pixels.readAsync(0, 0, size.x, size.y)
+
+        for (let i = 0; i < cbData.length; i+=1000) {
+          const t = t2mData[i], td = d2mData[i]
+          assert.closeTo(cbData[i], t > td ? 125 * (t - td) : -(Math.sqrt(Math.abs(t - td)) ** 2), 1e-6)
+        }
+        cloudBase.close()
+        gdal.vsimem.release(tempFile)
+      })
+
+      it('should support converting NoData values', async () => {
+        const tempFile = `/vsimem/calc_nodata_expr_${String(Math.random()).substring(2)}.tiff`
+        const dem = await gdal.openAsync(path.resolve(__dirname, 'data', 'dem_azimuth50_pa.img'))
+        const size = await dem.rasterSizeAsync
+        const output = await gdal.openAsync(tempFile,
+          'w', 'GTiff', size.x, size.y, 1, gdal.GDT_Float64);
+
+        (await output.bands.getAsync(1)).noDataValue = -100
+
+        await gdal.calcAsync({
+          dem: await dem.bands.getAsync(1)
+        }, await output.bands.getAsync(1), 'dem + 1', { convertNoData: true })
+
+        assert.equal(output.bands.get(1).pixels.get(0, 0), -100)
+        output.close()
+        gdal.vsimem.release(tempFile)
+      })
+
+      it('should reject an invalid expression', () => {
+        const T2m = gdal.open(path.resolve(__dirname, 'data','AROME_T2m_10.tiff'))
+        const size = T2m.rasterSize
+        const output = gdal.open('temp', 'w', 'MEM', size.x, size.y, 1, gdal.GDT_Float64).bands.get(1)
+        return Promise.all([
+          assert.isRejected(gdal.calcAsync({ t: T2m.bands.get(1) }, output, 't +'), /Invalid expression/),
+          assert.isRejected(gdal.calcAsync({ t: T2m.bands.get(1) }, output, 't + td'), /unknown variable td/),
+          assert.isRejected(gdal.calcAsync({ t: T2m.bands.get(1) }, output, 'foo(t)'), /unknown function foo/)
+        ])
+      })
+
+      it('should reject when raster sizes do not match', () => {
+        return assert.isRejected(
+          gdal.calcAsync({
+            A: gdal.open(path.resolve(__dirname, 'data','AROME_T2m_10.tiff')).bands.get(1),
+            B: gdal.open(path.resolve(__dirname, 'data','sample.tif')).bands.get(1)
+          },
+          gdal.open('temp', 'w', 'MEM', 128, 128, 1, gdal.GDT_Float64).bands.get(1),
+          'A + B'),
+          /dimensions must match/
+        )
+      })
+    })
   })
 })
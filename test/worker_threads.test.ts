@@ -0,0 +1,132 @@
+import * as chai from 'chai'
+const assert = chai.assert
+import * as gdal from 'gdal-async'
+import * as path from 'path'
+import * as fs from 'fs'
+import * as semver from 'semver'
+import { Worker } from 'worker_threads'
+
+const gdalJS = fs.existsSync('./lib/gdal.js') ? path.resolve('./lib/gdal.js') : 'gdal-async'
+
+const runWorker = <T>(code: string, workerData: unknown): Promise<T> => new Promise((resolve, reject) => {
+  const worker = new Worker(`
+    const { parentPort, workerData } = require('worker_threads');
+    const gdal = require(${JSON.stringify(gdalJS)});
+    (async () => { ${code} })().then((r) => parentPort.postMessage(r), (e) => { throw e });
+  `, { eval: true, workerData })
+  let result: T
+  worker.on('message', (r) => {
+    result = r
+  })
+  worker.on('error', reject)
+  worker.on('exit', (code) => code === 0 ? resolve(result) : reject(new Error(`worker exited with ${code}`)))
+})
+
+describe('worker_threads', () => {
+  // eslint-disable-next-line @typescript-eslint/no-non-null-assertion
+  afterEach(global.gc!)
+
+  it('should load the module in several worker threads', () => {
+    const file = path.resolve(__dirname, 'data', 'sample.tif')
+    const expected = gdal.checksumImage(gdal.open(file).bands.get(1))
+    const code = `
+      const ds = gdal.open(workerData.file);
+      const band = ds.bands.get(1);
+      const data = await band.pixels.readAsync(0, 0, 64, 64);
+      const checksum = await gdal.checksumImageAsync(band);
+      ds.close();
+      return { checksum, length: data.length };
+    `
+    return Promise.all([ runWorker(code, { file }), runWorker(code, { file }) ])
+      .then((results) => {
+        for (const r of results) assert.deepEqual(r, { checksum: expected, length: 64 * 64 })
+      })
+  })
+
+  it('should share the /vsimem/ files with the worker threads', () => {
+    const buffer = fs.readFileSync(path.resolve(__dirname, 'data', 'sample.tif'))
+    const file = `/vsimem/worker_${String(Math.random()).substring(2)}.tif`
+    gdal.vsimem.copy(buffer, file)
+    const code = `
+      const ds = gdal.open(workerData.file);
+      const x = ds.rasterSize.x;
+      ds.close();
+      return x;
+    `
+    return runWorker<number>(code, { file }).then((x) => {
+      const ds = gdal.open(file)
+      assert.equal(x, ds.rasterSize.x)
+      ds.close()
+      gdal.vsimem.release(file)
+    })
+  })
+
+  it('should keep the /vsimem/ files of a worker thread that has exited', () => {
+    const file = `/vsimem/worker_${String(Math.random()).substring(2)}.tif`
+    const code = `
+      const fs = require('fs');
+      gdal.vsimem.set(fs.readFileSync(workerData.sample), workerData.file);
+      return true;
+    `
+    return runWorker<boolean>(code, { file, sample: path.resolve(__dirname, 'data', 'sample.tif') }).then(() => {
+      global.gc!()
+      const ds = gdal.open(file)
+      assert.equal(ds.rasterSize.x, gdal.open(path.resolve(__dirname, 'data', 'sample.tif')).rasterSize.x)
+      ds.close()
+      assert.instanceOf(gdal.vsimem.release(file), Buffer)
+    })
+  })
+
+  it('should share the thread pool with the worker threads', () => {
+    const code = `
+      const ds = await gdal.openAsync(workerData.file);
+      await ds.bands.get(1).pixels.readAsync(0, 0, 16, 16);
+      ds.close();
+      return { io: gdal.ioThreads, cpu: gdal.cpuThreads };
+    `
+    return gdal.openAsync(path.resolve(__dirname, 'data', 'sample.tif'))
+      .then(() => runWorker<{ io: number, cpu: number }>(code, { file: path.resolve(__dirname, 'data', 'sample.tif') }))
+      .then((sizes) => {
+        assert.deepEqual(sizes, { io: gdal.ioThreads, cpu: gdal.cpuThreads })
+        // The pool has already been started by the main thread
+        assert.throws(() => {
+          (gdal as unknown as { cpuThreads: number }).cpuThreads = 1
+        }, /cannot be changed/)
+      })
+  })
+
+  it('should keep working after a worker has exited', () => {
+    return runWorker<string>('return gdal.version', {}).then((version) => {
+      assert.equal(version, gdal.version)
+      return gdal.openAsync(path.resolve(__dirname, 'data', 'sample.tif'))
+    }).then((ds) => ds.bands.get(1).pixels.readAsync(0, 0, 16, 16))
+      .then((data) => assert.instanceOf(data, Uint8Array))
+  })
+
+  it('should not hang when a worker is terminated with jobs in flight', function () {
+    if (!semver.gte(gdal.version, '3.5.0-git')) this.skip()
+    const file = path.resolve(__dirname, 'data', 'sample.tif')
+    const worker = new Worker(`
+      const { parentPort, workerData } = require('worker_threads');
+      const gdal = require(${JSON.stringify(gdalJS)});
+      const src = gdal.open(workerData.file).bands.get(1);
+      gdal.addPixelFunc(workerData.name, gdal.toPixelFunc((sources, buffer) => buffer.set(sources[0])));
+      const ds = gdal.open(gdal.wrapVRT({ bands: [ { sources: [ src ], pixelFunc: workerData.name } ] }));
+      const band = ds.bands.get(1);
+      // Blocked in the thread pool on the pixel function
+      band.pixels.readAsync(0, 0, ds.rasterSize.x, ds.rasterSize.y);
+      // Waiting in the scheduler for the Dataset
+      band.pixels.readAsync(0, 0, 16, 16);
+      // Completed while the event loop is blocked
+      src.pixels.readAsync(0, 0, 16, 16);
+      parentPort.postMessage('busy');
+      for (;;);
+    `, { eval: true, workerData: { file, name: `worker_${String(Math.random()).substring(2)}` } })
+    return new Promise<number>((resolve, reject) => {
+      worker.on('message', () => setTimeout(() => worker.terminate().then(resolve, reject), 200))
+      worker.on('error', reject)
+    }).then(() => gdal.openAsync(file))
+      .then((ds) => ds.bands.get(1).pixels.readAsync(0, 0, 16, 16))
+      .then((data) => assert.instanceOf(data, Uint8Array))
+  })
+})